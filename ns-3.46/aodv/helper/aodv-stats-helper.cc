@@ -0,0 +1,447 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "aodv-stats-helper.h"
+
+#include "ns3/boolean.h"
+#include "ns3/callback.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/log.h"
+#include "ns3/node-list.h"
+#include "ns3/nstime.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/wifi-psdu.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AodvStatsHelper");
+
+AodvStatsHelper::AodvStatsHelper()
+    : m_format(CSV)
+{
+}
+
+AodvStatsHelper::~AodvStatsHelper()
+{
+    m_snapshotEvent.Cancel();
+}
+
+bool
+AodvStatsHelper::Install(Ptr<Node> node)
+{
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    NS_ASSERT_MSG(ipv4, "Ipv4 not installed on node");
+    NS_ASSERT_MSG(ipv4->GetRoutingProtocol(), "Ipv4 routing not installed on node");
+    std::vector<Ptr<Ipv4RoutingProtocol>> candidates = GetRoutingProtocols(ipv4);
+
+    std::string context = std::to_string(node->GetId());
+    for (uint32_t i = 0; i < node->GetNDevices(); i++)
+    {
+        Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice>(node->GetDevice(i));
+        if (!device)
+        {
+            continue;
+        }
+        for (uint8_t link = 0; link < device->GetNPhys(); link++)
+        {
+            std::string phyContext =
+                context + "/" + std::to_string(i) + "/" + std::to_string(link);
+            m_phys[phyContext] = device->GetPhy(link);
+            device->GetPhy(link)->TraceConnect("PhyTxPsduBegin",
+                                               phyContext,
+                                               MakeCallback(&AodvStatsHelper::PhyTxBegin, this));
+        }
+    }
+    for (auto& candidate : candidates)
+    {
+        auto source = dynamic_cast<const AodvStatsSource*>(PeekPointer(candidate));
+        if (source)
+        {
+            // m_protocols keeps the protocol, and so the source, alive
+            m_stats[node->GetId()] = source;
+            candidate->TraceConnect("RouteDiscovery",
+                                    context,
+                                    MakeCallback(&AodvStatsHelper::DiscoveryDone, this));
+            candidate->TraceConnect("TrustVerdict",
+                                    context,
+                                    MakeCallback(&AodvStatsHelper::TrustVerdict, this));
+            candidate->TraceConnect("Footprint",
+                                    context,
+                                    MakeCallback(&AodvStatsHelper::FootprintSampled, this));
+            m_protocols.push_back(candidate);
+            return true;
+        }
+    }
+    NS_LOG_WARN("No routing protocol with control overhead counters on node " << node->GetId());
+    return false;
+}
+
+void
+AodvStatsHelper::Install(NodeContainer nodes)
+{
+    for (auto i = nodes.Begin(); i != nodes.End(); ++i)
+    {
+        Install(*i);
+    }
+}
+
+void
+AodvStatsHelper::EnableSnapshots(std::string filename, Time interval, Format format)
+{
+    NS_ASSERT_MSG(interval.IsStrictlyPositive(), "Snapshot interval must be positive");
+    m_format = format;
+    m_interval = interval;
+    m_stream = Create<OutputStreamWrapper>(
+        filename,
+        format == BINARY ? std::ios::out | std::ios::binary : std::ios::out);
+    if (m_format == CSV)
+    {
+        *m_stream->GetStream() << "time,node,rreqSent,rrepSent,rerrSent,brokenLinks,"
+                                  "rreqReceived,maliciousDrops,compactBytesSaved";
+        for (uint32_t i = 0; i < AODV_CONTROL_TYPES; ++i)
+        {
+            *m_stream->GetStream() << ","
+                                   << AodvControlTypeName(static_cast<AodvControlType>(i))
+                                   << "Bytes";
+        }
+        *m_stream->GetStream() << std::endl;
+    }
+    m_snapshotEvent.Cancel();
+    m_snapshotEvent = Simulator::Schedule(m_interval, &AodvStatsHelper::WriteSnapshot, this);
+}
+
+void
+AodvStatsHelper::DisableSnapshots()
+{
+    m_snapshotEvent.Cancel();
+    if (m_stream)
+    {
+        m_stream->GetStream()->flush();
+    }
+    m_stream = nullptr;
+}
+
+void
+AodvStatsHelper::EnableFootprintSampling(std::string filename, Time interval)
+{
+    NS_ASSERT_MSG(interval.IsStrictlyPositive(), "Footprint interval must be positive");
+    m_footprintStream = nullptr;
+    if (!filename.empty())
+    {
+        m_footprintStream = Create<OutputStreamWrapper>(filename, std::ios::out);
+        *m_footprintStream->GetStream() << "time,node,structure,entries,bytes" << std::endl;
+    }
+    for (auto& protocol : m_protocols)
+    {
+        protocol->SetAttribute("FootprintInterval", TimeValue(interval));
+    }
+}
+
+Ptr<AodvEventLog>
+AodvStatsHelper::EnableEventLog(std::string filename)
+{
+    m_eventLog = CreateObject<AodvEventLog>();
+    m_eventLog->Open(filename);
+    for (auto& protocol : m_protocols)
+    {
+        protocol->SetAttribute("EventLog", PointerValue(m_eventLog));
+    }
+    return m_eventLog;
+}
+
+AodvStats
+AodvStatsHelper::GetStats(uint32_t nodeId) const
+{
+    auto i = m_stats.find(nodeId);
+    return (i == m_stats.end()) ? AodvStats() : i->second->GetStats();
+}
+
+AodvStats
+AodvStatsHelper::GetTotal() const
+{
+    AodvStats total;
+    for (const auto& i : m_stats)
+    {
+        total += i.second->GetStats();
+    }
+    return total;
+}
+
+AodvLatencyHistogram
+AodvStatsHelper::GetDiscoveryLatency(uint32_t nodeId) const
+{
+    auto i = m_latency.find(nodeId);
+    return (i == m_latency.end()) ? AodvLatencyHistogram() : i->second;
+}
+
+AodvLatencyHistogram
+AodvStatsHelper::GetTotalDiscoveryLatency() const
+{
+    AodvLatencyHistogram total;
+    for (const auto& i : m_latency)
+    {
+        total += i.second;
+    }
+    return total;
+}
+
+AodvLatencyHistogram
+AodvStatsHelper::GetTotalTrustTestLatency() const
+{
+    AodvLatencyHistogram total;
+    for (const auto& i : m_trustLatency)
+    {
+        total += i.second;
+    }
+    return total;
+}
+
+AodvStatsHelper::Airtime
+AodvStatsHelper::GetAirtime(uint32_t nodeId, AodvControlType type) const
+{
+    auto i = m_airtime.find(nodeId);
+    return (i == m_airtime.end()) ? Airtime() : i->second[type];
+}
+
+AodvStatsHelper::Airtime
+AodvStatsHelper::GetTotalAirtime(AodvControlType type) const
+{
+    Airtime total;
+    for (const auto& i : m_airtime)
+    {
+        total.duration += i.second[type].duration;
+        total.frames += i.second[type].frames;
+        total.retries += i.second[type].retries;
+    }
+    return total;
+}
+
+AodvFootprint
+AodvStatsHelper::GetFootprint(uint32_t nodeId) const
+{
+    auto i = m_footprints.find(nodeId);
+    return (i == m_footprints.end()) ? AodvFootprint() : i->second;
+}
+
+AodvFootprint
+AodvStatsHelper::GetTotalFootprint() const
+{
+    AodvFootprint total;
+    for (const auto& i : m_footprints)
+    {
+        total += i.second;
+    }
+    return total;
+}
+
+AodvTrustAccuracy
+AodvStatsHelper::GetTrustAccuracy(uint32_t nodeId) const
+{
+    auto i = m_trustAccuracy.find(nodeId);
+    return (i == m_trustAccuracy.end()) ? AodvTrustAccuracy() : i->second;
+}
+
+AodvTrustAccuracy
+AodvStatsHelper::GetTotalTrustAccuracy() const
+{
+    AodvTrustAccuracy total;
+    for (const auto& i : m_trustAccuracy)
+    {
+        total += i.second;
+    }
+    return total;
+}
+
+AodvLatencyHistogram
+AodvStatsHelper::GetTotalTrustTestDuration() const
+{
+    AodvLatencyHistogram total;
+    for (const auto& i : m_trustTestDuration)
+    {
+        total += i.second;
+    }
+    return total;
+}
+
+std::vector<Ptr<Ipv4RoutingProtocol>>
+AodvStatsHelper::GetRoutingProtocols(Ptr<Ipv4> ipv4)
+{
+    std::vector<Ptr<Ipv4RoutingProtocol>> protocols;
+    Ptr<Ipv4RoutingProtocol> proto = ipv4->GetRoutingProtocol();
+    Ptr<Ipv4ListRouting> list = DynamicCast<Ipv4ListRouting>(proto);
+    if (list)
+    {
+        for (uint32_t i = 0; i < list->GetNRoutingProtocols(); i++)
+        {
+            int16_t priority;
+            protocols.push_back(list->GetRoutingProtocol(i, priority));
+        }
+    }
+    else if (proto)
+    {
+        protocols.push_back(proto);
+    }
+    return protocols;
+}
+
+bool
+AodvStatsHelper::IsMalicious(Ipv4Address address)
+{
+    auto i = m_malicious.find(address);
+    if (i != m_malicious.end())
+    {
+        return i->second;
+    }
+    bool malicious = false;
+    for (auto node = NodeList::Begin(); node != NodeList::End(); ++node)
+    {
+        Ptr<Ipv4> ipv4 = (*node)->GetObject<Ipv4>();
+        if (!ipv4 || ipv4->GetInterfaceForAddress(address) < 0)
+        {
+            continue;
+        }
+        for (auto& protocol : GetRoutingProtocols(ipv4))
+        {
+            BooleanValue value;
+            if (protocol->GetAttributeFailSafe("IsMalicious", value))
+            {
+                malicious = value.Get();
+                break;
+            }
+        }
+        break;
+    }
+    m_malicious[address] = malicious;
+    return malicious;
+}
+
+void
+AodvStatsHelper::DiscoveryDone(std::string context,
+                               Ipv4Address dst,
+                               Time latency,
+                               Time trustDelay)
+{
+    uint32_t nodeId = std::stoul(context);
+    m_latency[nodeId].Add(latency);
+    if (trustDelay.IsStrictlyPositive())
+    {
+        m_trustLatency[nodeId].Add(trustDelay);
+    }
+}
+
+void
+AodvStatsHelper::TrustVerdict(std::string context,
+                              Ipv4Address node,
+                              bool rejected,
+                              Time testDuration)
+{
+    uint32_t nodeId = std::stoul(context);
+    m_trustAccuracy[nodeId].Add(rejected, IsMalicious(node));
+    if (testDuration.IsStrictlyPositive())
+    {
+        m_trustTestDuration[nodeId].Add(testDuration);
+    }
+}
+
+void
+AodvStatsHelper::FootprintSampled(std::string context, const AodvFootprint& footprint)
+{
+    uint32_t nodeId = std::stoul(context);
+    m_footprints[nodeId] = footprint;
+    if (!m_footprintStream)
+    {
+        return;
+    }
+    std::ostream* os = m_footprintStream->GetStream();
+    double now = Simulator::Now().GetSeconds();
+    for (uint32_t i = 0; i < AODV_STATE_STRUCTURES; ++i)
+    {
+        *os << now << "," << nodeId << ","
+            << AodvStateStructureName(static_cast<AodvStateStructure>(i)) << ","
+            << footprint.usage[i].entries << "," << footprint.usage[i].bytes << "\n";
+    }
+}
+
+void
+AodvStatsHelper::PhyTxBegin(std::string context,
+                            WifiConstPsduMap psduMap,
+                            WifiTxVector txVector,
+                            double txPowerW)
+{
+    Ptr<WifiPhy> phy = m_phys[context];
+    int64_t nMpdus = 0;
+    for (const auto& psdu : psduMap)
+    {
+        nMpdus += psdu.second->GetNMpdus();
+    }
+    if (nMpdus == 0)
+    {
+        return;
+    }
+    // The PPDU duration is shared evenly by the MPDUs it aggregates
+    Time share = WifiPhy::CalculateTxDuration(psduMap, txVector, phy->GetPhyBand()) / nMpdus;
+    for (const auto& psdu : psduMap)
+    {
+        for (const auto& mpdu : *psdu.second)
+        {
+            AodvControlTag tag;
+            if (!mpdu->GetPacket()->PeekPacketTag(tag))
+            {
+                continue;
+            }
+            Airtime& airtime = m_airtime[std::stoul(context)][tag.GetControlType()];
+            airtime.duration += share;
+            ++airtime.frames;
+            if (mpdu->GetHeader().IsRetry())
+            {
+                ++airtime.retries;
+            }
+        }
+    }
+}
+
+void
+AodvStatsHelper::WriteSnapshot()
+{
+    std::ostream* os = m_stream->GetStream();
+    double now = Simulator::Now().GetSeconds();
+    for (const auto& i : m_stats)
+    {
+        AodvStats s = i.second->GetStats();
+        if (m_format == CSV)
+        {
+            *os << now << "," << i.first << "," << s.rreqSent << "," << s.rrepSent << ","
+                << s.rerrSent << "," << s.brokenLinks << "," << s.rreqReceived << ","
+                << s.maliciousDrops << "," << s.compactBytesSaved;
+            for (uint64_t bytes : s.controlBytes)
+            {
+                *os << "," << bytes;
+            }
+            *os << "\n";
+        }
+        else
+        {
+            uint32_t node = i.first;
+            os->write(reinterpret_cast<const char*>(&now), sizeof(now));
+            os->write(reinterpret_cast<const char*>(&node), sizeof(node));
+            for (uint64_t counter : {s.rreqSent,
+                                     s.rrepSent,
+                                     s.rerrSent,
+                                     s.brokenLinks,
+                                     s.rreqReceived,
+                                     s.maliciousDrops,
+                                     static_cast<uint64_t>(s.compactBytesSaved)})
+            {
+                os->write(reinterpret_cast<const char*>(&counter), sizeof(counter));
+            }
+            os->write(reinterpret_cast<const char*>(s.controlBytes.data()),
+                      sizeof(uint64_t) * s.controlBytes.size());
+        }
+    }
+    m_snapshotEvent = Simulator::Schedule(m_interval, &AodvStatsHelper::WriteSnapshot, this);
+}
+
+} // namespace ns3
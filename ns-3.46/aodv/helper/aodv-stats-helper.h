@@ -0,0 +1,268 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef AODV_STATS_HELPER_H
+#define AODV_STATS_HELPER_H
+
+#include "ns3/aodv-event-log.h"
+#include "ns3/aodv-stats.h"
+#include "ns3/event-id.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/output-stream-wrapper.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-ppdu.h"
+#include "ns3/wifi-tx-vector.h"
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * @ingroup aodv
+ * @brief Helper class that follows the control overhead counters of AODV, PAODV and TPAODV
+ * nodes and streams periodic snapshots of them.
+ *
+ * The helper reads the counters of the routing protocol of each node through AodvStatsSource
+ * when they are queried or written, so counting costs the protocols nothing more than an
+ * increment. It also collects the latencies reported by the "RouteDiscovery" trace source
+ * into per-node histograms. It must
+ * outlive the simulation run.
+ *
+ * On WiFi devices the helper also measures the air-time of the control messages, by category.
+ * The routing protocols tag each control message with an AodvControlTag; every PHY
+ * transmission of a tagged frame, MAC retries included, is charged its PPDU duration. The
+ * acknowledgments of unicast messages are not charged.
+ *
+ * For TPAODV nodes the helper also checks the first-hand trust verdicts reported by the
+ * "TrustVerdict" trace source against the "IsMalicious" attribute of the routing protocol of
+ * the node the verdict is about, and collects the trust test durations.
+ *
+ * EnableFootprintSampling makes the routing protocols report the entries and approximate
+ * bytes of their state periodically, through their "Footprint" trace source. Each sample
+ * writes one line per node and state structure:
+ * \verbatim
+   time,node,structure,entries,bytes
+   \endverbatim
+ *
+ * EnableEventLog makes the routing protocols record their RREQ, RREP and RERR messages, route
+ * and neighbor changes and trust level changes in one binary file of AodvEventRecord, see
+ * AodvEventLog. scratch/event_log_reader.cc filters and aggregates such a file.
+ *
+ * In CSV format each snapshot writes one line per node:
+ * \verbatim
+   time,node,rreqSent,rrepSent,rerrSent,brokenLinks,rreqReceived,maliciousDrops,compactBytesSaved,
+   rreqBytes,rrepBytes,rerrBytes,rrepAckBytes,helloBytes,trustTestBytes
+   \endverbatim
+ * In binary format each snapshot writes one 116 byte record per node, in host byte order:
+ * the time in seconds as a double, the node ID as a uint32_t and the thirteen counters as
+ * 64-bit integers, in the CSV column order.
+ */
+class AodvStatsHelper
+{
+  public:
+    /// Snapshot file format
+    enum Format
+    {
+        CSV,    //!< One line of comma-separated values per node
+        BINARY, //!< One fixed-size record per node
+    };
+
+    /// Air-time spent on one category of control messages
+    struct Airtime
+    {
+        Time duration;       ///< Air-time of the transmissions
+        uint64_t frames{0};  ///< Transmissions, MAC retries included
+        uint64_t retries{0}; ///< MAC retries
+    };
+
+    AodvStatsHelper();
+    ~AodvStatsHelper();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    AodvStatsHelper(const AodvStatsHelper&) = delete;
+    AodvStatsHelper& operator=(const AodvStatsHelper&) = delete;
+
+    /**
+     * Follow the counters of the routing protocol of a node and the air-time of its WiFi
+     * devices
+     * @param node the node, running AODV, PAODV or TPAODV directly or in an Ipv4ListRouting
+     * @returns true if a routing protocol with counters was found
+     */
+    bool Install(Ptr<Node> node);
+    /**
+     * Follow the counters of the routing protocol of several nodes
+     * @param nodes the nodes
+     */
+    void Install(NodeContainer nodes);
+    /**
+     * Write a snapshot of the counters of all followed nodes periodically
+     * @param filename the name of the snapshot file
+     * @param interval the time between two snapshots
+     * @param format the file format
+     */
+    void EnableSnapshots(std::string filename, Time interval, Format format = CSV);
+    /// Stop writing snapshots
+    void DisableSnapshots();
+    /**
+     * Sample the memory footprint of the protocol state of all followed nodes periodically
+     * @param filename the name of the CSV file, empty to keep only the latest samples
+     * @param interval the time between two samples
+     */
+    void EnableFootprintSampling(std::string filename, Time interval);
+    /**
+     * Record the routing events of all followed nodes in a binary event log
+     * @param filename the name of the log file
+     * @returns the log, to change its attributes or count its records
+     */
+    Ptr<AodvEventLog> EnableEventLog(std::string filename);
+
+    /**
+     * @param nodeId the node ID
+     * @returns the current counters of the node
+     */
+    AodvStats GetStats(uint32_t nodeId) const;
+    /**
+     * @returns the sum of the latest counters of all followed nodes
+     */
+    AodvStats GetTotal() const;
+    /**
+     * @param nodeId the node ID
+     * @returns the latencies of the route discoveries of the node
+     */
+    AodvLatencyHistogram GetDiscoveryLatency(uint32_t nodeId) const;
+    /**
+     * @returns the latencies of the route discoveries of all followed nodes
+     */
+    AodvLatencyHistogram GetTotalDiscoveryLatency() const;
+    /**
+     * @returns the part of the route discovery latencies spent in trust tests, for the
+     *          discoveries which had to wait for one
+     */
+    AodvLatencyHistogram GetTotalTrustTestLatency() const;
+    /**
+     * @param nodeId the node ID
+     * @param type the control message category
+     * @returns the air-time the node spent on the category
+     */
+    Airtime GetAirtime(uint32_t nodeId, AodvControlType type) const;
+    /**
+     * @param type the control message category
+     * @returns the air-time all followed nodes spent on the category
+     */
+    Airtime GetTotalAirtime(AodvControlType type) const;
+    /**
+     * @param nodeId the node ID
+     * @returns the latest footprint sample of the node
+     */
+    AodvFootprint GetFootprint(uint32_t nodeId) const;
+    /**
+     * @returns the sum of the latest footprint samples of all followed nodes
+     */
+    AodvFootprint GetTotalFootprint() const;
+    /**
+     * @param nodeId the node ID
+     * @returns the trust verdicts of the node against the actual behavior of the nodes judged
+     */
+    AodvTrustAccuracy GetTrustAccuracy(uint32_t nodeId) const;
+    /**
+     * @returns the trust verdicts of all followed nodes against the actual behavior of the
+     *          nodes judged
+     */
+    AodvTrustAccuracy GetTotalTrustAccuracy() const;
+    /**
+     * @returns the durations of the trust tests of all followed nodes
+     */
+    AodvLatencyHistogram GetTotalTrustTestDuration() const;
+
+  private:
+    /**
+     * @param ipv4 the IPv4 stack of a node
+     * @returns the routing protocol of the node, or the protocols of its Ipv4ListRouting
+     */
+    static std::vector<Ptr<Ipv4RoutingProtocol>> GetRoutingProtocols(Ptr<Ipv4> ipv4);
+    /**
+     * Look up the node owning an address and tell whether its routing protocol is malicious
+     * @param address the address
+     * @returns the "IsMalicious" attribute of the routing protocol, false if unknown
+     */
+    bool IsMalicious(Ipv4Address address);
+    /**
+     * Trace sink of the "RouteDiscovery" trace source
+     * @param context the node ID
+     * @param dst the destination of the discovery
+     * @param latency the discovery latency
+     * @param trustDelay the part of the latency spent in a trust test
+     */
+    void DiscoveryDone(std::string context, Ipv4Address dst, Time latency, Time trustDelay);
+    /**
+     * Trace sink of the "PhyTxPsduBegin" trace source of a WiFi PHY
+     * @param context the node ID and the PHY, as "node/device/link"
+     * @param psduMap the transmitted PSDUs
+     * @param txVector the TXVECTOR of the PPDU
+     * @param txPowerW the transmit power
+     */
+    void PhyTxBegin(std::string context,
+                    WifiConstPsduMap psduMap,
+                    WifiTxVector txVector,
+                    double txPowerW);
+    /**
+     * Trace sink of the "TrustVerdict" trace source
+     * @param context the node ID
+     * @param node the neighbor the verdict is about
+     * @param rejected whether the neighbor was judged malicious
+     * @param testDuration the duration of the trust test, zero if there was none
+     */
+    void TrustVerdict(std::string context, Ipv4Address node, bool rejected, Time testDuration);
+    /**
+     * Trace sink of the "Footprint" trace source
+     * @param context the node ID
+     * @param footprint the footprint sample
+     */
+    void FootprintSampled(std::string context, const AodvFootprint& footprint);
+    /// Write one snapshot and schedule the next one
+    void WriteSnapshot();
+
+    /// Counters of the followed routing protocols by node ID
+    std::map<uint32_t, const AodvStatsSource*> m_stats;
+    /// Route discovery latencies by node ID
+    std::map<uint32_t, AodvLatencyHistogram> m_latency;
+    /// Trust test part of the route discovery latencies by node ID
+    std::map<uint32_t, AodvLatencyHistogram> m_trustLatency;
+    /// Control message air-time by node ID
+    std::map<uint32_t, std::array<Airtime, AODV_CONTROL_TYPES>> m_airtime;
+    /// Followed WiFi PHYs by trace context
+    std::map<std::string, Ptr<WifiPhy>> m_phys;
+    /// Trust verdicts by node ID
+    std::map<uint32_t, AodvTrustAccuracy> m_trustAccuracy;
+    /// Trust test durations by node ID
+    std::map<uint32_t, AodvLatencyHistogram> m_trustTestDuration;
+    /// Behavior of the nodes judged, by address
+    std::map<Ipv4Address, bool> m_malicious;
+    /// Latest footprint samples by node ID
+    std::map<uint32_t, AodvFootprint> m_footprints;
+    /// Followed routing protocols
+    std::vector<Ptr<Ipv4RoutingProtocol>> m_protocols;
+    /// Footprint file
+    Ptr<OutputStreamWrapper> m_footprintStream;
+    /// Routing event log
+    Ptr<AodvEventLog> m_eventLog;
+    /// Snapshot file
+    Ptr<OutputStreamWrapper> m_stream;
+    /// Snapshot file format
+    Format m_format;
+    /// Time between two snapshots
+    Time m_interval;
+    /// Next snapshot
+    EventId m_snapshotEvent;
+};
+
+} // namespace ns3
+
+#endif /* AODV_STATS_HELPER_H */
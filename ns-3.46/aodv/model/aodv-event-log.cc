@@ -0,0 +1,167 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "aodv-event-log.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("AodvEventLog");
+
+const char*
+AodvEventTypeName(AodvEventType type)
+{
+    switch (type)
+    {
+    case AODV_EVENT_RREQ_SENT:
+        return "rreqSent";
+    case AODV_EVENT_RREQ_RECEIVED:
+        return "rreqReceived";
+    case AODV_EVENT_RREQ_FORWARDED:
+        return "rreqForwarded";
+    case AODV_EVENT_RREP_SENT:
+        return "rrepSent";
+    case AODV_EVENT_RREP_RECEIVED:
+        return "rrepReceived";
+    case AODV_EVENT_RERR_SENT:
+        return "rerrSent";
+    case AODV_EVENT_RERR_RECEIVED:
+        return "rerrReceived";
+    case AODV_EVENT_ROUTE_ADDED:
+        return "routeAdded";
+    case AODV_EVENT_ROUTE_INVALIDATED:
+        return "routeInvalidated";
+    case AODV_EVENT_NEIGHBOR_UP:
+        return "neighborUp";
+    case AODV_EVENT_NEIGHBOR_DOWN:
+        return "neighborDown";
+    case AODV_EVENT_TRUST_CHANGED:
+        return "trustChanged";
+    default:
+        return "unknown";
+    }
+}
+
+NS_OBJECT_ENSURE_REGISTERED(AodvEventLog);
+
+TypeId
+AodvEventLog::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::AodvEventLog")
+            .SetParent<Object>()
+            .SetGroupName("Aodv")
+            .AddConstructor<AodvEventLog>()
+            .AddAttribute("BufferRecords",
+                          "Number of records a node buffers before writing them to the file.",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&AodvEventLog::m_bufferRecords),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+AodvEventLog::AodvEventLog()
+    : m_bufferRecords(1024),
+      m_records(0)
+{
+}
+
+AodvEventLog::~AodvEventLog()
+{
+    NS_LOG_LOGIC(m_records << " events logged");
+}
+
+void
+AodvEventLog::Open(std::string filename)
+{
+    m_file.close();
+    m_file.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_UNLESS(m_file.is_open(), "Cannot create event log " << filename);
+    AodvEventLogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::strncpy(header.magic, "AODVEVT", sizeof(header.magic));
+    header.version = AodvEventLogHeader::VERSION;
+    header.recordSize = sizeof(AodvEventRecord);
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_records = 0;
+}
+
+void
+AodvEventLog::Write(const std::vector<AodvEventRecord>& records)
+{
+    if (!m_file.is_open() || records.empty())
+    {
+        return;
+    }
+    m_file.write(reinterpret_cast<const char*>(records.data()),
+                 records.size() * sizeof(AodvEventRecord));
+    m_records += records.size();
+}
+
+AodvEventBuffer::AodvEventBuffer()
+    : m_log(nullptr),
+      m_node(0)
+{
+}
+
+AodvEventBuffer::~AodvEventBuffer()
+{
+    Flush();
+}
+
+void
+AodvEventBuffer::SetLog(Ptr<AodvEventLog> log)
+{
+    Flush();
+    m_log = log;
+    m_records.clear();
+    m_records.shrink_to_fit();
+}
+
+void
+AodvEventBuffer::Flush()
+{
+    if (m_log)
+    {
+        m_log->Write(m_records);
+    }
+    m_records.clear();
+}
+
+void
+AodvEventBuffer::Append(AodvEventType type,
+                        Ipv4Address address,
+                        Ipv4Address peer,
+                        uint32_t seqNo,
+                        uint8_t hopCount,
+                        int16_t value)
+{
+    if (m_records.capacity() == 0)
+    {
+        m_records.reserve(m_log->GetBufferRecords());
+    }
+    AodvEventRecord record;
+    record.time = Simulator::Now().GetNanoSeconds();
+    record.node = m_node;
+    record.address = address.Get();
+    record.peer = peer.Get();
+    record.seqNo = seqNo;
+    record.type = type;
+    record.hopCount = hopCount;
+    record.value = value;
+    record.reserved = 0;
+    m_records.push_back(record);
+    if (m_records.size() >= m_log->GetBufferRecords())
+    {
+        Flush();
+    }
+}
+
+} // namespace ns3
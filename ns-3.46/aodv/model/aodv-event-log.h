@@ -0,0 +1,225 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef AODV_EVENT_LOG_H
+#define AODV_EVENT_LOG_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/object.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+/**
+ * @ingroup aodv
+ * @brief Routing events recorded in the binary event log.
+ */
+enum AodvEventType : uint8_t
+{
+    AODV_EVENT_RREQ_SENT,         //!< RREQ originated
+    AODV_EVENT_RREQ_RECEIVED,     //!< RREQ received, duplicates excluded
+    AODV_EVENT_RREQ_FORWARDED,    //!< RREQ rebroadcast
+    AODV_EVENT_RREP_SENT,         //!< RREP sent, by the destination or an intermediate node
+    AODV_EVENT_RREP_RECEIVED,     //!< RREP received, HELLO messages excluded
+    AODV_EVENT_RERR_SENT,         //!< RERR sent
+    AODV_EVENT_RERR_RECEIVED,     //!< RERR received
+    AODV_EVENT_ROUTE_ADDED,       //!< Route added or made valid again
+    AODV_EVENT_ROUTE_INVALIDATED, //!< Valid route invalidated
+    AODV_EVENT_NEIGHBOR_UP,       //!< Link to a new neighbor opened
+    AODV_EVENT_NEIGHBOR_DOWN,     //!< Link to a neighbor closed
+    AODV_EVENT_TRUST_CHANGED,     //!< TPAODV trust level of a node set
+    AODV_EVENT_TYPES,             //!< Number of event types
+};
+
+/**
+ * @param type the event type
+ * @returns the lowercase name of the event type
+ */
+const char* AodvEventTypeName(AodvEventType type);
+
+/**
+ * @ingroup aodv
+ * @brief One event of the binary event log, 32 bytes in host byte order.
+ *
+ * Addresses are stored as returned by Ipv4Address::Get. Fields which do not apply to an event
+ * are zero.
+ */
+struct AodvEventRecord
+{
+    int64_t time;      ///< Simulation time, in nanoseconds
+    uint32_t node;     ///< ID of the node which logged the event
+    uint32_t address;  ///< Destination, neighbor, or node whose trust level was set
+    uint32_t peer;     ///< Origin of a RREQ or RREP, next hop of a route, or trust recommender
+    uint32_t seqNo;    ///< Destination sequence number
+    uint8_t type;      ///< AodvEventType
+    uint8_t hopCount;  ///< Hop count
+    int16_t value;     ///< Trust level, or unreachable destinations of a received RERR
+    uint32_t reserved; ///< Pads the record to 32 bytes
+};
+
+static_assert(sizeof(AodvEventRecord) == 32, "AodvEventRecord must stay 32 bytes");
+
+/**
+ * @ingroup aodv
+ * @brief Header of the binary event log file, followed by the records.
+ */
+struct AodvEventLogHeader
+{
+    char magic[8];       ///< "AODVEVT", NUL terminated
+    uint32_t version;    ///< Format version, VERSION
+    uint32_t recordSize; ///< sizeof(AodvEventRecord)
+
+    static const uint32_t VERSION = 1; ///< Current format version
+};
+
+static_assert(sizeof(AodvEventLogHeader) == 16, "AodvEventLogHeader must stay 16 bytes");
+
+/**
+ * @ingroup aodv
+ * @brief Binary file receiving the routing events of many nodes.
+ *
+ * The routing protocols of all nodes share one log through their "EventLog" attribute. Each
+ * of them buffers its own records in an AodvEventBuffer and hands them over in one write when
+ * the buffer is full or the protocol is disposed of, so the records of a node are in time
+ * order but the blocks of different nodes interleave. The file is closed when the last
+ * reference to the log goes away.
+ */
+class AodvEventLog : public Object
+{
+  public:
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    AodvEventLog();
+    ~AodvEventLog() override;
+
+    /**
+     * Create the log file and write its header
+     * @param filename the file name
+     */
+    void Open(std::string filename);
+    /**
+     * Append records to the file
+     * @param records the records
+     */
+    void Write(const std::vector<AodvEventRecord>& records);
+
+    /**
+     * @returns the number of records a node buffers before writing them
+     */
+    uint32_t GetBufferRecords() const
+    {
+        return m_bufferRecords;
+    }
+
+    /**
+     * @returns the number of records written so far
+     */
+    uint64_t GetRecordCount() const
+    {
+        return m_records;
+    }
+
+  private:
+    std::ofstream m_file;     ///< Log file
+    uint32_t m_bufferRecords; ///< Records buffered per node
+    uint64_t m_records;       ///< Records written
+};
+
+/**
+ * @ingroup aodv
+ * @brief Per-node buffer of the binary event log.
+ *
+ * Record does nothing but test a pointer while no log is set, so the calls can stay in the
+ * routing code at no cost.
+ */
+class AodvEventBuffer
+{
+  public:
+    AodvEventBuffer();
+    ~AodvEventBuffer();
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    AodvEventBuffer(const AodvEventBuffer&) = delete;
+    AodvEventBuffer& operator=(const AodvEventBuffer&) = delete;
+
+    /**
+     * Set the log, writing the records buffered for the previous one
+     * @param log the log, nullptr to stop logging
+     */
+    void SetLog(Ptr<AodvEventLog> log);
+
+    /**
+     * @returns the log, nullptr when logging is off
+     */
+    Ptr<AodvEventLog> GetLog() const
+    {
+        return m_log;
+    }
+
+    /**
+     * Set the ID of the node the records belong to
+     * @param node the node ID
+     */
+    void SetNode(uint32_t node)
+    {
+        m_node = node;
+    }
+
+    /**
+     * Record an event at the current simulation time
+     * @param type the event type
+     * @param address the destination, neighbor or node the event is about
+     * @param peer the origin, next hop or recommender
+     * @param seqNo the destination sequence number
+     * @param hopCount the hop count
+     * @param value the trust level or number of unreachable destinations
+     */
+    void Record(AodvEventType type,
+                Ipv4Address address,
+                Ipv4Address peer = Ipv4Address::GetAny(),
+                uint32_t seqNo = 0,
+                uint8_t hopCount = 0,
+                int16_t value = 0)
+    {
+        if (m_log)
+        {
+            Append(type, address, peer, seqNo, hopCount, value);
+        }
+    }
+
+    /// Write the buffered records to the log
+    void Flush();
+
+  private:
+    /**
+     * Buffer a record, writing the buffer out when it is full
+     * @param type the event type
+     * @param address the destination, neighbor or node the event is about
+     * @param peer the origin, next hop or recommender
+     * @param seqNo the destination sequence number
+     * @param hopCount the hop count
+     * @param value the trust level or number of unreachable destinations
+     */
+    void Append(AodvEventType type,
+                Ipv4Address address,
+                Ipv4Address peer,
+                uint32_t seqNo,
+                uint8_t hopCount,
+                int16_t value);
+
+    Ptr<AodvEventLog> m_log;                ///< Log, nullptr when logging is off
+    uint32_t m_node;                        ///< Node ID
+    std::vector<AodvEventRecord> m_records; ///< Buffered records
+};
+
+} // namespace ns3
+
+#endif /* AODV_EVENT_LOG_H */
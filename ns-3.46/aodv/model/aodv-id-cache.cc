@@ -50,5 +50,14 @@ IdCache::GetSize()
     return m_idCache.size();
 }
 
+AodvMemoryUsage
+IdCache::GetMemoryUsage() const
+{
+    AodvMemoryUsage usage;
+    usage.entries = m_idCache.size();
+    usage.bytes = m_idCache.capacity() * sizeof(UniqueId);
+    return usage;
+}
+
 } // namespace aodv
 } // namespace ns3
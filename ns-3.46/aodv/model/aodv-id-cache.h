@@ -17,6 +17,8 @@
 #ifndef AODV_ID_CACHE_H
 #define AODV_ID_CACHE_H
 
+#include "aodv-stats.h"
+
 #include "ns3/ipv4-address.h"
 #include "ns3/simulator.h"
 
@@ -56,6 +58,10 @@ class IdCache
      * @returns number of entries in cache
      */
     uint32_t GetSize();
+    /**
+     * @returns the entries and approximate bytes of the cache, expired entries included
+     */
+    AodvMemoryUsage GetMemoryUsage() const;
 
     /**
      * Set lifetime for future added entries.
@@ -16,6 +16,8 @@
 
 #include "aodv-neighbor.h"
 
+#include "aodv-profiler.h"
+
 #include "ns3/log.h"
 #include "ns3/wifi-mac-header.h"
 
@@ -83,6 +85,10 @@ Neighbors::Update(Ipv4Address addr, Time expire)
     NS_LOG_LOGIC("Open link to " << addr);
     Neighbor neighbor(addr, LookupMacAddress(addr), expire + Simulator::Now());
     m_nb.push_back(neighbor);
+    if (!m_handleNewNeighbor.IsNull())
+    {
+        m_handleNewNeighbor(addr);
+    }
     Purge();
 }
 
@@ -106,6 +112,7 @@ struct CloseNeighbor
 void
 Neighbors::Purge()
 {
+    AODV_PROFILE_SCOPE("aodv::Neighbors::Purge");
     if (m_nb.empty())
     {
         return;
@@ -126,6 +133,7 @@ Neighbors::Purge()
     m_nb.erase(std::remove_if(m_nb.begin(), m_nb.end(), pred), m_nb.end());
     m_ntimer.Cancel();
     m_ntimer.Schedule();
+    AODV_PROFILE_TIMER("aodv::NeighborTimer", m_ntimer);
 }
 
 void
@@ -133,6 +141,16 @@ Neighbors::ScheduleTimer()
 {
     m_ntimer.Cancel();
     m_ntimer.Schedule();
+    AODV_PROFILE_TIMER("aodv::NeighborTimer", m_ntimer);
+}
+
+AodvMemoryUsage
+Neighbors::GetMemoryUsage() const
+{
+    AodvMemoryUsage usage;
+    usage.entries = m_nb.size();
+    usage.bytes = m_nb.capacity() * sizeof(Neighbor);
+    return usage;
 }
 
 void
@@ -17,6 +17,8 @@
 #ifndef AODVNEIGHBOR_H
 #define AODVNEIGHBOR_H
 
+#include "aodv-stats.h"
+
 #include "ns3/arp-cache.h"
 #include "ns3/callback.h"
 #include "ns3/ipv4-address.h"
@@ -98,6 +100,10 @@ class Neighbors
     void Purge();
     /// Schedule m_ntimer.
     void ScheduleTimer();
+    /**
+     * @returns the entries and approximate bytes of the neighbor list
+     */
+    AodvMemoryUsage GetMemoryUsage() const;
 
     /// Remove all entries
     void Clear()
@@ -143,9 +149,20 @@ class Neighbors
         return m_handleLinkFailure;
     }
 
+    /**
+     * Set the callback invoked when a link to a new neighbor is opened
+     * @param cb the callback function
+     */
+    void SetNewNeighborCallback(Callback<void, Ipv4Address> cb)
+    {
+        m_handleNewNeighbor = cb;
+    }
+
   private:
     /// link failure callback
     Callback<void, Ipv4Address> m_handleLinkFailure;
+    /// new neighbor callback
+    Callback<void, Ipv4Address> m_handleNewNeighbor;
     /// TX error callback
     Callback<void, const WifiMacHeader&> m_txErrorCallback;
     /// Timer for neighbor's list. Schedule Purge().
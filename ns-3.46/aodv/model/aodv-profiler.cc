@@ -0,0 +1,255 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "aodv-profiler.h"
+
+#include "ns3/assert.h"
+#include "ns3/simulator.h"
+
+#include <fstream>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+namespace ns3
+{
+
+namespace
+{
+/// Handler counters; a deque keeps them in place as it grows
+std::deque<AodvProfiler::Counter>&
+GetCounters()
+{
+    static std::deque<AodvProfiler::Counter> counters;
+    return counters;
+}
+
+/// Event categories
+std::deque<AodvProfiler::EventCounter>&
+GetEventCounters()
+{
+    static std::deque<AodvProfiler::EventCounter> counters;
+    return counters;
+}
+
+/// Whether the summary is scheduled for the current simulation
+bool g_dumpScheduled = false;
+/// Window length of the event series
+Time g_eventWindow = Seconds(1);
+/// File of the event series, none if empty
+std::string g_eventSeriesFile;
+} // namespace
+
+AodvProfiler::Counter*
+AodvProfiler::Register(const char* name)
+{
+    auto& counters = GetCounters();
+    for (auto& counter : counters)
+    {
+        if (std::strcmp(counter.name, name) == 0)
+        {
+            return &counter;
+        }
+    }
+    counters.push_back({name, 0, 0});
+    return &counters.back();
+}
+
+void
+AodvProfiler::Record(Counter* counter, uint64_t nanoseconds)
+{
+    ++counter->calls;
+    counter->nanoseconds += nanoseconds;
+    ScheduleDump();
+}
+
+AodvProfiler::EventCounter*
+AodvProfiler::RegisterEvent(const char* name)
+{
+    auto& counters = GetEventCounters();
+    for (auto& counter : counters)
+    {
+        if (std::strcmp(counter.name, name) == 0)
+        {
+            return &counter;
+        }
+    }
+    counters.push_back({name, 0, Time(), {}});
+    return &counters.back();
+}
+
+void
+AodvProfiler::RecordEvent(EventCounter* counter, Time residency)
+{
+    ++counter->events;
+    counter->residency += residency;
+    // The event is queued from now to its expiry: partly in its first and last windows, over
+    // the whole of those in between, which a difference of queued events covers in O(1)
+    Time start = Simulator::Now();
+    Time end = start + residency;
+    int64_t step = g_eventWindow.GetTimeStep();
+    auto first = static_cast<std::size_t>(start.GetTimeStep() / step);
+    auto last = static_cast<std::size_t>(end.GetTimeStep() / step);
+    if (counter->series.size() <= last)
+    {
+        counter->series.resize(last + 1, {0, Time(), 0});
+    }
+    ++counter->series[first].events;
+    if (first == last)
+    {
+        counter->series[first].partial += residency;
+    }
+    else
+    {
+        counter->series[first].partial += g_eventWindow * static_cast<int64_t>(first + 1) - start;
+        counter->series[last].partial += end - g_eventWindow * static_cast<int64_t>(last);
+        ++counter->series[first + 1].spanning;
+        --counter->series[last].spanning;
+    }
+    ScheduleDump();
+}
+
+EventId
+AodvProfiler::RecordEvent(EventCounter* counter, EventId event)
+{
+    RecordEvent(counter, Simulator::GetDelayLeft(event));
+    return event;
+}
+
+void
+AodvProfiler::EnableEventSeries(std::string filename, Time window)
+{
+    NS_ASSERT_MSG(window.IsStrictlyPositive(), "Event window must be positive");
+    g_eventSeriesFile = filename;
+    g_eventWindow = window;
+}
+
+void
+AodvProfiler::Print(std::ostream& os)
+{
+    std::vector<const Counter*> sorted;
+    for (const auto& counter : GetCounters())
+    {
+        if (counter.calls > 0)
+        {
+            sorted.push_back(&counter);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const Counter* a, const Counter* b) {
+        return a->nanoseconds > b->nanoseconds;
+    });
+    os << std::left << std::setw(44) << "HANDLER" << std::right << std::setw(12) << "CALLS"
+       << std::setw(14) << "TOTAL ms" << std::setw(12) << "ns/call" << std::endl;
+    for (const Counter* counter : sorted)
+    {
+        os << std::left << std::setw(44) << counter->name << std::right << std::setw(12)
+           << counter->calls << std::setw(14) << std::fixed << std::setprecision(3)
+           << counter->nanoseconds / 1e6 << std::setw(12) << std::setprecision(0)
+           << double(counter->nanoseconds) / counter->calls << std::endl;
+    }
+    os << std::defaultfloat;
+}
+
+void
+AodvProfiler::PrintEvents(std::ostream& os)
+{
+    std::vector<const EventCounter*> sorted;
+    uint64_t total = 0;
+    for (const auto& counter : GetEventCounters())
+    {
+        if (counter.events > 0)
+        {
+            sorted.push_back(&counter);
+            total += counter.events;
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const EventCounter* a, const EventCounter* b) {
+        return a->events > b->events;
+    });
+    os << std::left << std::setw(44) << "EVENT CATEGORY" << std::right << std::setw(12)
+       << "EVENTS" << std::setw(9) << "SHARE" << std::setw(14) << "MEAN WAIT ms" << std::endl;
+    for (const EventCounter* counter : sorted)
+    {
+        os << std::left << std::setw(44) << counter->name << std::right << std::setw(12)
+           << counter->events << std::setw(8) << std::fixed << std::setprecision(1)
+           << 100.0 * counter->events / total << "%" << std::setw(14) << std::setprecision(3)
+           << counter->residency.GetSeconds() * 1000 / counter->events << std::endl;
+    }
+    os << std::defaultfloat;
+}
+
+void
+AodvProfiler::PrintEventSeries(std::ostream& os)
+{
+    os << "time,category,events,residency,queued" << std::endl;
+    for (const auto& counter : GetEventCounters())
+    {
+        int64_t spanning = 0;
+        for (std::size_t w = 0; w < counter.series.size(); ++w)
+        {
+            Time start = g_eventWindow * static_cast<int64_t>(w);
+            if (start >= Simulator::Now() && w > 0)
+            {
+                // Events still queued when the simulation stopped never expire
+                break;
+            }
+            spanning += counter.series[w].spanning;
+            Time residency = counter.series[w].partial + g_eventWindow * spanning;
+            if (counter.series[w].events == 0 && residency.IsZero())
+            {
+                continue;
+            }
+            os << start.GetSeconds() << "," << counter.name << "," << counter.series[w].events
+               << "," << residency.GetSeconds() << ","
+               << residency.GetSeconds() / g_eventWindow.GetSeconds() << std::endl;
+        }
+    }
+}
+
+void
+AodvProfiler::Reset()
+{
+    for (auto& counter : GetCounters())
+    {
+        counter.calls = 0;
+        counter.nanoseconds = 0;
+    }
+    for (auto& counter : GetEventCounters())
+    {
+        counter.events = 0;
+        counter.residency = Time();
+        counter.series.clear();
+    }
+}
+
+void
+AodvProfiler::ScheduleDump()
+{
+    if (!g_dumpScheduled)
+    {
+        g_dumpScheduled = true;
+        Simulator::ScheduleDestroy(&AodvProfiler::Dump);
+    }
+}
+
+void
+AodvProfiler::Dump()
+{
+    // Standard output may carry the results of the program, e.g. overhead_test --output=json
+    std::clog << "========= AODV HANDLER PROFILE =========" << std::endl;
+    Print(std::clog);
+    PrintEvents(std::clog);
+    if (!g_eventSeriesFile.empty())
+    {
+        std::ofstream series(g_eventSeriesFile);
+        PrintEventSeries(series);
+    }
+    Reset();
+    g_dumpScheduled = false;
+}
+
+} // namespace ns3
@@ -0,0 +1,209 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef AODV_PROFILER_H
+#define AODV_PROFILER_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @file
+ * @ingroup aodv
+ * Wall-clock timers of the AODV, PAODV and TPAODV handlers and attribution of the events they
+ * schedule.
+ *
+ * The instrumentation is compiled in only when AODV_PROFILING is defined, which the build does
+ * when configured with -DNS3_AODV_PROFILING=ON. Otherwise AODV_PROFILE_SCOPE and
+ * AODV_PROFILE_TIMER expand to nothing and AODV_PROFILE_EVENT to its event expression.
+ */
+
+namespace ns3
+{
+/**
+ * @ingroup aodv
+ * @brief Registry of the handler timers and of the event categories.
+ *
+ * Each handler owns one counter of calls and inclusive wall-clock nanoseconds. Each event
+ * category owns one counter of scheduled events and of the simulated time they spend in the
+ * event queue, overall and per time window. An event counts in the window it is scheduled in,
+ * its residency in every window it spends queued. Cancelled events count in full, since the
+ * simulator keeps them queued until they expire. The summary is printed on the standard error,
+ * and the counters reset, when the simulator is destroyed.
+ */
+class AodvProfiler
+{
+  public:
+    /// Calls and time spent in one handler
+    struct Counter
+    {
+        const char* name;     ///< Handler name
+        uint64_t calls;       ///< Number of calls
+        uint64_t nanoseconds; ///< Wall-clock time spent in the calls, callees included
+    };
+
+    /// Events of one category in one time window
+    struct EventWindow
+    {
+        uint64_t events; ///< Number of events scheduled in the window
+        Time partial;    ///< Residency in the window of the events queued or expiring in it
+        /// Change from the previous window in the number of events queued over the whole window
+        int64_t spanning;
+    };
+
+    /// Events scheduled in one category
+    struct EventCounter
+    {
+        const char* name;                ///< Category name
+        uint64_t events;                 ///< Number of events
+        Time residency;                  ///< Time the events spend in the event queue
+        std::vector<EventWindow> series; ///< Events and residency by window
+    };
+
+    /**
+     * Get the counter of a handler, creating it if needed
+     * @param name the handler name, which must outlive the program
+     * @returns the counter, valid for the lifetime of the program
+     */
+    static Counter* Register(const char* name);
+    /**
+     * Account for one call of a handler
+     * @param counter the counter of the handler
+     * @param nanoseconds the time spent in the call
+     */
+    static void Record(Counter* counter, uint64_t nanoseconds);
+    /**
+     * Get the counter of an event category, creating it if needed
+     * @param name the category name, which must outlive the program
+     * @returns the counter, valid for the lifetime of the program
+     */
+    static EventCounter* RegisterEvent(const char* name);
+    /**
+     * Account for one scheduled event
+     * @param counter the counter of the category
+     * @param residency the time until the event expires
+     */
+    static void RecordEvent(EventCounter* counter, Time residency);
+    /**
+     * Account for one scheduled event
+     * @param counter the counter of the category
+     * @param event the event
+     * @returns the event
+     */
+    static EventId RecordEvent(EventCounter* counter, EventId event);
+    /**
+     * Write the per-window event counts to a file when the simulator is destroyed
+     * @param filename the name of the CSV file
+     * @param window the window length
+     */
+    static void EnableEventSeries(std::string filename, Time window);
+    /**
+     * Print the counters, most expensive handler first
+     * @param os the output stream
+     */
+    static void Print(std::ostream& os);
+    /**
+     * Print the event counters, busiest category first
+     * @param os the output stream
+     */
+    static void PrintEvents(std::ostream& os);
+    /**
+     * Write the per-window event counts, up to the current simulation time, as CSV lines of
+     * "time,category,events,residency,queued". Events count in the window they were scheduled
+     * in, residency is the time the events of the category spent queued during the window and
+     * queued their mean number in the queue over the window
+     * @param os the output stream
+     */
+    static void PrintEventSeries(std::ostream& os);
+    /// Reset all counters to zero
+    static void Reset();
+
+  private:
+    /// Make sure the summary is printed at the next Simulator::Destroy
+    static void ScheduleDump();
+    /// Print the summary and reset the counters, run at Simulator::Destroy
+    static void Dump();
+};
+
+/**
+ * @ingroup aodv
+ * @brief Times the scope it lives in and records it on a handler counter.
+ */
+class AodvScopedTimer
+{
+  public:
+    /**
+     * Constructor
+     * @param counter the counter of the handler
+     */
+    explicit AodvScopedTimer(AodvProfiler::Counter* counter)
+        : m_counter(counter),
+          m_start(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~AodvScopedTimer()
+    {
+        auto elapsed = std::chrono::steady_clock::now() - m_start;
+        AodvProfiler::Record(
+            m_counter,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    AodvScopedTimer(const AodvScopedTimer&) = delete;
+    AodvScopedTimer& operator=(const AodvScopedTimer&) = delete;
+
+  private:
+    AodvProfiler::Counter* m_counter;              ///< Handler counter
+    std::chrono::steady_clock::time_point m_start; ///< Start of the scope
+};
+
+} // namespace ns3
+
+#ifdef AODV_PROFILING
+/**
+ * Time the rest of the enclosing scope as handler \p name
+ * @param name the handler name, a string literal
+ */
+#define AODV_PROFILE_SCOPE(name)                                                                 \
+    static ns3::AodvProfiler::Counter* aodvProfileCounter = ns3::AodvProfiler::Register(name);   \
+    ns3::AodvScopedTimer aodvScopedTimer(aodvProfileCounter)
+
+/**
+ * Attribute an event to category \p name
+ * @param name the category name, a string literal
+ * @param event an expression scheduling the event and returning its EventId
+ */
+#define AODV_PROFILE_EVENT(name, event)                                                          \
+    ([&]() {                                                                                     \
+        static ns3::AodvProfiler::EventCounter* aodvEventCounter =                               \
+            ns3::AodvProfiler::RegisterEvent(name);                                              \
+        return ns3::AodvProfiler::RecordEvent(aodvEventCounter, event);                          \
+    }())
+
+/**
+ * Attribute the event of a Timer which was just scheduled to category \p name
+ * @param name the category name, a string literal
+ * @param timer the timer
+ */
+#define AODV_PROFILE_TIMER(name, timer)                                                          \
+    do                                                                                           \
+    {                                                                                            \
+        static ns3::AodvProfiler::EventCounter* aodvEventCounter =                               \
+            ns3::AodvProfiler::RegisterEvent(name);                                              \
+        ns3::AodvProfiler::RecordEvent(aodvEventCounter, (timer).GetDelayLeft());               \
+    } while (false)
+#else
+#define AODV_PROFILE_SCOPE(name)
+#define AODV_PROFILE_EVENT(name, event) (event)
+#define AODV_PROFILE_TIMER(name, timer)
+#endif
+
+#endif /* AODV_PROFILER_H */
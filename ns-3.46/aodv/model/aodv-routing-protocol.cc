@@ -16,6 +16,8 @@
 
 #include "aodv-routing-protocol.h"
 
+#include "aodv-profiler.h"
+
 #include "ns3/adhoc-wifi-mac.h"
 #include "ns3/boolean.h"
 #include "ns3/inet-socket-address.h"
@@ -158,6 +160,8 @@ RoutingProtocol::RoutingProtocol()
       m_gratuitousReply(true),
       m_enableHello(false),
       m_enableBroadcast(true),
+      m_rerrAggregationWindow(Seconds(0)),
+      m_compactHeaders(false),
       m_ipv4(nullptr),
       m_socketAddresses(),
       m_socketSubnetBroadcastAddresses(),
@@ -171,21 +175,21 @@ RoutingProtocol::RoutingProtocol()
       m_nb(m_helloInterval),
       m_rreqCount(0),
       m_rerrCount(0),
-      m_rreqSentCount(0),
-      m_rrepSentCount(0),
-      m_rerrSentCount(0),
-      m_brokenLinkCount(0),
-      m_rreqReceivedCount(0), 
-      m_maliciousDropCount(0), // <--- ADD THIS (Initialize to 0
       m_htimer(Timer::CANCEL_ON_DESTROY),
       m_rreqRateLimitTimer(Timer::CANCEL_ON_DESTROY),
       m_rerrRateLimitTimer(Timer::CANCEL_ON_DESTROY),
+      m_rerrAggregationTimer(Timer::CANCEL_ON_DESTROY),
+      m_footprintTimer(Timer::CANCEL_ON_DESTROY),
+      m_statsTimer(Timer::CANCEL_ON_DESTROY),
       m_addressReqTimer(),
       m_uniformRandomVariable(CreateObject<UniformRandomVariable>()),
       m_lastBcastTime()
 {
     m_nb.SetCallback(
         MakeCallback(&RoutingProtocol::SendRerrWhenBreaksLinkToNextHop, this));
+    m_nb.SetNewNeighborCallback(MakeCallback(&RoutingProtocol::NotifyNewNeighbor, this));
+    m_routingTable.SetRouteChangeCallback(
+        MakeCallback(&RoutingProtocol::NotifyRouteChange, this));
 }
 
 TypeId
@@ -342,6 +346,52 @@ RoutingProtocol::GetTypeId()
                           StringValue("ns3::UniformRandomVariable"),
                           MakePointerAccessor(&RoutingProtocol::m_uniformRandomVariable),
                           MakePointerChecker<UniformRandomVariable>())
+            .AddAttribute("RerrAggregationWindow",
+                          "Period during which the destinations made unreachable by several link "
+                          "breaks are merged into as few RERR messages as possible. "
+                          "Zero disables aggregation.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::m_rerrAggregationWindow),
+                          MakeTimeChecker())
+            .AddAttribute("CompactHeaders",
+                          "Encode RREQ and RREP (including HELLO) messages in the compact, "
+                          "non-RFC format. All nodes of the network must use the same setting.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_compactHeaders),
+                          MakeBooleanChecker())
+            .AddAttribute("FootprintInterval",
+                          "Time between two samples of the memory footprint of the protocol "
+                          "state, reported by the Footprint trace source. Zero disables the "
+                          "sampling.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::SetFootprintInterval,
+                                           &RoutingProtocol::GetFootprintInterval),
+                          MakeTimeChecker())
+            .AddAttribute("StatsInterval",
+                          "Time between two reports of the control overhead counters by the "
+                          "Stats trace source. Zero disables the reports.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::SetStatsInterval,
+                                           &RoutingProtocol::GetStatsInterval),
+                          MakeTimeChecker())
+            .AddAttribute("EventLog",
+                          "Binary log receiving the routing events of the node, none if null.",
+                          PointerValue(),
+                          MakePointerAccessor(&RoutingProtocol::SetEventLog,
+                                              &RoutingProtocol::GetEventLog),
+                          MakePointerChecker<AodvEventLog>())
+            .AddTraceSource("Footprint",
+                            "Periodic sample of the memory footprint of the protocol state.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_footprintTrace),
+                            "ns3::AodvFootprint::TracedCallback")
+            .AddTraceSource("Stats",
+                            "Periodic report of the control overhead counters of the node.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_statsTrace),
+                            "ns3::AodvStats::TracedCallback")
+            .AddTraceSource("RouteDiscovery",
+                            "A route discovery completed.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_discoveryTrace),
+                            "ns3::aodv::RoutingProtocol::DiscoveryTracedCallback")
             .AddAttribute ("IsMalicious",
                         "If true, the node becomes a Blackhole attacker.",
                         BooleanValue (false),
@@ -384,6 +434,10 @@ RoutingProtocol::DoDispose()
         iter->first->Close();
     }
     m_socketSubnetBroadcastAddresses.clear();
+    m_discoveryStart.clear();
+    m_footprintTimer.Cancel();
+    m_statsTimer.Cancel();
+    m_eventLog.SetLog(nullptr);
     Ipv4RoutingProtocol::DoDispose();
 }
 
@@ -417,9 +471,13 @@ RoutingProtocol::Start()
     }
     m_rreqRateLimitTimer.SetFunction(&RoutingProtocol::RreqRateLimitTimerExpire, this);
     m_rreqRateLimitTimer.Schedule(Seconds(1));
+    AODV_PROFILE_TIMER("aodv::RateLimitTimer", m_rreqRateLimitTimer);
 
     m_rerrRateLimitTimer.SetFunction(&RoutingProtocol::RerrRateLimitTimerExpire, this);
     m_rerrRateLimitTimer.Schedule(Seconds(1));
+    AODV_PROFILE_TIMER("aodv::RateLimitTimer", m_rerrRateLimitTimer);
+
+    m_rerrAggregationTimer.SetFunction(&RoutingProtocol::RerrAggregationTimerExpire, this);
 }
 
 Ptr<Ipv4Route>
@@ -428,6 +486,7 @@ RoutingProtocol::RouteOutput(Ptr<Packet> p,
                              Ptr<NetDevice> oif,
                              Socket::SocketErrno& sockerr)
 {
+    AODV_PROFILE_SCOPE("aodv::RoutingProtocol::RouteOutput");
     NS_LOG_FUNCTION(this << header << (oif ? oif->GetIfIndex() : 0));
     if (!p)
     {
@@ -509,6 +568,7 @@ RoutingProtocol::RouteInput(Ptr<const Packet> p,
                             const LocalDeliverCallback& lcb,
                             const ErrorCallback& ecb)
 {
+    AODV_PROFILE_SCOPE("aodv::RoutingProtocol::RouteInput");
     NS_LOG_FUNCTION(this << p->GetUid() << header.GetDestination() << idev->GetAddress());
     if (m_socketAddresses.empty())
     {
@@ -655,6 +715,7 @@ RoutingProtocol::Forwarding(Ptr<const Packet> p,
                             UnicastForwardCallback ucb,
                             ErrorCallback ecb)
 {
+    AODV_PROFILE_SCOPE("aodv::RoutingProtocol::Forwarding");
     NS_LOG_FUNCTION(this);
 
     // --- FIXED MALICIOUS LOGIC ---
@@ -680,7 +741,7 @@ RoutingProtocol::Forwarding(Ptr<const Packet> p,
             NS_LOG_INFO ("MALICIOUS NODE " << GetObject<Node>()->GetId() 
                          << " DROPPING DATA PACKET " << p->GetUid());
             
-            m_maliciousDropCount++; 
+            IncrementStat(&AodvStats::maliciousDrops); 
             return true; // Drop the packet (Blackhole)
         }
         
@@ -749,6 +810,11 @@ RoutingProtocol::SetIpv4(Ptr<Ipv4> ipv4)
     NS_ASSERT(!m_ipv4);
 
     m_ipv4 = ipv4;
+    Ptr<Node> node = ipv4->GetObject<Node>();
+    if (node)
+    {
+        m_eventLog.SetNode(node->GetId());
+    }
 
     // Create lo route. It is asserted that the only one interface up for now is loopback
     NS_ASSERT(m_ipv4->GetNInterfaces() == 1 &&
@@ -767,7 +833,7 @@ RoutingProtocol::SetIpv4(Ptr<Ipv4> ipv4)
         /*lifetime=*/Simulator::GetMaximumSimulationTime());
     m_routingTable.AddRoute(rt);
 
-    Simulator::ScheduleNow(&RoutingProtocol::Start, this);
+    AODV_PROFILE_EVENT("aodv::Start", Simulator::ScheduleNow(&RoutingProtocol::Start, this));
 }
 
 void
@@ -841,7 +907,7 @@ RoutingProtocol::NotifyInterfaceUp(uint32_t i)
 void
 RoutingProtocol::NotifyTxError(WifiMacDropReason reason, Ptr<const WifiMpdu> mpdu)
 {
-    // DO NOT increment m_brokenLinkCount here
+    // DO NOT count the broken link here
     // Not every MAC TX error means a broken route in PAODV/AODV.
 
     // Keep original neighbor processing
@@ -1092,13 +1158,17 @@ void
 RoutingProtocol::SendRequest(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
+    // Retries keep the start of the first attempt
+    m_discoveryStart.emplace(dst, Simulator::Now());
     // A node SHOULD NOT originate more than RREQ_RATELIMIT RREQ messages per second.
     if (m_rreqCount == m_rreqRateLimit)
     {
-        Simulator::Schedule(m_rreqRateLimitTimer.GetDelayLeft() + MicroSeconds(100),
-                            &RoutingProtocol::SendRequest,
-                            this,
-                            dst);
+        AODV_PROFILE_EVENT(
+            "aodv::RreqRateLimitDefer",
+            Simulator::Schedule(m_rreqRateLimitTimer.GetDelayLeft() + MicroSeconds(100),
+                                &RoutingProtocol::SendRequest,
+                                this,
+                                dst));
         return;
     }
     else
@@ -1191,10 +1261,13 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
         SocketIpTtlTag tag;
         tag.SetTtl(ttl);
         packet->AddPacketTag(tag);
+        rreqHeader.SetCompact(m_compactHeaders);
         packet->AddHeader(rreqHeader);
+        AddCompactSavings(rreqHeader.GetCompactSavings());
         TypeHeader tHeader(AODVTYPE_RREQ);
         packet->AddHeader(tHeader);
-        ++m_rreqSentCount;
+        IncrementStat(&AodvStats::rreqSent);
+        m_eventLog.Record(AODV_EVENT_RREQ_SENT, dst, iface.GetLocal(), rreqHeader.GetDstSeqno());
         // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
         Ipv4Address destination;
         if (iface.GetMask() == Ipv4Mask::GetOnes())
@@ -1207,12 +1280,15 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
         }
         NS_LOG_DEBUG("Send RREQ with id " << rreqHeader.GetId() << " to socket");
         m_lastBcastTime = Simulator::Now();
-        Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
-                            &RoutingProtocol::SendTo,
-                            this,
-                            socket,
-                            packet,
-                            destination);
+        AccountControl(packet, AODV_CONTROL_RREQ);
+        AODV_PROFILE_EVENT(
+            "aodv::RreqJitter",
+            Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
+                                &RoutingProtocol::SendTo,
+                                this,
+                                socket,
+                                packet,
+                                destination));
     }
     ScheduleRreqRetry(dst);
 }
@@ -1250,6 +1326,7 @@ RoutingProtocol::ScheduleRreqRetry(Ipv4Address dst)
         retry = m_netTraversalTime * (1 << backoffFactor);
     }
     m_addressReqTimer[dst].Schedule(retry);
+    AODV_PROFILE_TIMER("aodv::AddressReqTimer", m_addressReqTimer[dst]);
     NS_LOG_LOGIC("Scheduled RREQ retry in " << retry.As(Time::S));
 }
 
@@ -1374,11 +1451,13 @@ RoutingProtocol::UpdateRouteToNeighbor(Ipv4Address sender, Ipv4Address receiver)
 void
 RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src)
 {
+    AODV_PROFILE_SCOPE("aodv::RoutingProtocol::RecvRequest");
     NS_LOG_FUNCTION(this);
     // --- MALICIOUS ATTACK LOGIC START ---
     if (m_isMalicious)
     {
         RreqHeader rreqHeader;
+        rreqHeader.SetCompact(m_compactHeaders);
         p->PeekHeader(rreqHeader); // Peek to see who they are looking for
 
         // We only attack if we are NOT the destination (don't attack ourselves)
@@ -1403,19 +1482,23 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
             // we just reply to the neighbor who sent it.)
             
             Ptr<Packet> packet = Create<Packet> ();
+            fakeRrep.SetCompact(m_compactHeaders);
             packet->AddHeader (fakeRrep);
+            AddCompactSavings(fakeRrep.GetCompactSavings());
             TypeHeader tHeader (AODVTYPE_RREP); // Or AODVTYPE_RREP
             packet->AddHeader (tHeader);
             
             // Send back to the node we got it from
             Ptr<Socket> socket = FindSocketWithInterfaceAddress (m_ipv4->GetAddress (m_ipv4->GetInterfaceForAddress (receiver), 0));
+            AccountControl (packet, AODV_CONTROL_RREP);
             socket->SendTo (packet, 0, InetSocketAddress (src, AODV_PORT)); // Or AODV_PORT
 
             return; // STOP PROCESSING. Do not forward the real RREQ.
         }
     }
-    m_rreqReceivedCount++; // <--- ADD THIS LINE HERE
+    IncrementStat(&AodvStats::rreqReceived); // <--- ADD THIS LINE HERE
     RreqHeader rreqHeader;
+    rreqHeader.SetCompact(m_compactHeaders);
     p->RemoveHeader(rreqHeader);
 
     // A node ignores all RREQs received from any node in its blacklist
@@ -1446,6 +1529,11 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
     // Increment RREQ hop count
     uint8_t hop = rreqHeader.GetHopCount() + 1;
     rreqHeader.SetHopCount(hop);
+    m_eventLog.Record(AODV_EVENT_RREQ_RECEIVED,
+                      rreqHeader.GetDst(),
+                      origin,
+                      rreqHeader.GetDstSeqno(),
+                      hop);
 
     /*
      *  When the reverse route is created or updated, the following actions on the route are also
@@ -1596,9 +1684,11 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
         ttl.SetTtl(tag.GetTtl() - 1);
         packet->AddPacketTag(ttl);
         packet->AddHeader(rreqHeader);
+        AddCompactSavings(rreqHeader.GetCompactSavings());
         TypeHeader tHeader(AODVTYPE_RREQ);
         packet->AddHeader(tHeader);
-        ++m_rreqSentCount;
+        IncrementStat(&AodvStats::rreqSent);
+        m_eventLog.Record(AODV_EVENT_RREQ_FORWARDED, dst, origin, rreqHeader.GetDstSeqno(), hop);
         // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
         Ipv4Address destination;
         if (iface.GetMask() == Ipv4Mask::GetOnes())
@@ -1610,12 +1700,15 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
             destination = iface.GetBroadcast();
         }
         m_lastBcastTime = Simulator::Now();
-        Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
-                            &RoutingProtocol::SendTo,
-                            this,
-                            socket,
-                            packet,
-                            destination);
+        AccountControl(packet, AODV_CONTROL_RREQ);
+        AODV_PROFILE_EVENT(
+            "aodv::RreqJitter",
+            Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
+                                &RoutingProtocol::SendTo,
+                                this,
+                                socket,
+                                packet,
+                                destination));
     }
 }
 
@@ -1642,13 +1735,21 @@ RoutingProtocol::SendReply(const RreqHeader& rreqHeader, const RoutingTableEntry
     SocketIpTtlTag tag;
     tag.SetTtl(toOrigin.GetHop());
     packet->AddPacketTag(tag);
+    rrepHeader.SetCompact(m_compactHeaders);
     packet->AddHeader(rrepHeader);
+    AddCompactSavings(rrepHeader.GetCompactSavings());
     TypeHeader tHeader(AODVTYPE_RREP);
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
+    AccountControl(packet, AODV_CONTROL_RREP);
     socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), AODV_PORT));
-    ++m_rrepSentCount;
+    IncrementStat(&AodvStats::rrepSent);
+    m_eventLog.Record(AODV_EVENT_RREP_SENT,
+                      rrepHeader.GetDst(),
+                      rrepHeader.GetOrigin(),
+                      rrepHeader.GetDstSeqno(),
+                      rrepHeader.GetHopCount());
 }
 
 void
@@ -1684,13 +1785,21 @@ RoutingProtocol::SendReplyByIntermediateNode(RoutingTableEntry& toDst,
     SocketIpTtlTag tag;
     tag.SetTtl(toOrigin.GetHop());
     packet->AddPacketTag(tag);
+    rrepHeader.SetCompact(m_compactHeaders);
     packet->AddHeader(rrepHeader);
+    AddCompactSavings(rrepHeader.GetCompactSavings());
     TypeHeader tHeader(AODVTYPE_RREP);
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
+    AccountControl(packet, AODV_CONTROL_RREP);
     socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), AODV_PORT));
-    ++m_rrepSentCount;
+    IncrementStat(&AodvStats::rrepSent);
+    m_eventLog.Record(AODV_EVENT_RREP_SENT,
+                      rrepHeader.GetDst(),
+                      rrepHeader.GetOrigin(),
+                      rrepHeader.GetDstSeqno(),
+                      rrepHeader.GetHopCount());
     // Generating gratuitous RREPs
     if (gratRep)
     {
@@ -1704,14 +1813,22 @@ RoutingProtocol::SendReplyByIntermediateNode(RoutingTableEntry& toDst,
         SocketIpTtlTag gratTag;
         gratTag.SetTtl(toDst.GetHop());
         packetToDst->AddPacketTag(gratTag);
+        gratRepHeader.SetCompact(m_compactHeaders);
         packetToDst->AddHeader(gratRepHeader);
+        AddCompactSavings(gratRepHeader.GetCompactSavings());
         TypeHeader type(AODVTYPE_RREP);
         packetToDst->AddHeader(type);
         Ptr<Socket> socket = FindSocketWithInterfaceAddress(toDst.GetInterface());
         NS_ASSERT(socket);
         NS_LOG_LOGIC("Send gratuitous RREP " << packet->GetUid());
+        AccountControl(packetToDst, AODV_CONTROL_RREP);
         socket->SendTo(packetToDst, 0, InetSocketAddress(toDst.GetNextHop(), AODV_PORT));
-        ++m_rrepSentCount;
+        IncrementStat(&AodvStats::rrepSent);
+        m_eventLog.Record(AODV_EVENT_RREP_SENT,
+                          gratRepHeader.GetDst(),
+                          gratRepHeader.GetOrigin(),
+                          gratRepHeader.GetDstSeqno(),
+                          gratRepHeader.GetHopCount());
     }
 }
 
@@ -1731,14 +1848,17 @@ RoutingProtocol::SendReplyAck(Ipv4Address neighbor)
     m_routingTable.LookupRoute(neighbor, toNeighbor);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toNeighbor.GetInterface());
     NS_ASSERT(socket);
+    AccountControl(packet, AODV_CONTROL_RREP_ACK);
     socket->SendTo(packet, 0, InetSocketAddress(neighbor, AODV_PORT));
 }
 
 void
 RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sender)
 {
+    AODV_PROFILE_SCOPE("aodv::RoutingProtocol::RecvReply");
     NS_LOG_FUNCTION(this << " src " << sender);
     RrepHeader rrepHeader;
+    rrepHeader.SetCompact(m_compactHeaders);
     p->RemoveHeader(rrepHeader);
     Ipv4Address dst = rrepHeader.GetDst();
     NS_LOG_LOGIC("RREP destination " << dst << " RREP origin " << rrepHeader.GetOrigin());
@@ -1753,6 +1873,12 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
         return;
     }
 
+    m_eventLog.Record(AODV_EVENT_RREP_RECEIVED,
+                      dst,
+                      rrepHeader.GetOrigin(),
+                      rrepHeader.GetDstSeqno(),
+                      hop);
+
     /*
      * If the route table entry to the destination is created or updated, then the following actions
      * occur:
@@ -1819,6 +1945,7 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
             m_routingTable.Update(newEntry);
             m_addressReqTimer[dst].Cancel();
             m_addressReqTimer.erase(dst);
+            RecordDiscovery(dst);
         }
         m_routingTable.LookupRoute(dst, toDst);
         SendPacketFromQueue(dst, toDst.GetRoute());
@@ -1867,10 +1994,12 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
     ttl.SetTtl(tag.GetTtl() - 1);
     packet->AddPacketTag(ttl);
     packet->AddHeader(rrepHeader);
+    AddCompactSavings(rrepHeader.GetCompactSavings());
     TypeHeader tHeader(AODVTYPE_RREP);
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
+    AccountControl(packet, AODV_CONTROL_RREP);
     socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), AODV_PORT));
 }
 
@@ -1933,21 +2062,25 @@ RoutingProtocol::ProcessHello(const RrepHeader& rrepHeader, Ipv4Address receiver
 void
 RoutingProtocol::RecvError(Ptr<Packet> p, Ipv4Address src)
 {
+    AODV_PROFILE_SCOPE("aodv::RoutingProtocol::RecvError");
     NS_LOG_FUNCTION(this << " from " << src);
     RerrHeader rerrHeader;
     p->RemoveHeader(rerrHeader);
+    m_eventLog.Record(AODV_EVENT_RERR_RECEIVED,
+                      src,
+                      Ipv4Address::GetAny(),
+                      0,
+                      0,
+                      rerrHeader.GetDestCount());
     std::map<Ipv4Address, uint32_t> dstWithNextHopSrc;
     std::map<Ipv4Address, uint32_t> unreachable;
     m_routingTable.GetListOfDestinationWithNextHop(src, dstWithNextHopSrc);
     std::pair<Ipv4Address, uint32_t> un;
     while (rerrHeader.RemoveUnDestination(un))
     {
-        for (auto i = dstWithNextHopSrc.begin(); i != dstWithNextHopSrc.end(); ++i)
+        if (dstWithNextHopSrc.find(un.first) != dstWithNextHopSrc.end())
         {
-            if (i->first == un.first)
-            {
-                unreachable.insert(un);
-            }
+            unreachable.insert(un);
         }
     }
 
@@ -1997,6 +2130,7 @@ RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
     {
         SendPacketFromQueue(dst, toDst.GetRoute());
         NS_LOG_LOGIC("route to " << dst << " found");
+        AbandonDiscovery(dst);
         return;
     }
     /*
@@ -2012,6 +2146,7 @@ RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
                                            << m_netDiameter);
         m_addressReqTimer.erase(dst);
         m_routingTable.DeleteRoute(dst);
+        AbandonDiscovery(dst);
         NS_LOG_DEBUG("Route not found. Drop all packets with dst " << dst);
         m_queue.DropPacketWithDst(dst);
         return;
@@ -2027,6 +2162,7 @@ RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
         NS_LOG_DEBUG("Route down. Stop search. Drop packet with destination " << dst);
         m_addressReqTimer.erase(dst);
         m_routingTable.DeleteRoute(dst);
+        AbandonDiscovery(dst);
         m_queue.DropPacketWithDst(dst);
     }
 }
@@ -2048,6 +2184,7 @@ RoutingProtocol::HelloTimerExpire()
     m_htimer.Cancel();
     Time diff = m_helloInterval - offset;
     m_htimer.Schedule(std::max(Seconds(0), diff));
+    AODV_PROFILE_TIMER("aodv::HelloTimer", m_htimer);
     m_lastBcastTime = Seconds(0);
 }
 
@@ -2057,6 +2194,7 @@ RoutingProtocol::RreqRateLimitTimerExpire()
     NS_LOG_FUNCTION(this);
     m_rreqCount = 0;
     m_rreqRateLimitTimer.Schedule(Seconds(1));
+    AODV_PROFILE_TIMER("aodv::RateLimitTimer", m_rreqRateLimitTimer);
 }
 
 void
@@ -2065,6 +2203,7 @@ RoutingProtocol::RerrRateLimitTimerExpire()
     NS_LOG_FUNCTION(this);
     m_rerrCount = 0;
     m_rerrRateLimitTimer.Schedule(Seconds(1));
+    AODV_PROFILE_TIMER("aodv::RateLimitTimer", m_rerrRateLimitTimer);
 }
 
 void
@@ -2098,7 +2237,9 @@ RoutingProtocol::SendHello()
         SocketIpTtlTag tag;
         tag.SetTtl(1);
         packet->AddPacketTag(tag);
+        helloHeader.SetCompact(m_compactHeaders);
         packet->AddHeader(helloHeader);
+        AddCompactSavings(helloHeader.GetCompactSavings());
         TypeHeader tHeader(AODVTYPE_RREP);
         packet->AddHeader(tHeader);
         // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
@@ -2112,7 +2253,15 @@ RoutingProtocol::SendHello()
             destination = iface.GetBroadcast();
         }
         Time jitter = MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10));
-        Simulator::Schedule(jitter, &RoutingProtocol::SendTo, this, socket, packet, destination);
+        AccountControl(packet, AODV_CONTROL_HELLO);
+        AODV_PROFILE_EVENT(
+            "aodv::HelloJitter",
+            Simulator::Schedule(jitter,
+                                &RoutingProtocol::SendTo,
+                                this,
+                                socket,
+                                packet,
+                                destination));
     }
 }
 
@@ -2146,9 +2295,9 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
     NS_LOG_FUNCTION(this << nextHop);
 
     // A real routing link failure happened → increase broken link counter ONCE here
-    ++m_brokenLinkCount;
+    IncrementStat(&AodvStats::brokenLinks);
+    m_eventLog.Record(AODV_EVENT_NEIGHBOR_DOWN, nextHop);
 
-    RerrHeader rerrHeader;
     std::vector<Ipv4Address> precursors;
     std::map<Ipv4Address, uint32_t> unreachable;
 
@@ -2159,9 +2308,49 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
     }
 
     toNextHop.GetPrecursors(precursors);
-    rerrHeader.AddUnDestination(nextHop, toNextHop.GetSeqNo());
 
     m_routingTable.GetListOfDestinationWithNextHop(nextHop, unreachable);
+    for (auto i = unreachable.begin(); i != unreachable.end(); ++i)
+    {
+        RoutingTableEntry toDst;
+        m_routingTable.LookupRoute(i->first, toDst);
+        toDst.GetPrecursors(precursors);
+    }
+    unreachable.insert(std::make_pair(nextHop, toNextHop.GetSeqNo()));
+
+    if (m_rerrAggregationWindow.IsStrictlyPositive())
+    {
+        // Several neighbors often expire in the same Neighbors::Purge; collect their
+        // unreachable destinations and report them together when the window closes.
+        m_pendingRerrUnreachable.insert(unreachable.begin(), unreachable.end());
+        for (auto i = precursors.begin(); i != precursors.end(); ++i)
+        {
+            if (std::find(m_pendingRerrPrecursors.begin(), m_pendingRerrPrecursors.end(), *i) ==
+                m_pendingRerrPrecursors.end())
+            {
+                m_pendingRerrPrecursors.push_back(*i);
+            }
+        }
+        if (!m_rerrAggregationTimer.IsRunning())
+        {
+            m_rerrAggregationTimer.Schedule(m_rerrAggregationWindow);
+            AODV_PROFILE_TIMER("aodv::RerrAggregationTimer", m_rerrAggregationTimer);
+        }
+    }
+    else
+    {
+        SendRerrWithUnreachable(unreachable, precursors);
+    }
+
+    m_routingTable.InvalidateRoutesWithDst(unreachable);
+}
+
+void
+RoutingProtocol::SendRerrWithUnreachable(const std::map<Ipv4Address, uint32_t>& unreachable,
+                                         const std::vector<Ipv4Address>& precursors)
+{
+    NS_LOG_FUNCTION(this << unreachable.size() << precursors.size());
+    RerrHeader rerrHeader;
     for (auto i = unreachable.begin(); i != unreachable.end();)
     {
         if (!rerrHeader.AddUnDestination(i->first, i->second))
@@ -2169,7 +2358,7 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
             TypeHeader typeHeader(AODVTYPE_RERR);
             Ptr<Packet> packet = Create<Packet>();
 
-            ++m_rerrSentCount;   // count RERR
+            IncrementStat(&AodvStats::rerrSent);   // count RERR
 
             SocketIpTtlTag tag;
             tag.SetTtl(1);
@@ -2182,9 +2371,6 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
         }
         else
         {
-            RoutingTableEntry toDst;
-            m_routingTable.LookupRoute(i->first, toDst);
-            toDst.GetPrecursors(precursors);
             ++i;
         }
     }
@@ -2194,7 +2380,7 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
         TypeHeader typeHeader(AODVTYPE_RERR);
         Ptr<Packet> packet = Create<Packet>();
 
-        ++m_rerrSentCount;   // count RERR
+        IncrementStat(&AodvStats::rerrSent);   // count RERR
 
         SocketIpTtlTag tag;
         tag.SetTtl(1);
@@ -2203,9 +2389,34 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
         packet->AddHeader(typeHeader);
         SendRerrMessage(packet, precursors);
     }
+}
 
-    unreachable.insert(std::make_pair(nextHop, toNextHop.GetSeqNo()));
-    m_routingTable.InvalidateRoutesWithDst(unreachable);
+void
+RoutingProtocol::RerrAggregationTimerExpire()
+{
+    NS_LOG_FUNCTION(this);
+    std::map<Ipv4Address, uint32_t> unreachable;
+    std::vector<Ipv4Address> precursors;
+    unreachable.swap(m_pendingRerrUnreachable);
+    precursors.swap(m_pendingRerrPrecursors);
+
+    // Do not report destinations which were repaired while the window was open
+    RoutingTableEntry rt;
+    for (auto i = unreachable.begin(); i != unreachable.end();)
+    {
+        if (m_routingTable.LookupValidRoute(i->first, rt))
+        {
+            NS_LOG_LOGIC("Route to " << i->first << " repaired, not reported in RERR");
+            i = unreachable.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    NS_LOG_LOGIC("Send aggregated RERR for " << unreachable.size() << " destinations to "
+                                             << precursors.size() << " precursors");
+    SendRerrWithUnreachable(unreachable, precursors);
 }
 
 
@@ -2237,8 +2448,10 @@ RoutingProtocol::SendRerrWhenNoRouteToForward(Ipv4Address dst,
         Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
         NS_ASSERT(socket);
 
-        ++m_rerrSentCount;   // count unicast RERR
+        IncrementStat(&AodvStats::rerrSent);   // count unicast RERR
+        m_eventLog.Record(AODV_EVENT_RERR_SENT, toOrigin.GetNextHop());
 
+        AccountControl(packet, AODV_CONTROL_RERR);
         socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), AODV_PORT));
     }
     else
@@ -2253,8 +2466,10 @@ RoutingProtocol::SendRerrWhenNoRouteToForward(Ipv4Address dst,
                  Ipv4Address("255.255.255.255") :
                  iface.GetBroadcast());
 
-            ++m_rerrSentCount;   // count broadcast RERR
+            IncrementStat(&AodvStats::rerrSent);   // count broadcast RERR
+            m_eventLog.Record(AODV_EVENT_RERR_SENT, destination);
 
+            AccountControl(packet, AODV_CONTROL_RERR);
             socket->SendTo(packet->Copy(), 0, InetSocketAddress(destination, AODV_PORT));
         }
     }
@@ -2293,14 +2508,18 @@ RoutingProtocol::SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> pr
             NS_LOG_LOGIC("one precursor => unicast RERR to "
                          << toPrecursor.GetDestination() << " from "
                          << toPrecursor.GetInterface().GetLocal());
-            Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
-                                &RoutingProtocol::SendTo,
-                                this,
-                                socket,
-                                packet,
-                                precursors.front());
+            AccountControl(packet, AODV_CONTROL_RERR);
+            AODV_PROFILE_EVENT(
+                "aodv::RerrJitter",
+                Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
+                                    &RoutingProtocol::SendTo,
+                                    this,
+                                    socket,
+                                    packet,
+                                    precursors.front()));
             m_rerrCount++;
-            ++m_rerrSentCount;
+            IncrementStat(&AodvStats::rerrSent);
+            m_eventLog.Record(AODV_EVENT_RERR_SENT, precursors.front());
         }
         return;
     }
@@ -2335,13 +2554,17 @@ RoutingProtocol::SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> pr
         {
             destination = i->GetBroadcast();
         }
-        Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
-                            &RoutingProtocol::SendTo,
-                            this,
-                            socket,
-                            p,
-                            destination);
-        ++m_rerrSentCount;
+        AccountControl(p, AODV_CONTROL_RERR);
+        AODV_PROFILE_EVENT(
+            "aodv::RerrJitter",
+            Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
+                                &RoutingProtocol::SendTo,
+                                this,
+                                socket,
+                                p,
+                                destination));
+        IncrementStat(&AodvStats::rerrSent);
+        m_eventLog.Record(AODV_EVENT_RERR_SENT, destination);
     }
 }
 
@@ -2397,9 +2620,135 @@ RoutingProtocol::DoInitialize()
         uint32_t startTime = m_uniformRandomVariable->GetInteger(0, 100);
         NS_LOG_DEBUG("Starting at time " << startTime << "ms");
         m_htimer.Schedule(MilliSeconds(startTime));
+        AODV_PROFILE_TIMER("aodv::HelloTimer", m_htimer);
     }
     Ipv4RoutingProtocol::DoInitialize();
 }
 
+void
+RoutingProtocol::IncrementStat(uint64_t AodvStats::*counter)
+{
+    ++(m_stats.*counter);
+}
+
+void
+RoutingProtocol::AddCompactSavings(int64_t bytes)
+{
+    if (bytes != 0)
+    {
+        m_stats.compactBytesSaved += bytes;
+    }
+}
+
+AodvFootprint
+RoutingProtocol::GetFootprint() const
+{
+    AodvFootprint footprint;
+    footprint.usage[AODV_STATE_ROUTES] = m_routingTable.GetMemoryUsage();
+    footprint.usage[AODV_STATE_NEIGHBORS] = m_nb.GetMemoryUsage();
+    footprint.usage[AODV_STATE_REQUEST_QUEUE] = m_queue.GetMemoryUsage();
+    footprint.usage[AODV_STATE_RREQ_ID_CACHE] = m_rreqIdCache.GetMemoryUsage();
+    footprint.usage[AODV_STATE_DPD] = m_dpd.GetMemoryUsage();
+    AodvMemoryUsage& timers = footprint.usage[AODV_STATE_ADDRESS_REQ_TIMERS];
+    timers.entries = m_addressReqTimer.size();
+    timers.bytes =
+        timers.entries * (sizeof(*m_addressReqTimer.begin()) + AodvMemoryUsage::NODE_OVERHEAD);
+    return footprint;
+}
+
+void
+RoutingProtocol::SetFootprintInterval(Time interval)
+{
+    m_footprintInterval = interval;
+    m_footprintTimer.Cancel();
+    if (interval.IsStrictlyPositive())
+    {
+        m_footprintTimer.SetFunction(&RoutingProtocol::FootprintTimerExpire, this);
+        m_footprintTimer.Schedule(interval);
+        AODV_PROFILE_TIMER("aodv::FootprintTimer", m_footprintTimer);
+    }
+}
+
+void
+RoutingProtocol::FootprintTimerExpire()
+{
+    m_footprintTrace(GetFootprint());
+    m_footprintTimer.Schedule(m_footprintInterval);
+    AODV_PROFILE_TIMER("aodv::FootprintTimer", m_footprintTimer);
+}
+
+void
+RoutingProtocol::SetStatsInterval(Time interval)
+{
+    m_statsInterval = interval;
+    m_statsTimer.Cancel();
+    if (interval.IsStrictlyPositive())
+    {
+        m_statsTimer.SetFunction(&RoutingProtocol::StatsTimerExpire, this);
+        m_statsTimer.Schedule(interval);
+        AODV_PROFILE_TIMER("aodv::StatsTimer", m_statsTimer);
+    }
+}
+
+void
+RoutingProtocol::StatsTimerExpire()
+{
+    m_statsTrace(m_stats);
+    m_statsTimer.Schedule(m_statsInterval);
+    AODV_PROFILE_TIMER("aodv::StatsTimer", m_statsTimer);
+}
+
+void
+RoutingProtocol::SetEventLog(Ptr<AodvEventLog> log)
+{
+    m_eventLog.SetLog(log);
+}
+
+void
+RoutingProtocol::NotifyRouteChange(const RoutingTableEntry& rt)
+{
+    m_eventLog.Record(rt.GetFlag() == VALID ? AODV_EVENT_ROUTE_ADDED
+                                            : AODV_EVENT_ROUTE_INVALIDATED,
+                      rt.GetDestination(),
+                      rt.GetNextHop(),
+                      rt.GetSeqNo(),
+                      rt.GetHop());
+}
+
+void
+RoutingProtocol::NotifyNewNeighbor(Ipv4Address neighbor)
+{
+    m_eventLog.Record(AODV_EVENT_NEIGHBOR_UP, neighbor);
+}
+
+void
+RoutingProtocol::AccountControl(Ptr<Packet> packet, AodvControlType type)
+{
+    AodvControlTag tag(type);
+    packet->ReplacePacketTag(tag);
+    m_stats.controlBytes[type] += packet->GetSize();
+}
+
+void
+RoutingProtocol::RecordDiscovery(Ipv4Address dst)
+{
+    auto i = m_discoveryStart.find(dst);
+    if (i == m_discoveryStart.end())
+    {
+        return;
+    }
+    Time latency = Simulator::Now() - i->second;
+    m_discoveryStart.erase(i);
+    NS_LOG_LOGIC("Route discovery of " << dst << " took " << latency.As(Time::MS));
+    m_discoveryLatency.Add(latency);
+    m_discoveryTrace(dst, latency, Time());
+}
+
+void
+RoutingProtocol::AbandonDiscovery(Ipv4Address dst)
+{
+    m_discoveryStart.erase(dst);
+}
+
 } // namespace aodv
 } // namespace ns3
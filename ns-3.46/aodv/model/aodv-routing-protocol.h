@@ -17,10 +17,12 @@
 #define AODVROUTINGPROTOCOL_H
 
 #include "aodv-dpd.h"
+#include "aodv-event-log.h"
 #include "aodv-neighbor.h"
 #include "aodv-packet.h"
 #include "aodv-rqueue.h"
 #include "aodv-rtable.h"
+#include "aodv-stats.h"
 
 #include "ns3/ipv4-interface.h"
 #include "ns3/ipv4-l3-protocol.h"
@@ -28,6 +30,7 @@
 #include "ns3/node.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
 
 #include <map>
 
@@ -44,7 +47,7 @@ namespace aodv
  *
  * @brief AODV routing protocol
  */
-class RoutingProtocol : public Ipv4RoutingProtocol
+class RoutingProtocol : public Ipv4RoutingProtocol, public AodvStatsSource
 {
   public:
     /**
@@ -192,12 +195,64 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      */
     int64_t AssignStreams(int64_t stream);
 
-    uint64_t GetRreqSentCount () const { return m_rreqSentCount; }
-    uint64_t GetRerrSentCount () const { return m_rerrSentCount; }
-    uint64_t GetRrepSentCount () const { return m_rrepSentCount; }
-    uint64_t GetBrokenLinkCount () const { return m_brokenLinkCount; }
-    uint32_t GetRreqReceivedCount () const { return m_rreqReceivedCount; }
-    uint32_t GetMaliciousDropCount () const { return m_maliciousDropCount; }
+    AodvStats GetStats () const override { return m_stats; }
+    const AodvLatencyHistogram& GetDiscoveryLatency () const { return m_discoveryLatency; }
+    /**
+     * @returns the entries and approximate bytes of the protocol state
+     */
+    AodvFootprint GetFootprint () const;
+    /**
+     * Set the time between two samples of the "Footprint" trace source
+     * @param interval the sampling interval, zero disables the sampling
+     */
+    void SetFootprintInterval(Time interval);
+    /**
+     * @returns the footprint sampling interval
+     */
+    Time GetFootprintInterval() const
+    {
+        return m_footprintInterval;
+    }
+    /**
+     * Set the time between two reports of the "Stats" trace source
+     * @param interval the report interval, zero disables the reports
+     */
+    void SetStatsInterval(Time interval);
+    /**
+     * @returns the counter report interval
+     */
+    Time GetStatsInterval() const
+    {
+        return m_statsInterval;
+    }
+    /**
+     * Set the binary log receiving the routing events of the node
+     * @param log the event log, nullptr to stop logging
+     */
+    void SetEventLog(Ptr<AodvEventLog> log);
+    /**
+     * @returns the binary event log, nullptr when logging is off
+     */
+    Ptr<AodvEventLog> GetEventLog() const
+    {
+        return m_eventLog.GetLog();
+    }
+
+    /**
+     * TracedCallback signature for completed route discoveries.
+     *
+     * @param [in] dst The destination of the discovery.
+     * @param [in] latency The time from the first RREQ to the valid route, retries included.
+     * @param [in] trustDelay The part of the latency spent holding the RREP during a trust test.
+     */
+    typedef void (*DiscoveryTracedCallback)(Ipv4Address dst, Time latency, Time trustDelay);
+    uint64_t GetRreqSentCount () const { return m_stats.rreqSent; }
+    uint64_t GetRerrSentCount () const { return m_stats.rerrSent; }
+    uint64_t GetRrepSentCount () const { return m_stats.rrepSent; }
+    uint64_t GetBrokenLinkCount () const { return m_stats.brokenLinks; }
+    uint32_t GetRreqReceivedCount () const { return m_stats.rreqReceived; }
+    uint32_t GetMaliciousDropCount () const { return m_stats.maliciousDrops; }
+    int64_t GetCompactBytesSaved () const { return m_stats.compactBytesSaved; }
 
   protected:
     void DoInitialize() override;
@@ -256,6 +311,8 @@ class RoutingProtocol : public Ipv4RoutingProtocol
                              ///< originated route discovery.
     bool m_enableHello;      ///< Indicates whether a hello messages enable
     bool m_enableBroadcast;  ///< Indicates whether a a broadcast data packets forwarding enable
+    Time m_rerrAggregationWindow; ///< Period during which link breaks are merged into one RERR
+    bool m_compactHeaders;        ///< Use the compact RREQ/RREP encoding
 
     /// IP protocol
     Ptr<Ipv4> m_ipv4;
@@ -286,12 +343,64 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     uint16_t m_rreqCount;
     /// Number of RERRs used for RERR rate control
     uint16_t m_rerrCount;
-    uint64_t m_rreqSentCount;
-    uint64_t m_rrepSentCount;
-    uint64_t m_rerrSentCount;
-    uint64_t m_brokenLinkCount;
-    uint32_t m_rreqReceivedCount;
-    uint32_t m_maliciousDropCount;
+    /// Unreachable destinations collected during the RERR aggregation window
+    std::map<Ipv4Address, uint32_t> m_pendingRerrUnreachable;
+    /// Precursors of the unreachable destinations collected during the RERR aggregation window
+    std::vector<Ipv4Address> m_pendingRerrPrecursors;
+    /// Control overhead counters
+    AodvStats m_stats;
+    /**
+     * Increment one of the control overhead counters
+     * @param counter the counter
+     */
+    void IncrementStat(uint64_t AodvStats::*counter);
+    /**
+     * Account for the bytes saved by the compact encoding of a message
+     * @param bytes the bytes saved
+     */
+    void AddCompactSavings(int64_t bytes);
+    /**
+     * Tag a control message with its category and count its bytes
+     * @param packet the control message, ready to be sent
+     * @param type the category
+     */
+    void AccountControl(Ptr<Packet> packet, AodvControlType type);
+    /// Start time of the route discoveries in progress by destination
+    std::map<Ipv4Address, Time> m_discoveryStart;
+    /// Latencies of the completed route discoveries
+    AodvLatencyHistogram m_discoveryLatency;
+    /// Trace of the completed route discoveries
+    TracedCallback<Ipv4Address, Time, Time> m_discoveryTrace;
+    /**
+     * Account for a completed route discovery
+     * @param dst the destination of the discovery
+     */
+    void RecordDiscovery(Ipv4Address dst);
+    /**
+     * Forget a route discovery which ended without a RREP
+     * @param dst the destination of the discovery
+     */
+    void AbandonDiscovery(Ipv4Address dst);
+    /// Footprint sampling interval
+    Time m_footprintInterval;
+    /// Trace of the footprint samples
+    TracedCallback<const AodvFootprint&> m_footprintTrace;
+    /// Control overhead counter report interval
+    Time m_statsInterval;
+    /// Trace of the control overhead counter reports
+    TracedCallback<const AodvStats&> m_statsTrace;
+    /// Binary event log buffer of the node
+    AodvEventBuffer m_eventLog;
+    /**
+     * Log a route which became valid or stopped being valid
+     * @param rt the routing table entry after the change
+     */
+    void NotifyRouteChange(const RoutingTableEntry& rt);
+    /**
+     * Log a link to a new neighbor
+     * @param neighbor the neighbor address
+     */
+    void NotifyNewNeighbor(Ipv4Address neighbor);
 
     bool m_isMalicious; // <--- Add this
     
@@ -459,6 +568,12 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * @param precursors list of addresses of the visited nodes
      */
     void SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> precursors);
+    /** Build and send as few RERRs as possible for a set of unreachable destinations
+     * @param unreachable unreachable destinations and their sequence numbers
+     * @param precursors list of addresses of the visited nodes
+     */
+    void SendRerrWithUnreachable(const std::map<Ipv4Address, uint32_t>& unreachable,
+                                 const std::vector<Ipv4Address>& precursors);
     /**
      * Send RERR message when no route to forward input packet. Unicast if there is reverse route to
      * originating node, broadcast otherwise.
@@ -489,6 +604,18 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     Timer m_rerrRateLimitTimer;
     /// Reset RERR count and schedule RERR rate limit timer with delay 1 sec.
     void RerrRateLimitTimerExpire();
+    /// RERR aggregation timer
+    Timer m_rerrAggregationTimer;
+    /// Send the RERRs for all link breaks collected during the aggregation window.
+    void RerrAggregationTimerExpire();
+    /// Footprint sampling timer
+    Timer m_footprintTimer;
+    /// Report the footprint of the protocol state and schedule the next sample
+    void FootprintTimerExpire();
+    /// Control overhead counter report timer
+    Timer m_statsTimer;
+    /// Report the control overhead counters and schedule the next report
+    void StatsTimerExpire();
     /// Map IP address + RREQ timer.
     std::map<Ipv4Address, Timer> m_addressReqTimer;
     /**
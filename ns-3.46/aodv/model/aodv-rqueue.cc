@@ -36,6 +36,19 @@ RequestQueue::GetSize()
     return m_queue.size();
 }
 
+AodvMemoryUsage
+RequestQueue::GetMemoryUsage() const
+{
+    AodvMemoryUsage usage;
+    usage.entries = m_queue.size();
+    usage.bytes = m_queue.capacity() * sizeof(QueueEntry);
+    for (const auto& entry : m_queue)
+    {
+        usage.bytes += entry.GetPacket()->GetSize();
+    }
+    return usage;
+}
+
 bool
 RequestQueue::Enqueue(QueueEntry& entry)
 {
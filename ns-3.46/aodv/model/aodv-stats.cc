@@ -0,0 +1,314 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "aodv-stats.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+const char*
+AodvControlTypeName(AodvControlType type)
+{
+    switch (type)
+    {
+    case AODV_CONTROL_RREQ:
+        return "rreq";
+    case AODV_CONTROL_RREP:
+        return "rrep";
+    case AODV_CONTROL_RERR:
+        return "rerr";
+    case AODV_CONTROL_RREP_ACK:
+        return "rrepAck";
+    case AODV_CONTROL_HELLO:
+        return "hello";
+    case AODV_CONTROL_TRUST_TEST:
+        return "trustTest";
+    default:
+        return "unknown";
+    }
+}
+
+NS_OBJECT_ENSURE_REGISTERED(AodvControlTag);
+
+AodvControlTag::AodvControlTag(AodvControlType type)
+    : Tag(),
+      m_type(type)
+{
+}
+
+TypeId
+AodvControlTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::AodvControlTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("Aodv")
+                            .AddConstructor<AodvControlTag>();
+    return tid;
+}
+
+TypeId
+AodvControlTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+AodvControlTag::GetSerializedSize() const
+{
+    return sizeof(uint8_t);
+}
+
+void
+AodvControlTag::Serialize(TagBuffer i) const
+{
+    i.WriteU8(m_type);
+}
+
+void
+AodvControlTag::Deserialize(TagBuffer i)
+{
+    m_type = static_cast<AodvControlType>(i.ReadU8());
+}
+
+void
+AodvControlTag::Print(std::ostream& os) const
+{
+    os << "AodvControlTag: " << AodvControlTypeName(m_type);
+}
+
+AodvStats&
+AodvStats::operator+=(const AodvStats& o)
+{
+    rreqSent += o.rreqSent;
+    rrepSent += o.rrepSent;
+    rerrSent += o.rerrSent;
+    brokenLinks += o.brokenLinks;
+    rreqReceived += o.rreqReceived;
+    maliciousDrops += o.maliciousDrops;
+    compactBytesSaved += o.compactBytesSaved;
+    for (uint32_t i = 0; i < AODV_CONTROL_TYPES; ++i)
+    {
+        controlBytes[i] += o.controlBytes[i];
+    }
+    return *this;
+}
+
+bool
+operator==(const AodvStats& a, const AodvStats& b)
+{
+    return a.rreqSent == b.rreqSent && a.rrepSent == b.rrepSent && a.rerrSent == b.rerrSent &&
+           a.brokenLinks == b.brokenLinks && a.rreqReceived == b.rreqReceived &&
+           a.maliciousDrops == b.maliciousDrops && a.compactBytesSaved == b.compactBytesSaved &&
+           a.controlBytes == b.controlBytes;
+}
+
+bool
+operator!=(const AodvStats& a, const AodvStats& b)
+{
+    return !(a == b);
+}
+
+std::ostream&
+operator<<(std::ostream& os, const AodvStats& s)
+{
+    os << "RREQ sent " << s.rreqSent << " RREP sent " << s.rrepSent << " RERR sent " << s.rerrSent
+       << " broken links " << s.brokenLinks << " RREQ received " << s.rreqReceived
+       << " malicious drops " << s.maliciousDrops << " compact bytes saved "
+       << s.compactBytesSaved;
+    for (uint32_t i = 0; i < AODV_CONTROL_TYPES; ++i)
+    {
+        os << " " << AodvControlTypeName(static_cast<AodvControlType>(i)) << " bytes "
+           << s.controlBytes[i];
+    }
+    return os;
+}
+
+const char*
+AodvStateStructureName(AodvStateStructure structure)
+{
+    switch (structure)
+    {
+    case AODV_STATE_ROUTES:
+        return "routes";
+    case AODV_STATE_NEIGHBORS:
+        return "neighbors";
+    case AODV_STATE_REQUEST_QUEUE:
+        return "requestQueue";
+    case AODV_STATE_RREQ_ID_CACHE:
+        return "rreqIdCache";
+    case AODV_STATE_DPD:
+        return "dpd";
+    case AODV_STATE_ADDRESS_REQ_TIMERS:
+        return "addressReqTimers";
+    case AODV_STATE_TRUST_TABLE:
+        return "trustTable";
+    case AODV_STATE_PENDING_TRUST_PACKETS:
+        return "pendingTrustPackets";
+    case AODV_STATE_SEQNO_MODELS:
+        return "seqnoModels";
+    default:
+        return "unknown";
+    }
+}
+
+AodvMemoryUsage&
+AodvMemoryUsage::operator+=(const AodvMemoryUsage& o)
+{
+    entries += o.entries;
+    bytes += o.bytes;
+    return *this;
+}
+
+AodvFootprint&
+AodvFootprint::operator+=(const AodvFootprint& o)
+{
+    for (uint32_t i = 0; i < AODV_STATE_STRUCTURES; ++i)
+    {
+        usage[i] += o.usage[i];
+    }
+    return *this;
+}
+
+uint64_t
+AodvFootprint::GetTotalBytes() const
+{
+    uint64_t total = 0;
+    for (const auto& u : usage)
+    {
+        total += u.bytes;
+    }
+    return total;
+}
+
+void
+AodvTrustAccuracy::Add(bool rejected, bool malicious)
+{
+    if (malicious)
+    {
+        ++(rejected ? truePositives : falseNegatives);
+    }
+    else
+    {
+        ++(rejected ? falsePositives : trueNegatives);
+    }
+}
+
+AodvTrustAccuracy&
+AodvTrustAccuracy::operator+=(const AodvTrustAccuracy& o)
+{
+    truePositives += o.truePositives;
+    falsePositives += o.falsePositives;
+    trueNegatives += o.trueNegatives;
+    falseNegatives += o.falseNegatives;
+    return *this;
+}
+
+uint64_t
+AodvTrustAccuracy::GetCount() const
+{
+    return truePositives + falsePositives + trueNegatives + falseNegatives;
+}
+
+double
+AodvTrustAccuracy::GetTruePositiveRate() const
+{
+    uint64_t malicious = truePositives + falseNegatives;
+    return (malicious == 0) ? 0 : static_cast<double>(truePositives) / malicious;
+}
+
+double
+AodvTrustAccuracy::GetFalsePositiveRate() const
+{
+    uint64_t benign = falsePositives + trueNegatives;
+    return (benign == 0) ? 0 : static_cast<double>(falsePositives) / benign;
+}
+
+void
+AodvLatencyHistogram::Add(Time latency)
+{
+    uint32_t bucket = 0;
+    while (bucket < N_BUCKETS - 1 && latency >= GetBucketUpperBound(bucket))
+    {
+        ++bucket;
+    }
+    ++m_buckets[bucket];
+    ++m_count;
+    m_total += latency;
+    m_max = std::max(m_max, latency);
+}
+
+AodvLatencyHistogram&
+AodvLatencyHistogram::operator+=(const AodvLatencyHistogram& o)
+{
+    for (uint32_t i = 0; i < N_BUCKETS; ++i)
+    {
+        m_buckets[i] += o.m_buckets[i];
+    }
+    m_count += o.m_count;
+    m_total += o.m_total;
+    m_max = std::max(m_max, o.m_max);
+    return *this;
+}
+
+Time
+AodvLatencyHistogram::GetMean() const
+{
+    return (m_count == 0) ? Time() : m_total / static_cast<int64_t>(m_count);
+}
+
+Time
+AodvLatencyHistogram::GetBucketUpperBound(uint32_t bucket)
+{
+    if (bucket >= N_BUCKETS - 1)
+    {
+        return Time::Max();
+    }
+    return MilliSeconds(int64_t(1) << bucket);
+}
+
+Time
+AodvLatencyHistogram::GetQuantile(double q) const
+{
+    if (m_count == 0)
+    {
+        return Time();
+    }
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(q * m_count + 0.5));
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < N_BUCKETS; ++i)
+    {
+        seen += m_buckets[i];
+        if (seen >= rank)
+        {
+            return std::min(GetBucketUpperBound(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+void
+AodvLatencyHistogram::Print(std::ostream& os) const
+{
+    Time lower;
+    for (uint32_t i = 0; i < N_BUCKETS; ++i)
+    {
+        if (m_buckets[i] > 0)
+        {
+            os << "[" << lower.As(Time::MS) << ", ";
+            if (i == N_BUCKETS - 1)
+            {
+                os << "inf";
+            }
+            else
+            {
+                os << GetBucketUpperBound(i).As(Time::MS);
+            }
+            os << ") " << m_buckets[i] << std::endl;
+        }
+        lower = GetBucketUpperBound(i);
+    }
+}
+
+} // namespace ns3
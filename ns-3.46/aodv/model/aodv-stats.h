@@ -0,0 +1,352 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef AODV_STATS_H
+#define AODV_STATS_H
+
+#include "ns3/nstime.h"
+#include "ns3/tag.h"
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+
+namespace ns3
+{
+/**
+ * @ingroup aodv
+ * @brief Categories of control messages in the overhead accounting.
+ */
+enum AodvControlType : uint8_t
+{
+    AODV_CONTROL_RREQ,       //!< Route request
+    AODV_CONTROL_RREP,       //!< Route reply, HELLO messages excluded
+    AODV_CONTROL_RERR,       //!< Route error
+    AODV_CONTROL_RREP_ACK,   //!< Route reply acknowledgment
+    AODV_CONTROL_HELLO,      //!< HELLO message
+    AODV_CONTROL_TRUST_TEST, //!< TPAODV trust test request
+    AODV_CONTROL_TYPES,      //!< Number of categories
+};
+
+/**
+ * @param type the control message category
+ * @returns the lowercase name of the category
+ */
+const char* AodvControlTypeName(AodvControlType type);
+
+/**
+ * @ingroup aodv
+ * @brief Packet tag marking the category of a control message.
+ *
+ * The routing protocols tag the control messages they send so that the transmissions can be
+ * attributed to a category further down the stack, MAC retries included.
+ */
+class AodvControlTag : public Tag
+{
+  public:
+    /**
+     * @brief Constructor
+     * @param type the control message category
+     */
+    AodvControlTag(AodvControlType type = AODV_CONTROL_TYPES);
+
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    /**
+     * @returns the control message category
+     */
+    AodvControlType GetControlType() const
+    {
+        return m_type;
+    }
+
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+  private:
+    /// Control message category
+    AodvControlType m_type;
+};
+
+/**
+ * @ingroup aodv
+ * @brief Control overhead counters of a node.
+ *
+ * Shared by the AODV, PAODV and TPAODV routing protocols, which expose it through
+ * AodvStatsSource so that AodvStatsHelper can read any of them, and report it periodically
+ * through their "Stats" trace source.
+ */
+struct AodvStats
+{
+    uint64_t rreqSent{0};         ///< RREQ messages sent
+    uint64_t rrepSent{0};         ///< RREP messages sent, HELLO messages excluded
+    uint64_t rerrSent{0};         ///< RERR messages sent
+    uint64_t brokenLinks{0};      ///< Link breaks detected
+    uint64_t rreqReceived{0};     ///< RREQ messages received
+    uint64_t maliciousDrops{0};   ///< Data packets dropped by a blackhole node
+    int64_t compactBytesSaved{0}; ///< Bytes saved by the compact RREQ/RREP encoding
+    /// Serialized bytes of the control messages sent, by AodvControlType, one count per
+    /// unicast copy and per interface of a broadcast
+    std::array<uint64_t, AODV_CONTROL_TYPES> controlBytes{};
+
+    /**
+     * Add the counters of another node
+     * @param o the other counters
+     * @return this
+     */
+    AodvStats& operator+=(const AodvStats& o);
+
+    /**
+     * TracedCallback signature
+     *
+     * @param [in] stats The counters of the node.
+     */
+    typedef void (*TracedCallback)(const AodvStats& stats);
+};
+
+/**
+ * @brief Equality operator
+ * @param a the first counters
+ * @param b the second counters
+ * @return true if all counters are equal
+ */
+bool operator==(const AodvStats& a, const AodvStats& b);
+/**
+ * @brief Inequality operator
+ * @param a the first counters
+ * @param b the second counters
+ * @return true if any counter differs
+ */
+bool operator!=(const AodvStats& a, const AodvStats& b);
+
+/**
+ * @brief Stream output operator
+ * @param os output stream
+ * @param s the counters
+ * @return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const AodvStats& s);
+
+/**
+ * @ingroup aodv
+ * @brief Routing protocol counting its control overhead in an AodvStats.
+ *
+ * The counters are plain members bumped on the packet path, they are only copied when read.
+ */
+class AodvStatsSource
+{
+  public:
+    virtual ~AodvStatsSource() = default;
+
+    /**
+     * @returns the control overhead counters of the node
+     */
+    virtual AodvStats GetStats() const = 0;
+};
+
+/**
+ * @ingroup aodv
+ * @brief Structures of the protocol state covered by AodvFootprint.
+ */
+enum AodvStateStructure : uint8_t
+{
+    AODV_STATE_ROUTES,                //!< Routing table entries
+    AODV_STATE_NEIGHBORS,             //!< Neighbor entries
+    AODV_STATE_REQUEST_QUEUE,         //!< Packets waiting for a route
+    AODV_STATE_RREQ_ID_CACHE,         //!< RREQ ID cache entries
+    AODV_STATE_DPD,                   //!< Duplicate packet detection entries
+    AODV_STATE_ADDRESS_REQ_TIMERS,    //!< Route discovery timers
+    AODV_STATE_TRUST_TABLE,           //!< TPAODV trust table entries
+    AODV_STATE_PENDING_TRUST_PACKETS, //!< TPAODV RREPs held during trust tests
+    AODV_STATE_SEQNO_MODELS,          //!< TPAODV sequence number growth models
+    AODV_STATE_STRUCTURES,            //!< Number of structures
+};
+
+/**
+ * @param structure the state structure
+ * @returns the lowercase name of the structure
+ */
+const char* AodvStateStructureName(AodvStateStructure structure);
+
+/**
+ * @ingroup aodv
+ * @brief Entries and approximate bytes of one state structure.
+ */
+struct AodvMemoryUsage
+{
+    /// Approximate bookkeeping bytes of one node of a std::map or std::unordered_map
+    static const uint64_t NODE_OVERHEAD = 32;
+
+    uint64_t entries{0}; ///< Number of entries
+    uint64_t bytes{0};   ///< Approximate heap bytes, packet payloads included
+
+    /**
+     * Add the usage of another structure
+     * @param o the other usage
+     * @return this
+     */
+    AodvMemoryUsage& operator+=(const AodvMemoryUsage& o);
+};
+
+/**
+ * @ingroup aodv
+ * @brief Memory footprint of the state of a node, by structure.
+ *
+ * The bytes are estimated from the element sizes and container capacities, they leave out
+ * allocator overhead and memory shared with other nodes. Structures a protocol does not have
+ * stay empty.
+ */
+struct AodvFootprint
+{
+    /// Usage by AodvStateStructure
+    std::array<AodvMemoryUsage, AODV_STATE_STRUCTURES> usage{};
+
+    /**
+     * Add the footprint of another node
+     * @param o the other footprint
+     * @return this
+     */
+    AodvFootprint& operator+=(const AodvFootprint& o);
+    /**
+     * @returns the approximate bytes of all structures
+     */
+    uint64_t GetTotalBytes() const;
+
+    /**
+     * TracedCallback signature
+     *
+     * @param [in] footprint The footprint of the node.
+     */
+    typedef void (*TracedCallback)(const AodvFootprint& footprint);
+};
+
+/**
+ * @ingroup aodv
+ * @brief Log-scale histogram of route discovery latencies.
+ *
+ * Bucket 0 counts latencies below 1 ms, bucket k counts latencies in [2^(k-1), 2^k) ms and the
+ * last bucket counts everything from 2^(N_BUCKETS-2) ms on, about 4 minutes.
+ */
+class AodvLatencyHistogram
+{
+  public:
+    /// Number of buckets
+    static const uint32_t N_BUCKETS = 20;
+
+    /**
+     * Count one latency
+     * @param latency the latency
+     */
+    void Add(Time latency);
+    /**
+     * Add the latencies of another histogram
+     * @param o the other histogram
+     * @return this
+     */
+    AodvLatencyHistogram& operator+=(const AodvLatencyHistogram& o);
+
+    /**
+     * @returns the number of latencies counted
+     */
+    uint64_t GetCount() const
+    {
+        return m_count;
+    }
+
+    /**
+     * @returns the mean latency, zero if none was counted
+     */
+    Time GetMean() const;
+
+    /**
+     * @returns the largest latency counted
+     */
+    Time GetMax() const
+    {
+        return m_max;
+    }
+
+    /**
+     * @param bucket the bucket index
+     * @returns the number of latencies in the bucket
+     */
+    uint64_t GetBucketCount(uint32_t bucket) const
+    {
+        return m_buckets[bucket];
+    }
+
+    /**
+     * @param bucket the bucket index
+     * @returns the exclusive upper bound of the bucket, Time::Max () for the last one
+     */
+    static Time GetBucketUpperBound(uint32_t bucket);
+    /**
+     * Estimate a quantile from the buckets
+     * @param q the quantile, between 0 and 1
+     * @returns the upper bound of the bucket holding the quantile, capped by the largest latency
+     */
+    Time GetQuantile(double q) const;
+    /**
+     * Print the non-empty buckets
+     * @param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    std::array<uint64_t, N_BUCKETS> m_buckets{}; ///< Latencies per bucket
+    uint64_t m_count{0};                         ///< Number of latencies
+    Time m_total;                                ///< Sum of the latencies
+    Time m_max;                                  ///< Largest latency
+};
+
+/**
+ * @ingroup aodv
+ * @brief Confusion matrix of trust verdicts against the actual behavior of the nodes.
+ *
+ * A positive verdict judges the node malicious.
+ */
+struct AodvTrustAccuracy
+{
+    uint64_t truePositives{0};  ///< Malicious nodes rejected
+    uint64_t falsePositives{0}; ///< Benign nodes rejected
+    uint64_t trueNegatives{0};  ///< Benign nodes trusted
+    uint64_t falseNegatives{0}; ///< Malicious nodes trusted
+
+    /**
+     * Count one verdict
+     * @param rejected whether the verdict judged the node malicious
+     * @param malicious whether the node is malicious
+     */
+    void Add(bool rejected, bool malicious);
+    /**
+     * Add the verdicts of another matrix
+     * @param o the other matrix
+     * @return this
+     */
+    AodvTrustAccuracy& operator+=(const AodvTrustAccuracy& o);
+    /**
+     * @returns the number of verdicts counted
+     */
+    uint64_t GetCount() const;
+    /**
+     * @returns the share of the verdicts about malicious nodes which rejected them, zero if
+     *          there was none
+     */
+    double GetTruePositiveRate() const;
+    /**
+     * @returns the share of the verdicts about benign nodes which rejected them, zero if there
+     *          was none
+     */
+    double GetFalsePositiveRate() const;
+};
+
+} // namespace ns3
+
+#endif /* AODV_STATS_H */
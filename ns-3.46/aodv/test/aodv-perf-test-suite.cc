@@ -0,0 +1,30 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "aodv-perf-test.h"
+
+#include "ns3/aodv-helper.h"
+
+using namespace ns3;
+
+AODV_PERF_COUNT_ALLOCATIONS()
+
+/**
+ * @ingroup aodv-test
+ *
+ * @brief AODV performance regression test suite
+ */
+class AodvPerfTestSuite : public TestSuite
+{
+  public:
+    AodvPerfTestSuite()
+        : TestSuite("routing-aodv-performance", Type::PERFORMANCE)
+    {
+        SetDataDir(NS_TEST_SOURCEDIR);
+        AddTestCase(new AodvPerfTest<AodvHelper>("AODV", "grid-5x5", 5, 5, Seconds(30)),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new AodvPerfTest<AodvHelper>("AODV", "grid-10x10", 10, 20, Seconds(30)),
+                    TestCase::Duration::EXTENSIVE);
+    }
+} g_aodvPerfTestSuite; ///< the test suite
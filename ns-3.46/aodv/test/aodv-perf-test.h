@@ -0,0 +1,315 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#ifndef AODV_PERF_TEST_H
+#define AODV_PERF_TEST_H
+
+#include "ns3/aodv-stats-helper.h"
+#include "ns3/double.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/udp-echo-helper.h"
+#include "ns3/uinteger.h"
+#include "ns3/yans-wifi-helper.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <set>
+#include <sstream>
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * @ingroup aodv-test
+ * Number of calls to the global operator new made while g_aodvPerfCounting is set
+ */
+inline std::atomic<uint64_t> g_aodvPerfAllocations{0};
+/**
+ * @ingroup aodv-test
+ * Whether allocations are counted, only during the Simulator::Run of an AodvPerfTest
+ */
+inline std::atomic<bool> g_aodvPerfCounting{false};
+
+} // namespace ns3
+
+/**
+ * Replace the global operator new and operator delete to count the allocations of AodvPerfTest.
+ * Each performance suite expands it once at namespace scope. The definitions are weak, so that
+ * a test runner with several of these suites, shared or static, keeps exactly one of them; the
+ * other forms of operator new and operator delete forward to these.
+ */
+#define AODV_PERF_COUNT_ALLOCATIONS()                                                            \
+    __attribute__((weak)) void* operator new(std::size_t size)                                   \
+    {                                                                                            \
+        if (ns3::g_aodvPerfCounting.load(std::memory_order_relaxed))                             \
+        {                                                                                        \
+            ns3::g_aodvPerfAllocations.fetch_add(1, std::memory_order_relaxed);                  \
+        }                                                                                        \
+        if (void* p = std::malloc(size ? size : 1))                                              \
+        {                                                                                        \
+            return p;                                                                            \
+        }                                                                                        \
+        throw std::bad_alloc();                                                                  \
+    }                                                                                            \
+    __attribute__((weak)) void operator delete(void* p) noexcept                                 \
+    {                                                                                            \
+        std::free(p);                                                                            \
+    }                                                                                            \
+    __attribute__((weak)) void operator delete(void* p, std::size_t) noexcept                    \
+    {                                                                                            \
+        std::free(p);                                                                            \
+    }
+
+namespace ns3
+{
+
+/**
+ * @ingroup aodv-test
+ * @brief Measured value and relative tolerance of a performance metric
+ */
+struct AodvPerfMetric
+{
+    double value;     ///< Measured or baseline value
+    double tolerance; ///< Allowed relative increase over the baseline
+};
+
+/**
+ * @ingroup aodv-test
+ * @brief Performance regression test of AODV, PAODV or TPAODV
+ *
+ * Runs a fixed-seed grid scenario with UDP echo flows over the routing protocol installed by
+ * RoutingHelper and measures the wall-clock time of Simulator::Run, the simulator events
+ * processed, the heap allocations made during the run and the control messages and bytes sent.
+ * The results are compared with the baseline stored in <protocol>-perf-<name>.txt, one "metric
+ * value tolerance" line per metric, and the test fails when a metric exceeds
+ * value * (1 + tolerance).
+ *
+ * Event and control counts are deterministic: they get tight tolerances and their baseline is
+ * required. The allocation count depends on the C++ library and the wall-clock time on the
+ * machine, they are checked only once their baseline is recorded, the latter only catching
+ * gross slowdowns. Allocations are counted by the operator new of AODV_PERF_COUNT_ALLOCATIONS.
+ *
+ * Running the suite with --update-data records the measured values as the new baseline and
+ * keeps the tolerances of the previous one. The suites are only built when configured with
+ * -DNS3_AODV_PERF_TESTS=ON, until their baselines are recorded on the reference machine.
+ */
+template <class RoutingHelper>
+class AodvPerfTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     * @param protocol protocol name, such as "TPAODV", lowercased for the baseline file
+     * @param name scenario name, used for the baseline file
+     * @param width the nodes stand on a width x width grid
+     * @param flows number of UDP echo flows
+     * @param time simulated time
+     */
+    AodvPerfTest(std::string protocol, std::string name, uint32_t width, uint32_t flows, Time time)
+        : TestCase(protocol + " performance: " + name),
+          m_protocol(protocol),
+          m_name(name),
+          m_width(width),
+          m_flows(flows),
+          m_time(time)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Read a baseline file
+     * @param filename the file name
+     * @returns the metrics of the file, by name
+     */
+    std::map<std::string, AodvPerfMetric> ReadBaseline(const std::string& filename) const;
+
+    std::string m_protocol; ///< Protocol name
+    std::string m_name;     ///< Scenario name
+    uint32_t m_width;       ///< Grid width
+    uint32_t m_flows;       ///< Number of UDP echo flows
+    Time m_time;            ///< Simulated time
+};
+
+template <class RoutingHelper>
+std::map<std::string, AodvPerfMetric>
+AodvPerfTest<RoutingHelper>::ReadBaseline(const std::string& filename) const
+{
+    std::map<std::string, AodvPerfMetric> metrics;
+    std::ifstream in(filename);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream fields(line);
+        std::string name;
+        AodvPerfMetric metric;
+        if (fields >> name >> metric.value >> metric.tolerance)
+        {
+            metrics[name] = metric;
+        }
+    }
+    return metrics;
+}
+
+template <class RoutingHelper>
+void
+AodvPerfTest<RoutingHelper>::DoRun()
+{
+    RngSeedManager::SetSeed(12345);
+    RngSeedManager::SetRun(7);
+
+    uint32_t size = m_width * m_width;
+    NodeContainer nodes;
+    nodes.Create(size);
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                  "DeltaX",
+                                  DoubleValue(100),
+                                  "DeltaY",
+                                  DoubleValue(100),
+                                  "GridWidth",
+                                  UintegerValue(m_width),
+                                  "LayoutType",
+                                  StringValue("RowFirst"));
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(nodes);
+
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, nodes);
+
+    RoutingHelper routing;
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(routing);
+    internetStack.Install(nodes);
+    int64_t streamsUsed = WifiHelper::AssignStreams(devices, 0);
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+    streamsUsed += internetStack.AssignStreams(nodes, streamsUsed);
+    routing.AssignStreams(nodes, streamsUsed);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.0.0", "255.255.0.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // Flows cross the grid, from the first row to the last one
+    UdpEchoServerHelper server(9);
+    ApplicationContainer apps = server.Install(nodes);
+    for (uint32_t i = 0; i < m_flows; ++i)
+    {
+        uint32_t src = i % m_width;
+        uint32_t dst = size - 1 - (i * 3) % m_width;
+        UdpEchoClientHelper client(interfaces.GetAddress(dst), 9);
+        client.SetAttribute("MaxPackets", UintegerValue(1000));
+        client.SetAttribute("Interval", TimeValue(Seconds(0.5)));
+        client.SetAttribute("PacketSize", UintegerValue(512));
+        ApplicationContainer c = client.Install(nodes.Get(src));
+        c.Start(Seconds(1 + 0.1 * i));
+        apps.Add(c);
+    }
+    apps.Stop(m_time);
+
+    AodvStatsHelper stats;
+    stats.Install(nodes);
+
+    Simulator::Stop(m_time);
+    g_aodvPerfAllocations.store(0, std::memory_order_relaxed);
+    g_aodvPerfCounting.store(true, std::memory_order_relaxed);
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto end = std::chrono::steady_clock::now();
+    g_aodvPerfCounting.store(false, std::memory_order_relaxed);
+    uint64_t allocations = g_aodvPerfAllocations.load(std::memory_order_relaxed);
+
+    AodvStats total = stats.GetTotal();
+    uint64_t controlBytes = 0;
+    for (uint64_t bytes : total.controlBytes)
+    {
+        controlBytes += bytes;
+    }
+    std::map<std::string, AodvPerfMetric> measured = {
+        {"wallMs", {std::chrono::duration<double, std::milli>(end - start).count(), 1.0}},
+        {"events", {static_cast<double>(Simulator::GetEventCount()), 0.02}},
+        {"allocations", {static_cast<double>(allocations), 0.05}},
+        {"controlPackets",
+         {static_cast<double>(total.rreqSent + total.rrepSent + total.rerrSent), 0.02}},
+        {"controlBytes", {static_cast<double>(controlBytes), 0.02}},
+    };
+    Simulator::Destroy();
+
+    std::string prefix = m_protocol;
+    std::transform(prefix.begin(), prefix.end(), prefix.begin(), [](unsigned char c) {
+        return std::tolower(c);
+    });
+    std::string filename = prefix + "-perf-" + m_name + ".txt";
+    std::string baselineFile = CreateDataDirFilename(filename);
+    std::string outputFile = CreateTempDirFilename(filename);
+    std::map<std::string, AodvPerfMetric> baseline = ReadBaseline(baselineFile);
+
+    // With --update-data the temporary file is the baseline itself
+    if (outputFile != baselineFile)
+    {
+        const std::set<std::string> required = {"events", "controlPackets", "controlBytes"};
+        for (const auto& [name, metric] : measured)
+        {
+            auto i = baseline.find(name);
+            bool recorded = (i != baseline.end() && i->second.value > 0);
+            if (!recorded)
+            {
+                NS_TEST_EXPECT_MSG_EQ((required.count(name) == 0),
+                                      true,
+                                      m_name << ": no baseline for " << name << ", measured "
+                                             << metric.value << "; record it with --update-data");
+                continue;
+            }
+            double limit = i->second.value * (1 + i->second.tolerance);
+            NS_TEST_EXPECT_MSG_LT_OR_EQ(metric.value,
+                                        limit,
+                                        m_name << ": " << name << " regressed from baseline "
+                                               << i->second.value);
+        }
+    }
+
+    std::ofstream out(outputFile);
+    out << std::setprecision(12);
+    out << "# " << m_protocol << " performance baseline of the " << m_name << " scenario"
+        << std::endl
+        << "# metric value tolerance" << std::endl;
+    for (const auto& [name, metric] : measured)
+    {
+        auto i = baseline.find(name);
+        double tolerance = (i == baseline.end()) ? metric.tolerance : i->second.tolerance;
+        out << name << " " << metric.value << " " << tolerance << std::endl;
+    }
+}
+
+} // namespace ns3
+
+#endif /* AODV_PERF_TEST_H */
@@ -5,12 +5,19 @@
  *
  * Authors: Pavel Boyko <boyko@iitp.ru>
  */
+#include "ns3/aodv-event-log.h"
+#include "ns3/aodv-id-cache.h"
 #include "ns3/aodv-neighbor.h"
 #include "ns3/aodv-packet.h"
 #include "ns3/aodv-rqueue.h"
+#include "ns3/aodv-routing-protocol.h"
 #include "ns3/aodv-rtable.h"
+#include "ns3/aodv-stats.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <fstream>
 
 namespace ns3
 {
@@ -205,6 +212,27 @@ struct RreqHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, 23, "RREP is 23 bytes long");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 0, "Nothing saved by the RFC encoding");
+
+        h.SetCompact(true);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RreqHeader h3;
+        h3.SetCompact(true);
+        bytes = p->RemoveHeader(h3);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 12, "Compact RREQ with small fields is 12 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 11, "Compact RREQ saves 11 bytes");
+        NS_TEST_EXPECT_MSG_EQ(h, h3, "Compact round trip serialization works");
+
+        h.SetHopCount(20);
+        h.SetId(0xffffffff);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RreqHeader h4;
+        h4.SetCompact(true);
+        bytes = p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 19, "Long hop count and ID need the extension");
+        NS_TEST_EXPECT_MSG_EQ(h, h4, "Compact round trip serialization works");
     }
 };
 
@@ -262,6 +290,49 @@ struct RrepHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, 19, "RREP is 19 bytes long");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+
+        h.SetCompact(true);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h3;
+        h3.SetCompact(true);
+        bytes = p->RemoveHeader(h3);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 12, "Compact HELLO is 12 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 7, "Compact HELLO saves 7 bytes");
+        NS_TEST_EXPECT_MSG_EQ(h, h3, "Compact round trip serialization works");
+
+        h.SetAckRequired(true);
+        h.SetLifeTime(MilliSeconds(1250));
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h4;
+        h4.SetCompact(true);
+        p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(h4.GetAckRequired(), true, "A flag survives the compact encoding");
+        NS_TEST_EXPECT_MSG_EQ(h4.GetLifeTime(),
+                              MilliSeconds(1300),
+                              "Compact lifetime is rounded up to 100 ms");
+
+        h.SetLifeTime(MilliSeconds(UINT32_MAX - 50));
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h6;
+        h6.SetCompact(true);
+        bytes = p->RemoveHeader(h6);
+        NS_TEST_EXPECT_MSG_EQ(bytes, h.GetSerializedSize(), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h6.GetLifeTime(),
+                              MilliSeconds(UINT32_MAX / 100 * 100),
+                              "Compact lifetime near 2^32 ms is rounded down");
+
+        h.SetPrefixSize(8);
+        h.SetHopCount(100);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h5;
+        h5.SetCompact(true);
+        p->RemoveHeader(h5);
+        NS_TEST_EXPECT_MSG_EQ(h5.GetPrefixSize(), 8, "Prefix size needs the extension");
+        NS_TEST_EXPECT_MSG_EQ(h5.GetHopCount(), 100, "Long hop count needs the extension");
     }
 };
 
@@ -320,6 +391,35 @@ struct RerrHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, h.GetSerializedSize(), "(De)Serialized size match");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+
+        std::pair<Ipv4Address, uint32_t> un;
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(un.first, dst2, "Destinations are kept in address order");
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(un.first, dst, "Destinations are kept in address order");
+        NS_TEST_EXPECT_MSG_EQ(un.second, 12, "Duplicate destination keeps first seqno");
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), false, "Header is empty");
+
+        RerrHeader h3;
+        for (uint32_t k = 255; k > 0; --k)
+        {
+            NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address(0x0a000000 + k), k),
+                                  true,
+                                  "trivial");
+        }
+        NS_TEST_EXPECT_MSG_EQ(h3.GetDestCount(), 255, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address("10.0.1.0"), 1),
+                              false,
+                              "No more than 255 destinations");
+        NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address("10.0.0.1"), 1),
+                              true,
+                              "Duplicate of a present destination is accepted");
+        p = Create<Packet>();
+        p->AddHeader(h3);
+        RerrHeader h4;
+        bytes = p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 3 + 8 * 255, "(De)Serialized size match");
+        NS_TEST_EXPECT_MSG_EQ(h3, h4, "Round trip serialization works");
     }
 };
 
@@ -719,6 +819,249 @@ struct AodvRtableTest : public TestCase
     }
 };
 
+/**
+ * @ingroup aodv-test
+ *
+ * @brief Unit test for the control overhead counters
+ */
+struct AodvStatsTest : public TestCase
+{
+    AodvStatsTest()
+        : TestCase("Stats"),
+          m_reports(0)
+    {
+    }
+
+    /// Number of reports of the "Stats" trace source
+    uint32_t m_reports;
+
+    /**
+     * Count a report of the "Stats" trace source
+     * @param stats the reported counters
+     */
+    void StatsReport(const AodvStats& stats)
+    {
+        ++m_reports;
+    }
+
+    void DoRun() override
+    {
+        AodvStats s;
+        ++s.rreqSent;
+        s.compactBytesSaved -= 3;
+
+        AodvStats total;
+        total += s;
+        total += s;
+        NS_TEST_EXPECT_MSG_EQ(total.rreqSent, 2, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(total.compactBytesSaved, -6, "trivial");
+        NS_TEST_EXPECT_MSG_EQ((total == s), false, "trivial");
+        NS_TEST_EXPECT_MSG_EQ((total == total), true, "trivial");
+
+        s.controlBytes[AODV_CONTROL_HELLO] = 20;
+        total += s;
+        NS_TEST_EXPECT_MSG_EQ(total.controlBytes[AODV_CONTROL_HELLO], 20, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(total.controlBytes[AODV_CONTROL_RREQ], 0, "trivial");
+
+        Ptr<Packet> p = Create<Packet>(10);
+        p->AddPacketTag(AodvControlTag(AODV_CONTROL_TRUST_TEST));
+        AodvControlTag tag;
+        NS_TEST_EXPECT_MSG_EQ(p->Copy()->PeekPacketTag(tag), true, "Tag follows copies");
+        NS_TEST_EXPECT_MSG_EQ(tag.GetControlType(), AODV_CONTROL_TRUST_TEST, "trivial");
+
+        // AodvStatsHelper reads the counters through AodvStatsSource
+        Ptr<Ipv4RoutingProtocol> protocol = CreateObject<RoutingProtocol>();
+        auto source = dynamic_cast<const AodvStatsSource*>(PeekPointer(protocol));
+        NS_TEST_ASSERT_MSG_NE(source, nullptr, "AODV exposes its counters");
+        NS_TEST_EXPECT_MSG_EQ((source->GetStats() == AodvStats()), true, "No message sent yet");
+
+        // The counters are also reported periodically through the "Stats" trace source
+        protocol->TraceConnectWithoutContext("Stats",
+                                             MakeCallback(&AodvStatsTest::StatsReport, this));
+        protocol->SetAttribute("StatsInterval", TimeValue(Seconds(1)));
+        Simulator::Stop(Seconds(2.5));
+        Simulator::Run();
+        Simulator::Destroy();
+        NS_TEST_EXPECT_MSG_EQ(m_reports, 2, "One report per interval");
+    }
+};
+
+/// Unit test for AodvLatencyHistogram
+struct AodvLatencyHistogramTest : public TestCase
+{
+    AodvLatencyHistogramTest()
+        : TestCase("LatencyHistogram")
+    {
+    }
+
+    void DoRun() override
+    {
+        AodvLatencyHistogram h;
+        NS_TEST_EXPECT_MSG_EQ(h.GetCount(), 0, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h.GetMean(), Time(), "Empty histogram has no mean");
+        NS_TEST_EXPECT_MSG_EQ(h.GetQuantile(0.5), Time(), "Empty histogram has no quantile");
+
+        h.Add(MicroSeconds(500));
+        h.Add(MilliSeconds(3));
+        h.Add(MilliSeconds(3));
+        h.Add(MilliSeconds(100));
+        NS_TEST_EXPECT_MSG_EQ(h.GetCount(), 4, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h.GetBucketCount(0), 1, "Below 1 ms");
+        NS_TEST_EXPECT_MSG_EQ(h.GetBucketCount(2), 2, "In [2, 4) ms");
+        NS_TEST_EXPECT_MSG_EQ(h.GetBucketCount(7), 1, "In [64, 128) ms");
+        NS_TEST_EXPECT_MSG_EQ(h.GetMax(), MilliSeconds(100), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h.GetMean(), MicroSeconds(26625), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h.GetQuantile(0.5), MilliSeconds(4), "Upper bound of the bucket");
+        NS_TEST_EXPECT_MSG_EQ(h.GetQuantile(1), MilliSeconds(100), "Capped by the largest");
+
+        h.Add(Seconds(1000));
+        NS_TEST_EXPECT_MSG_EQ(h.GetBucketCount(AodvLatencyHistogram::N_BUCKETS - 1),
+                              1,
+                              "Last bucket is unbounded");
+
+        AodvLatencyHistogram total;
+        total += h;
+        total += h;
+        NS_TEST_EXPECT_MSG_EQ(total.GetCount(), 10, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(total.GetBucketCount(2), 4, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(total.GetMax(), Seconds(1000), "trivial");
+    }
+};
+
+/// Unit test for AodvFootprint
+struct AodvFootprintTest : public TestCase
+{
+    AodvFootprintTest()
+        : TestCase("Footprint")
+    {
+    }
+
+    void DoRun() override
+    {
+        aodv::IdCache cache(Seconds(10));
+        NS_TEST_EXPECT_MSG_EQ(cache.GetMemoryUsage().entries, 0, "trivial");
+        cache.IsDuplicate(Ipv4Address("1.2.3.4"), 1);
+        cache.IsDuplicate(Ipv4Address("1.2.3.4"), 2);
+        cache.IsDuplicate(Ipv4Address("1.2.3.4"), 2);
+        AodvMemoryUsage usage = cache.GetMemoryUsage();
+        NS_TEST_EXPECT_MSG_EQ(usage.entries, 2, "Duplicates are not stored twice");
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(usage.bytes,
+                                    2 * (sizeof(Ipv4Address) + sizeof(uint32_t)),
+                                    "At least the addresses and IDs");
+
+        AodvFootprint footprint;
+        footprint.usage[AODV_STATE_RREQ_ID_CACHE] = usage;
+        footprint.usage[AODV_STATE_ROUTES].entries = 3;
+        footprint.usage[AODV_STATE_ROUTES].bytes = 300;
+        NS_TEST_EXPECT_MSG_EQ(footprint.GetTotalBytes(), usage.bytes + 300, "trivial");
+
+        AodvFootprint total;
+        total += footprint;
+        total += footprint;
+        NS_TEST_EXPECT_MSG_EQ(total.usage[AODV_STATE_ROUTES].entries, 6, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(total.usage[AODV_STATE_RREQ_ID_CACHE].bytes,
+                              2 * usage.bytes,
+                              "trivial");
+        NS_TEST_EXPECT_MSG_EQ(total.usage[AODV_STATE_TRUST_TABLE].entries, 0, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(total.GetTotalBytes(), 2 * footprint.GetTotalBytes(), "trivial");
+    }
+};
+
+/// Unit test for AodvTrustAccuracy
+struct AodvTrustAccuracyTest : public TestCase
+{
+    AodvTrustAccuracyTest()
+        : TestCase("TrustAccuracy")
+    {
+    }
+
+    void DoRun() override
+    {
+        AodvTrustAccuracy a;
+        NS_TEST_EXPECT_MSG_EQ(a.GetTruePositiveRate(), 0, "No malicious node judged");
+        NS_TEST_EXPECT_MSG_EQ(a.GetFalsePositiveRate(), 0, "No benign node judged");
+
+        a.Add(true, true);
+        a.Add(true, true);
+        a.Add(false, true);
+        a.Add(true, false);
+        a.Add(false, false);
+        a.Add(false, false);
+        a.Add(false, false);
+        NS_TEST_EXPECT_MSG_EQ(a.truePositives, 2, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(a.falseNegatives, 1, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(a.falsePositives, 1, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(a.trueNegatives, 3, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(a.GetCount(), 7, "trivial");
+        NS_TEST_EXPECT_MSG_EQ_TOL(a.GetTruePositiveRate(), 2.0 / 3, 1e-9, "trivial");
+        NS_TEST_EXPECT_MSG_EQ_TOL(a.GetFalsePositiveRate(), 0.25, 1e-9, "trivial");
+
+        AodvTrustAccuracy total;
+        total += a;
+        total += a;
+        NS_TEST_EXPECT_MSG_EQ(total.GetCount(), 14, "trivial");
+        NS_TEST_EXPECT_MSG_EQ_TOL(total.GetFalsePositiveRate(), 0.25, 1e-9, "trivial");
+    }
+};
+
+/// Unit test for AodvEventLog and AodvEventBuffer
+struct AodvEventLogTest : public TestCase
+{
+    AodvEventLogTest()
+        : TestCase("EventLog")
+    {
+    }
+
+    void DoRun() override
+    {
+        AodvEventBuffer buffer;
+        buffer.Record(AODV_EVENT_RREQ_SENT, Ipv4Address("10.0.0.2"));
+        NS_TEST_EXPECT_MSG_EQ(!buffer.GetLog(), true, "Logging is off by default");
+
+        std::string filename = CreateTempDirFilename("aodv-event-log.bin");
+        Ptr<AodvEventLog> log = CreateObject<AodvEventLog>();
+        log->SetAttribute("BufferRecords", UintegerValue(2));
+        log->Open(filename);
+        buffer.SetLog(log);
+        buffer.SetNode(3);
+        buffer.Record(AODV_EVENT_ROUTE_ADDED,
+                      Ipv4Address("10.0.0.2"),
+                      Ipv4Address("10.0.0.4"),
+                      7,
+                      2);
+        NS_TEST_EXPECT_MSG_EQ(log->GetRecordCount(), 0, "Record buffered");
+        buffer.Record(AODV_EVENT_RERR_RECEIVED, Ipv4Address("10.0.0.4"), Ipv4Address(), 0, 0, 5);
+        NS_TEST_EXPECT_MSG_EQ(log->GetRecordCount(), 2, "Full buffer written");
+        buffer.Record(AODV_EVENT_NEIGHBOR_DOWN, Ipv4Address("10.0.0.4"));
+        buffer.SetLog(nullptr);
+        NS_TEST_EXPECT_MSG_EQ(log->GetRecordCount(), 3, "Buffer written when the log changes");
+        log = nullptr;
+
+        std::ifstream in(filename, std::ios::binary);
+        AodvEventLogHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        NS_TEST_EXPECT_MSG_EQ(std::string(header.magic), "AODVEVT", "trivial");
+        NS_TEST_EXPECT_MSG_EQ(header.version, AodvEventLogHeader::VERSION, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(header.recordSize, sizeof(AodvEventRecord), "trivial");
+        AodvEventRecord records[3];
+        in.read(reinterpret_cast<char*>(records), sizeof(records));
+        NS_TEST_ASSERT_MSG_EQ(in.gcount(),
+                              static_cast<std::streamsize>(sizeof(records)),
+                              "Three records in the file");
+        NS_TEST_EXPECT_MSG_EQ(records[0].node, 3, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[0].type, AODV_EVENT_ROUTE_ADDED, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[0].address, Ipv4Address("10.0.0.2").Get(), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[0].peer, Ipv4Address("10.0.0.4").Get(), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[0].seqNo, 7, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[0].hopCount, 2, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[1].type, AODV_EVENT_RERR_RECEIVED, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[1].value, 5, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[2].type, AODV_EVENT_NEIGHBOR_DOWN, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(records[2].peer, 0, "Fields which do not apply are zero");
+        NS_TEST_EXPECT_MSG_EQ(in.peek(), EOF, "No more records");
+    }
+};
+
 /**
  * @ingroup aodv-test
  *
@@ -740,6 +1083,11 @@ class AodvTestSuite : public TestSuite
         AddTestCase(new AodvRqueueTest, TestCase::Duration::QUICK);
         AddTestCase(new AodvRtableEntryTest, TestCase::Duration::QUICK);
         AddTestCase(new AodvRtableTest, TestCase::Duration::QUICK);
+        AddTestCase(new AodvStatsTest, TestCase::Duration::QUICK);
+        AddTestCase(new AodvLatencyHistogramTest, TestCase::Duration::QUICK);
+        AddTestCase(new AodvFootprintTest, TestCase::Duration::QUICK);
+        AddTestCase(new AodvTrustAccuracyTest, TestCase::Duration::QUICK);
+        AddTestCase(new AodvEventLogTest, TestCase::Duration::QUICK);
     }
 } g_aodvTestSuite; ///< the test suite
 
@@ -59,6 +59,13 @@ class DuplicatePacketDetection
      * @returns the duplicate record lifetime
      */
     Time GetLifetime() const;
+    /**
+     * @returns the entries and approximate bytes of the duplicate records
+     */
+    AodvMemoryUsage GetMemoryUsage() const
+    {
+        return m_idCache.GetMemoryUsage();
+    }
 
   private:
     /// Impl
@@ -17,6 +17,7 @@
 #ifndef PAODVNEIGHBOR_H
 #define PAODVNEIGHBOR_H
 
+#include "ns3/aodv-stats.h"
 #include "ns3/arp-cache.h"
 #include "ns3/callback.h"
 #include "ns3/ipv4-address.h"
@@ -98,6 +99,10 @@ class Neighbors
     void Purge();
     /// Schedule m_ntimer.
     void ScheduleTimer();
+    /**
+     * @returns the entries and approximate bytes of the neighbor list
+     */
+    AodvMemoryUsage GetMemoryUsage() const;
 
     /// Remove all entries
     void Clear()
@@ -147,9 +152,21 @@ class Neighbors
     {
         return m_nb;
     }
+
+    /**
+     * Set the callback invoked when a link to a new neighbor is opened
+     * @param cb the callback function
+     */
+    void SetNewNeighborCallback(Callback<void, Ipv4Address> cb)
+    {
+        m_handleNewNeighbor = cb;
+    }
+
   private:
     /// link failure callback
     Callback<void, Ipv4Address> m_handleLinkFailure;
+    /// new neighbor callback
+    Callback<void, Ipv4Address> m_handleNewNeighbor;
     /// TX error callback
     Callback<void, const WifiMacHeader&> m_txErrorCallback;
     /// Timer for neighbor's list. Schedule Purge().
@@ -18,11 +18,69 @@
 #include "ns3/address-utils.h"
 #include "ns3/packet.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 namespace paodv
 {
 
+/**
+ * Get the size of an unsigned integer in the variable-length encoding used by the compact
+ * headers: 7 bits per byte, least significant group first, high bit set when more bytes follow.
+ *
+ * @param v the value
+ * @return the encoded size in bytes
+ */
+static uint32_t
+GetVarintSize(uint32_t v)
+{
+    uint32_t size = 1;
+    while (v >= 0x80)
+    {
+        v >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+/**
+ * Write an unsigned integer in the variable-length encoding
+ * @param i the buffer iterator
+ * @param v the value
+ */
+static void
+WriteVarint(Buffer::Iterator& i, uint32_t v)
+{
+    while (v >= 0x80)
+    {
+        i.WriteU8(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    i.WriteU8(static_cast<uint8_t>(v));
+}
+
+/**
+ * Read an unsigned integer in the variable-length encoding
+ * @param i the buffer iterator
+ * @return the value
+ */
+static uint32_t
+ReadVarint(Buffer::Iterator& i)
+{
+    uint32_t v = 0;
+    for (uint32_t shift = 0; shift < 35; shift += 7)
+    {
+        uint8_t b = i.ReadU8();
+        v |= static_cast<uint32_t>(b & 0x7f) << shift;
+        if (!(b & 0x80))
+        {
+            break;
+        }
+    }
+    return v;
+}
+
 NS_OBJECT_ENSURE_REGISTERED(TypeHeader);
 
 TypeHeader::TypeHeader(MessageType t)
@@ -139,7 +197,8 @@ RreqHeader::RreqHeader(uint8_t flags,
       m_dst(dst),
       m_dstSeqNo(dstSeqNo),
       m_origin(origin),
-      m_originSeqNo(originSeqNo)
+      m_originSeqNo(originSeqNo),
+      m_compact(false)
 {
 }
 
@@ -161,15 +220,68 @@ RreqHeader::GetInstanceTypeId() const
     return GetTypeId();
 }
 
+/// G, D and U flags of the RREQ, carried in the first byte of the compact encoding
+static const uint8_t RREQ_COMPACT_FLAGS = (1 << 5) | (1 << 4) | (1 << 3);
+
+/**
+ * Check whether a RREQ needs the raw flags, reserved and hop count bytes in the compact encoding
+ * @param flags the RREQ flags
+ * @param reserved the reserved field
+ * @param hopCount the hop count
+ * @return true if the fields do not fit in the first byte
+ */
+static bool
+RreqNeedsCompactExtension(uint8_t flags, uint8_t reserved, uint8_t hopCount)
+{
+    return (flags & ~RREQ_COMPACT_FLAGS) != 0 || reserved != 0 || hopCount > 0x0f;
+}
+
 uint32_t
 RreqHeader::GetSerializedSize() const
 {
-    return 23;
+    if (!m_compact)
+    {
+        return 23;
+    }
+    uint32_t size = 1 + 4 + 4; // first byte and both addresses
+    if (RreqNeedsCompactExtension(m_flags, m_reserved, m_hopCount))
+    {
+        size += 3;
+    }
+    return size + GetVarintSize(m_requestID) + GetVarintSize(m_dstSeqNo) +
+           GetVarintSize(m_originSeqNo);
+}
+
+int32_t
+RreqHeader::GetCompactSavings() const
+{
+    return m_compact ? 23 - static_cast<int32_t>(GetSerializedSize()) : 0;
 }
 
 void
 RreqHeader::Serialize(Buffer::Iterator i) const
 {
+    if (m_compact)
+    {
+        // |X|G|D|U| Hop Count |, X announces the raw flags, reserved and hop count bytes
+        if (RreqNeedsCompactExtension(m_flags, m_reserved, m_hopCount))
+        {
+            i.WriteU8(0x80);
+            i.WriteU8(m_flags);
+            i.WriteU8(m_reserved);
+            i.WriteU8(m_hopCount);
+        }
+        else
+        {
+            i.WriteU8(((m_flags & RREQ_COMPACT_FLAGS) << 1) | m_hopCount);
+        }
+        WriteVarint(i, m_requestID);
+        WriteTo(i, m_dst);
+        WriteVarint(i, m_dstSeqNo);
+        WriteTo(i, m_origin);
+        WriteVarint(i, m_originSeqNo);
+        return;
+    }
     i.WriteU8(m_flags);
     i.WriteU8(m_reserved);
     i.WriteU8(m_hopCount);
@@ -184,14 +296,38 @@ uint32_t
 RreqHeader::Deserialize(Buffer::Iterator start)
 {
     Buffer::Iterator i = start;
-    m_flags = i.ReadU8();
-    m_reserved = i.ReadU8();
-    m_hopCount = i.ReadU8();
-    m_requestID = i.ReadNtohU32();
-    ReadFrom(i, m_dst);
-    m_dstSeqNo = i.ReadNtohU32();
-    ReadFrom(i, m_origin);
-    m_originSeqNo = i.ReadNtohU32();
+    if (m_compact)
+    {
+        uint8_t first = i.ReadU8();
+        if (first & 0x80)
+        {
+            m_flags = i.ReadU8();
+            m_reserved = i.ReadU8();
+            m_hopCount = i.ReadU8();
+        }
+        else
+        {
+            m_flags = (first >> 1) & RREQ_COMPACT_FLAGS;
+            m_reserved = 0;
+            m_hopCount = first & 0x0f;
+        }
+        m_requestID = ReadVarint(i);
+        ReadFrom(i, m_dst);
+        m_dstSeqNo = ReadVarint(i);
+        ReadFrom(i, m_origin);
+        m_originSeqNo = ReadVarint(i);
+    }
+    else
+    {
+        m_flags = i.ReadU8();
+        m_reserved = i.ReadU8();
+        m_hopCount = i.ReadU8();
+        m_requestID = i.ReadNtohU32();
+        ReadFrom(i, m_dst);
+        m_dstSeqNo = i.ReadNtohU32();
+        ReadFrom(i, m_origin);
+        m_originSeqNo = i.ReadNtohU32();
+    }
 
     uint32_t dist = i.GetDistanceFrom(start);
     NS_ASSERT(dist == GetSerializedSize());
@@ -295,7 +431,8 @@ RrepHeader::RrepHeader(uint8_t prefixSize,
       m_hopCount(hopCount),
       m_dst(dst),
       m_dstSeqNo(dstSeqNo),
-      m_origin(origin)
+      m_origin(origin),
+      m_compact(false)
 {
     m_lifeTime = uint32_t(lifeTime.GetMilliSeconds());
 }
@@ -318,15 +455,87 @@ RrepHeader::GetInstanceTypeId() const
     return GetTypeId();
 }
 
+/// A flag of the RREP, carried in the first byte of the compact encoding
+static const uint8_t RREP_COMPACT_FLAGS = (1 << 6);
+/// Granularity of the lifetime in the compact encoding (milliseconds)
+static const uint32_t RREP_COMPACT_LIFETIME_UNIT = 100;
+/// Largest lifetime in compact units whose value in milliseconds fits in 32 bits
+static const uint32_t RREP_COMPACT_LIFETIME_MAX = UINT32_MAX / RREP_COMPACT_LIFETIME_UNIT;
+
+/**
+ * Check whether a RREP needs the raw flags, prefix size and hop count bytes in the compact
+ * encoding
+ * @param flags the RREP flags
+ * @param prefixSize the prefix size
+ * @param hopCount the hop count
+ * @return true if the fields do not fit in the first byte
+ */
+static bool
+RrepNeedsCompactExtension(uint8_t flags, uint8_t prefixSize, uint8_t hopCount)
+{
+    return (flags & ~RREP_COMPACT_FLAGS) != 0 || prefixSize != 0 || hopCount > 0x3f;
+}
+
+/**
+ * Convert a RREP lifetime to compact lifetime units, rounding up
+ *
+ * Lifetimes within one unit of 2^32 ms are rounded down instead, so that the decoded value
+ * still fits in 32 bits.
+ * @param lifeTime the lifetime in milliseconds
+ * @return the lifetime in compact units
+ */
+static uint32_t
+GetCompactLifeTime(uint32_t lifeTime)
+{
+    uint64_t units = (uint64_t(lifeTime) + RREP_COMPACT_LIFETIME_UNIT - 1) /
+                     RREP_COMPACT_LIFETIME_UNIT;
+    return static_cast<uint32_t>(std::min<uint64_t>(units, RREP_COMPACT_LIFETIME_MAX));
+}
+
 uint32_t
 RrepHeader::GetSerializedSize() const
 {
-    return 19;
+    if (!m_compact)
+    {
+        return 19;
+    }
+    uint32_t size = 1 + 4 + 4; // first byte and both addresses
+    if (RrepNeedsCompactExtension(m_flags, m_prefixSize, m_hopCount))
+    {
+        size += 3;
+    }
+    return size + GetVarintSize(m_dstSeqNo) + GetVarintSize(GetCompactLifeTime(m_lifeTime));
+}
+
+int32_t
+RrepHeader::GetCompactSavings() const
+{
+    return m_compact ? 19 - static_cast<int32_t>(GetSerializedSize()) : 0;
 }
 
 void
 RrepHeader::Serialize(Buffer::Iterator i) const
 {
+    if (m_compact)
+    {
+        // |X|A| Hop Count |, X announces the raw flags, prefix size and hop count bytes
+        if (RrepNeedsCompactExtension(m_flags, m_prefixSize, m_hopCount))
+        {
+            i.WriteU8(0x80);
+            i.WriteU8(m_flags);
+            i.WriteU8(m_prefixSize);
+            i.WriteU8(m_hopCount);
+        }
+        else
+        {
+            i.WriteU8((m_flags & RREP_COMPACT_FLAGS) | m_hopCount);
+        }
+        WriteTo(i, m_dst);
+        WriteVarint(i, m_dstSeqNo);
+        WriteTo(i, m_origin);
+        WriteVarint(i, GetCompactLifeTime(m_lifeTime));
+        return;
+    }
     i.WriteU8(m_flags);
     i.WriteU8(m_prefixSize);
     i.WriteU8(m_hopCount);
@@ -341,13 +550,37 @@ RrepHeader::Deserialize(Buffer::Iterator start)
 {
     Buffer::Iterator i = start;
 
-    m_flags = i.ReadU8();
-    m_prefixSize = i.ReadU8();
-    m_hopCount = i.ReadU8();
-    ReadFrom(i, m_dst);
-    m_dstSeqNo = i.ReadNtohU32();
-    ReadFrom(i, m_origin);
-    m_lifeTime = i.ReadNtohU32();
+    if (m_compact)
+    {
+        uint8_t first = i.ReadU8();
+        if (first & 0x80)
+        {
+            m_flags = i.ReadU8();
+            m_prefixSize = i.ReadU8();
+            m_hopCount = i.ReadU8();
+        }
+        else
+        {
+            m_flags = first & RREP_COMPACT_FLAGS;
+            m_prefixSize = 0;
+            m_hopCount = first & 0x3f;
+        }
+        ReadFrom(i, m_dst);
+        m_dstSeqNo = ReadVarint(i);
+        ReadFrom(i, m_origin);
+        m_lifeTime =
+            std::min(ReadVarint(i), RREP_COMPACT_LIFETIME_MAX) * RREP_COMPACT_LIFETIME_UNIT;
+    }
+    else
+    {
+        m_flags = i.ReadU8();
+        m_prefixSize = i.ReadU8();
+        m_hopCount = i.ReadU8();
+        ReadFrom(i, m_dst);
+        m_dstSeqNo = i.ReadNtohU32();
+        ReadFrom(i, m_origin);
+        m_lifeTime = i.ReadNtohU32();
+    }
 
     uint32_t dist = i.GetDistanceFrom(start);
     NS_ASSERT(dist == GetSerializedSize());
@@ -558,13 +791,14 @@ RerrHeader::Deserialize(Buffer::Iterator start)
     m_reserved = i.ReadU8();
     uint8_t dest = i.ReadU8();
     m_unreachableDstSeqNo.clear();
+    m_unreachableDstSeqNo.reserve(dest);
     Ipv4Address address;
     uint32_t seqNo;
     for (uint8_t k = 0; k < dest; ++k)
     {
         ReadFrom(i, address);
         seqNo = i.ReadNtohU32();
-        m_unreachableDstSeqNo.insert(std::make_pair(address, seqNo));
+        AddUnDestination(address, seqNo);
     }
 
     uint32_t dist = i.GetDistanceFrom(start);
@@ -605,13 +839,29 @@ RerrHeader::GetNoDelete() const
 bool
 RerrHeader::AddUnDestination(Ipv4Address dst, uint32_t seqNo)
 {
-    if (m_unreachableDstSeqNo.find(dst) != m_unreachableDstSeqNo.end())
+    // Destinations are usually added in increasing order (routing table walk, wire order),
+    // so check the tail before falling back to a binary search.
+    auto pos = m_unreachableDstSeqNo.end();
+    if (!m_unreachableDstSeqNo.empty() && !(m_unreachableDstSeqNo.back().first < dst))
     {
-        return true;
+        pos = std::lower_bound(m_unreachableDstSeqNo.begin(),
+                               m_unreachableDstSeqNo.end(),
+                               dst,
+                               [](const std::pair<Ipv4Address, uint32_t>& e, Ipv4Address a) {
+                                   return e.first < a;
+                               });
+        if (pos->first == dst)
+        {
+            return true;
+        }
     }
 
-    NS_ASSERT(GetDestCount() < 255); // can't support more than 255 destinations in single RERR
-    m_unreachableDstSeqNo.insert(std::make_pair(dst, seqNo));
+    if (m_unreachableDstSeqNo.size() >= 255)
+    {
+        // can't support more than 255 destinations in single RERR
+        return false;
+    }
+    m_unreachableDstSeqNo.insert(pos, std::make_pair(dst, seqNo));
     return true;
 }
 
@@ -622,9 +872,8 @@ RerrHeader::RemoveUnDestination(std::pair<Ipv4Address, uint32_t>& un)
     {
         return false;
     }
-    auto i = m_unreachableDstSeqNo.begin();
-    un = *i;
-    m_unreachableDstSeqNo.erase(i);
+    un = m_unreachableDstSeqNo.back();
+    m_unreachableDstSeqNo.pop_back();
     return true;
 }
 
@@ -16,6 +16,7 @@
 #ifndef PAODV_RQUEUE_H
 #define PAODV_RQUEUE_H
 
+#include "ns3/aodv-stats.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/simulator.h"
 
@@ -228,6 +229,10 @@ class RequestQueue
      * @returns the number of entries
      */
     uint32_t GetSize();
+    /**
+     * @returns the packets and approximate bytes of the queue, expired packets included
+     */
+    AodvMemoryUsage GetMemoryUsage() const;
 
     // Fields
     /**
@@ -16,6 +16,7 @@
 
 #include "paodv-rtable.h"
 
+#include "ns3/aodv-profiler.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
 
@@ -277,6 +278,10 @@ RoutingTable::AddRoute(RoutingTableEntry& rt)
         rt.SetRreqCnt(0);
     }
     auto result = m_ipv4AddressEntry.insert(std::make_pair(rt.GetDestination(), rt));
+    if (result.second && rt.GetFlag() == VALID && !m_routeChange.IsNull())
+    {
+        m_routeChange(rt);
+    }
     return result.second;
 }
 
@@ -290,12 +295,17 @@ RoutingTable::Update(RoutingTableEntry& rt)
         NS_LOG_LOGIC("Route update to " << rt.GetDestination() << " fails; not found");
         return false;
     }
+    bool wasValid = (i->second.GetFlag() == VALID);
     i->second = rt;
     if (i->second.GetFlag() != IN_SEARCH)
     {
         NS_LOG_LOGIC("Route update to " << rt.GetDestination() << " set RreqCnt to 0");
         i->second.SetRreqCnt(0);
     }
+    if (wasValid != (rt.GetFlag() == VALID) && !m_routeChange.IsNull())
+    {
+        m_routeChange(i->second);
+    }
     return true;
 }
 
@@ -309,9 +319,14 @@ RoutingTable::SetEntryState(Ipv4Address id, RouteFlags state)
         NS_LOG_LOGIC("Route set entry state to " << id << " fails; not found");
         return false;
     }
+    bool wasValid = (i->second.GetFlag() == VALID);
     i->second.SetFlag(state);
     i->second.SetRreqCnt(0);
     NS_LOG_LOGIC("Route set entry state to " << id << ": new state is " << state);
+    if (wasValid != (state == VALID) && !m_routeChange.IsNull())
+    {
+        m_routeChange(i->second);
+    }
     return true;
 }
 
@@ -337,14 +352,16 @@ RoutingTable::InvalidateRoutesWithDst(const std::map<Ipv4Address, uint32_t>& unr
 {
     NS_LOG_FUNCTION(this);
     Purge();
-    for (auto i = m_ipv4AddressEntry.begin(); i != m_ipv4AddressEntry.end(); ++i)
+    for (auto j = unreachable.begin(); j != unreachable.end(); ++j)
     {
-        for (auto j = unreachable.begin(); j != unreachable.end(); ++j)
+        auto i = m_ipv4AddressEntry.find(j->first);
+        if (i != m_ipv4AddressEntry.end() && i->second.GetFlag() == VALID)
         {
-            if ((i->first == j->first) && (i->second.GetFlag() == VALID))
+            NS_LOG_LOGIC("Invalidate route with destination address " << i->first);
+            i->second.Invalidate(m_badLinkLifetime);
+            if (!m_routeChange.IsNull())
             {
-                NS_LOG_LOGIC("Invalidate route with destination address " << i->first);
-                i->second.Invalidate(m_badLinkLifetime);
+                m_routeChange(i->second);
             }
         }
     }
@@ -376,6 +393,7 @@ RoutingTable::DeleteAllRoutesFromInterface(Ipv4InterfaceAddress iface)
 void
 RoutingTable::Purge()
 {
+    AODV_PROFILE_SCOPE("paodv::RoutingTable::Purge");
     NS_LOG_FUNCTION(this);
     if (m_ipv4AddressEntry.empty())
     {
@@ -395,6 +413,10 @@ RoutingTable::Purge()
             {
                 NS_LOG_LOGIC("Invalidate route with destination address " << i->first);
                 i->second.Invalidate(m_badLinkLifetime);
+                if (!m_routeChange.IsNull())
+                {
+                    m_routeChange(i->second);
+                }
                 ++i;
             }
             else
@@ -409,6 +431,19 @@ RoutingTable::Purge()
     }
 }
 
+AodvMemoryUsage
+RoutingTable::GetMemoryUsage() const
+{
+    AodvMemoryUsage usage;
+    usage.entries = m_ipv4AddressEntry.size();
+    for (const auto& entry : m_ipv4AddressEntry)
+    {
+        usage.bytes += sizeof(entry) + AodvMemoryUsage::NODE_OVERHEAD +
+                       entry.second.GetPrecursorCount() * sizeof(Ipv4Address);
+    }
+    return usage;
+}
+
 void
 RoutingTable::Purge(std::map<Ipv4Address, RoutingTableEntry>& table) const
 {
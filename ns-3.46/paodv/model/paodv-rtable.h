@@ -16,6 +16,8 @@
 #ifndef PAODV_RTABLE_H
 #define PAODV_RTABLE_H
 
+#include "ns3/aodv-stats.h"
+#include "ns3/callback.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/ipv4.h"
 #include "ns3/net-device.h"
@@ -105,6 +107,14 @@ class RoutingTableEntry
      * @param prec vector of precursor addresses
      */
     void GetPrecursors(std::vector<Ipv4Address>& prec) const;
+
+    /**
+     * @returns the number of precursors
+     */
+    uint32_t GetPrecursorCount() const
+    {
+        return m_precursorList.size();
+    }
     //\}
 
     /**
@@ -511,6 +521,10 @@ class RoutingTable
 
     /// Delete all outdated entries and invalidate valid entry if Lifetime is expired
     void Purge();
+    /**
+     * @returns the entries and approximate bytes of the routing table, precursor lists included
+     */
+    AodvMemoryUsage GetMemoryUsage() const;
     /** Mark entry as unidirectional (e.g. add this neighbor to "blacklist" for blacklistTimeout
      * period)
      * @param neighbor neighbor address link to which assumed to be unidirectional
@@ -525,9 +539,20 @@ class RoutingTable
      */
     void Print(Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
 
+    /**
+     * Set the callback invoked when a route becomes valid or a valid route stops being valid
+     * @param cb the callback function, given the entry after the change
+     */
+    void SetRouteChangeCallback(Callback<void, const RoutingTableEntry&> cb)
+    {
+        m_routeChange = cb;
+    }
+
   private:
     /// The routing table
     std::map<Ipv4Address, RoutingTableEntry> m_ipv4AddressEntry;
+    /// Route change callback
+    Callback<void, const RoutingTableEntry&> m_routeChange;
     /// Deletion time for invalid routes
     Time m_badLinkLifetime;
     /**
@@ -0,0 +1,30 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "../../aodv/test/aodv-perf-test.h"
+
+#include "ns3/paodv-helper.h"
+
+using namespace ns3;
+
+AODV_PERF_COUNT_ALLOCATIONS()
+
+/**
+ * @ingroup paodv-test
+ *
+ * @brief PAODV performance regression test suite
+ */
+class PAodvPerfTestSuite : public TestSuite
+{
+  public:
+    PAodvPerfTestSuite()
+        : TestSuite("routing-paodv-performance", Type::PERFORMANCE)
+    {
+        SetDataDir(NS_TEST_SOURCEDIR);
+        AddTestCase(new AodvPerfTest<PAodvHelper>("PAODV", "grid-5x5", 5, 5, Seconds(30)),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new AodvPerfTest<PAodvHelper>("PAODV", "grid-10x10", 10, 20, Seconds(30)),
+                    TestCase::Duration::EXTENSIVE);
+    }
+} g_paodvPerfTestSuite; ///< the test suite
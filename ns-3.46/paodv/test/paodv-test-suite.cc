@@ -205,6 +205,27 @@ struct RreqHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, 23, "RREP is 23 bytes long");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 0, "Nothing saved by the RFC encoding");
+
+        h.SetCompact(true);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RreqHeader h3;
+        h3.SetCompact(true);
+        bytes = p->RemoveHeader(h3);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 12, "Compact RREQ with small fields is 12 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 11, "Compact RREQ saves 11 bytes");
+        NS_TEST_EXPECT_MSG_EQ(h, h3, "Compact round trip serialization works");
+
+        h.SetHopCount(20);
+        h.SetId(0xffffffff);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RreqHeader h4;
+        h4.SetCompact(true);
+        bytes = p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 19, "Long hop count and ID need the extension");
+        NS_TEST_EXPECT_MSG_EQ(h, h4, "Compact round trip serialization works");
     }
 };
 
@@ -262,6 +283,49 @@ struct RrepHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, 19, "RREP is 19 bytes long");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+
+        h.SetCompact(true);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h3;
+        h3.SetCompact(true);
+        bytes = p->RemoveHeader(h3);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 12, "Compact HELLO is 12 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 7, "Compact HELLO saves 7 bytes");
+        NS_TEST_EXPECT_MSG_EQ(h, h3, "Compact round trip serialization works");
+
+        h.SetAckRequired(true);
+        h.SetLifeTime(MilliSeconds(1250));
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h4;
+        h4.SetCompact(true);
+        p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(h4.GetAckRequired(), true, "A flag survives the compact encoding");
+        NS_TEST_EXPECT_MSG_EQ(h4.GetLifeTime(),
+                              MilliSeconds(1300),
+                              "Compact lifetime is rounded up to 100 ms");
+
+        h.SetLifeTime(MilliSeconds(UINT32_MAX - 50));
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h6;
+        h6.SetCompact(true);
+        bytes = p->RemoveHeader(h6);
+        NS_TEST_EXPECT_MSG_EQ(bytes, h.GetSerializedSize(), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h6.GetLifeTime(),
+                              MilliSeconds(UINT32_MAX / 100 * 100),
+                              "Compact lifetime near 2^32 ms is rounded down");
+
+        h.SetPrefixSize(8);
+        h.SetHopCount(100);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h5;
+        h5.SetCompact(true);
+        p->RemoveHeader(h5);
+        NS_TEST_EXPECT_MSG_EQ(h5.GetPrefixSize(), 8, "Prefix size needs the extension");
+        NS_TEST_EXPECT_MSG_EQ(h5.GetHopCount(), 100, "Long hop count needs the extension");
     }
 };
 
@@ -320,6 +384,35 @@ struct RerrHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, h.GetSerializedSize(), "(De)Serialized size match");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+
+        std::pair<Ipv4Address, uint32_t> un;
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(un.first, dst2, "Destinations are kept in address order");
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(un.first, dst, "Destinations are kept in address order");
+        NS_TEST_EXPECT_MSG_EQ(un.second, 12, "Duplicate destination keeps first seqno");
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), false, "Header is empty");
+
+        RerrHeader h3;
+        for (uint32_t k = 255; k > 0; --k)
+        {
+            NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address(0x0a000000 + k), k),
+                                  true,
+                                  "trivial");
+        }
+        NS_TEST_EXPECT_MSG_EQ(h3.GetDestCount(), 255, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address("10.0.1.0"), 1),
+                              false,
+                              "No more than 255 destinations");
+        NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address("10.0.0.1"), 1),
+                              true,
+                              "Duplicate of a present destination is accepted");
+        p = Create<Packet>();
+        p->AddHeader(h3);
+        RerrHeader h4;
+        bytes = p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 3 + 8 * 255, "(De)Serialized size match");
+        NS_TEST_EXPECT_MSG_EQ(h3, h4, "Round trip serialization works");
     }
 };
 
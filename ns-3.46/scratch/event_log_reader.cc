@@ -0,0 +1,193 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/aodv-module.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("EventLogReader");
+
+/*
+ * Reader of the binary routing event logs written by AodvEventLog, for
+ * instance with overhead_test --eventLog=events.bin.
+ *
+ * The file is memory-mapped and scanned once. Records can be filtered by
+ * node, event type, address (matching the address or the peer field) and
+ * time window; the matching records are counted by type and by node, and
+ * the first of them can be printed. Blocks of different nodes interleave in
+ * the file, so the printed records are in time order per node only.
+ */
+
+static std::string
+FormatAddress (uint32_t address)
+{
+  std::ostringstream oss;
+  Ipv4Address (address).Print (oss);
+  return oss.str ();
+}
+
+static int
+ParseType (const std::string &name)
+{
+  for (int t = 0; t < AODV_EVENT_TYPES; ++t)
+    {
+      if (name == AodvEventTypeName (static_cast<AodvEventType> (t)))
+        {
+          return t;
+        }
+    }
+  return -1;
+}
+
+static void
+PrintRecord (const AodvEventRecord &r)
+{
+  std::cout << std::fixed << std::setprecision (6) << std::setw (12) << r.time * 1e-9
+            << std::setw (6) << r.node << "  " << std::left << std::setw (17)
+            << AodvEventTypeName (static_cast<AodvEventType> (r.type))
+            << std::setw (16) << FormatAddress (r.address)
+            << std::setw (16) << FormatAddress (r.peer) << std::right
+            << std::setw (11) << r.seqNo << std::setw (5) << unsigned (r.hopCount)
+            << std::setw (7) << r.value << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string file = "";
+  int64_t node = -1;
+  std::string type = "";
+  std::string address = "";
+  double from = 0.0;
+  double to = -1.0;
+  uint32_t print = 0;
+
+  CommandLine cmd;
+  cmd.AddValue ("file", "Event log to read", file);
+  cmd.AddValue ("node", "Only the records of this node ID (-1 for all nodes)", node);
+  cmd.AddValue ("type", "Only the records of this event type, e.g. rreqSent or routeAdded", type);
+  cmd.AddValue ("address", "Only the records whose address or peer is this IPv4 address", address);
+  cmd.AddValue ("from", "Only the records at or after this time, in seconds", from);
+  cmd.AddValue ("to", "Only the records before this time, in seconds (-1 for no limit)", to);
+  cmd.AddValue ("print", "Print at most this many of the matching records", print);
+  cmd.Parse (argc, argv);
+
+  NS_ABORT_MSG_IF (file.empty (), "Missing --file");
+  int typeFilter = -1;
+  if (!type.empty ())
+    {
+      typeFilter = ParseType (type);
+      NS_ABORT_MSG_IF (typeFilter < 0, "Unknown event type " << type);
+    }
+  bool addressFilter = !address.empty ();
+  uint32_t addressValue = addressFilter ? Ipv4Address (address.c_str ()).Get () : 0;
+  int64_t fromNs = static_cast<int64_t> (from * 1e9);
+  int64_t toNs = (to < 0) ? INT64_MAX : static_cast<int64_t> (to * 1e9);
+
+  int fd = open (file.c_str (), O_RDONLY);
+  NS_ABORT_MSG_IF (fd < 0, "Cannot open " << file);
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0, "Cannot stat " << file);
+  size_t size = st.st_size;
+  NS_ABORT_MSG_IF (size < sizeof (AodvEventLogHeader), file << " is not an event log");
+  void *map = mmap (nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  NS_ABORT_MSG_IF (map == MAP_FAILED, "Cannot map " << file);
+  close (fd);
+  madvise (map, size, MADV_SEQUENTIAL);
+
+  const char *base = static_cast<const char *> (map);
+  AodvEventLogHeader header;
+  std::memcpy (&header, base, sizeof (header));
+  NS_ABORT_MSG_IF (std::strncmp (header.magic, "AODVEVT", sizeof (header.magic)) != 0,
+                   file << " is not an event log");
+  NS_ABORT_MSG_IF (header.version != AodvEventLogHeader::VERSION,
+                   "Unsupported event log version " << header.version);
+  NS_ABORT_MSG_IF (header.recordSize != sizeof (AodvEventRecord),
+                   "Unexpected record size " << header.recordSize);
+
+  const AodvEventRecord *records
+    = reinterpret_cast<const AodvEventRecord *> (base + sizeof (AodvEventLogHeader));
+  uint64_t nRecords = (size - sizeof (AodvEventLogHeader)) / sizeof (AodvEventRecord);
+
+  if (print > 0)
+    {
+      std::cout << "        TIME  NODE  EVENT            ADDRESS         PEER"
+                   "                  SEQNO  HOP  VALUE" << std::endl;
+    }
+  std::array<uint64_t, AODV_EVENT_TYPES> byType{};
+  std::map<uint32_t, std::array<uint64_t, AODV_EVENT_TYPES>> byNode;
+  uint64_t matched = 0;
+  int64_t first = INT64_MAX;
+  int64_t last = INT64_MIN;
+  for (uint64_t i = 0; i < nRecords; ++i)
+    {
+      const AodvEventRecord &r = records[i];
+      if ((node >= 0 && r.node != node) || (typeFilter >= 0 && r.type != typeFilter)
+          || r.type >= AODV_EVENT_TYPES || r.time < fromNs || r.time >= toNs
+          || (addressFilter && r.address != addressValue && r.peer != addressValue))
+        {
+          continue;
+        }
+      if (matched < print)
+        {
+          PrintRecord (r);
+        }
+      ++matched;
+      ++byType[r.type];
+      ++byNode[r.node][r.type];
+      first = std::min (first, r.time);
+      last = std::max (last, r.time);
+    }
+  munmap (map, size);
+
+  std::cout << "RECORDS:  " << matched << " of " << nRecords << std::endl;
+  if (matched == 0)
+    {
+      return 0;
+    }
+  std::cout << std::fixed << std::setprecision (6) << "TIME:     " << first * 1e-9 << " s to "
+            << last * 1e-9 << " s" << std::endl;
+  std::cout << "EVENT             COUNT" << std::endl;
+  for (int t = 0; t < AODV_EVENT_TYPES; ++t)
+    {
+      if (byType[t] > 0)
+        {
+          std::cout << std::left << std::setw (17)
+                    << AodvEventTypeName (static_cast<AodvEventType> (t)) << std::right
+                    << std::setw (6) << byType[t] << std::endl;
+        }
+    }
+
+  // One column per event type seen, one line per node
+  std::cout << std::setw (6) << "NODE";
+  for (int t = 0; t < AODV_EVENT_TYPES; ++t)
+    {
+      if (byType[t] > 0)
+        {
+          std::cout << std::setw (17) << AodvEventTypeName (static_cast<AodvEventType> (t));
+        }
+    }
+  std::cout << std::endl;
+  for (const auto &entry : byNode)
+    {
+      std::cout << std::setw (6) << entry.first;
+      for (int t = 0; t < AODV_EVENT_TYPES; ++t)
+        {
+          if (byType[t] > 0)
+            {
+              std::cout << std::setw (17) << entry.second[t];
+            }
+        }
+      std::cout << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,386 @@
+#include "ns3/core-module.h"
+#include "ns3/aodv-module.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("OverheadSweep");
+
+/*
+ * Parameter sweep around overhead_test.
+ *
+ * Every point of the grid protocol x nNodes x malicious x rreqBound x
+ * distanceThreshold is run once per RNG run number, as a separate
+ * overhead_test process. Up to 'jobs' processes run at the same time. The
+ * metrics printed by each run are averaged over the runs of the point and
+ * written to one CSV table, one line per point and metric, with the half
+ * width of the 95% confidence interval of the mean:
+ *
+ *   protocol,nNodes,malicious,rreqBound,distanceThreshold,metric,runs,mean,ci95
+ *
+ * Grid values are comma-separated lists, e.g.
+ *   ./ns3 run "overhead_sweep --protocols=AODV,TPAODV --nNodes=50,100 --runs=1,2,3,4,5"
+ *
+ * With --convergenceInterval every run may stop as soon as its metrics are
+ * steady, so runs of one point cover different times. Counters such as
+ * rreqSent or controlBytes are therefore divided by the stopTime of their
+ * run before averaging and reported as rreqSentPerSecond and so on.
+ */
+
+struct SweepPoint
+{
+  std::string protocol;
+  std::string nNodes;
+  std::string malicious;
+  std::string rreqBound;
+  std::string distanceThreshold;
+};
+
+struct SweepJob
+{
+  uint32_t point;
+  std::string run;
+  std::string outputFile;
+};
+
+static std::vector<std::string>
+SplitList (const std::string &list)
+{
+  std::vector<std::string> values;
+  std::stringstream ss (list);
+  std::string value;
+  while (std::getline (ss, value, ','))
+    {
+      if (!value.empty ())
+        {
+          values.push_back (value);
+        }
+    }
+  return values;
+}
+
+/* Two-sided 95% quantile of Student's t distribution */
+static double
+StudentT95 (uint32_t degreesOfFreedom)
+{
+  static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                 2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                 2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                 2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+  if (degreesOfFreedom == 0)
+    {
+      return 0;
+    }
+  if (degreesOfFreedom <= sizeof (table) / sizeof (table[0]))
+    {
+      return table[degreesOfFreedom - 1];
+    }
+  return 1.960;
+}
+
+/* Read the metrics of an overhead_test --output=csv result */
+static std::map<std::string, double>
+ParseMetrics (const std::string &filename)
+{
+  // Configuration columns, the sweep knows them already
+  static const std::set<std::string> config = {
+    "protocol", "nNodes", "malicious", "nMalicious", "simulationTime", "compactHeaders",
+    "rreqBound", "distanceThreshold", "convergenceInterval", "convergenceWindow",
+    "convergenceTolerance", "seed", "run"};
+
+  std::map<std::string, double> metrics;
+  std::ifstream in (filename);
+  std::string header;
+  std::string values;
+  if (!std::getline (in, header) || !std::getline (in, values))
+    {
+      return metrics;
+    }
+  std::vector<std::string> names = SplitList (header);
+  std::vector<std::string> fields = SplitList (values);
+  for (uint32_t i = 0; i < names.size () && i < fields.size (); ++i)
+    {
+      char *end;
+      double value = std::strtod (fields[i].c_str (), &end);
+      if (config.count (names[i]) || *end != '\0')
+        {
+          continue;
+        }
+      metrics[names[i]] = value;
+    }
+  return metrics;
+}
+
+/* Replace the counters of a run by their rate per simulated second */
+static void
+NormalizeCounters (std::map<std::string, double> &metrics)
+{
+  static std::set<std::string> counters;
+  if (counters.empty ())
+    {
+      counters = {"rreqSent", "rreqReceived", "rreqOverhead", "rrepSent", "rerrSent",
+                  "compactBytesSaved", "controlBytes", "controlAirtimeMs", "txPackets",
+                  "rxPackets", "brokenLinks", "routeDiscoveries", "heldForTrustTest",
+                  "trustTestsStarted", "trustTestsPassed", "trustTestsFailed",
+                  "trustTestsUnanswered", "heldRrepsReleased", "heldRrepsDropped",
+                  "maliciousDrops", "eventsProcessed"};
+      for (int t = 0; t < AODV_CONTROL_TYPES; ++t)
+        {
+          std::string name = AodvControlTypeName (static_cast<AodvControlType> (t));
+          for (const char *suffix : {"Bytes", "Frames", "Retries", "AirtimeMs"})
+            {
+              counters.insert (name + suffix);
+            }
+        }
+    }
+
+  auto stopTime = metrics.find ("stopTime");
+  if (stopTime == metrics.end () || stopTime->second <= 0)
+    {
+      return;
+    }
+  double seconds = stopTime->second;
+  for (const std::string &name : counters)
+    {
+      auto i = metrics.find (name);
+      if (i != metrics.end ())
+        {
+          metrics[name + "PerSecond"] = i->second / seconds;
+          metrics.erase (i);
+        }
+    }
+}
+
+static std::string
+DefaultBinary (const std::string &self)
+{
+  // Scratch programs are built as <prefix>overhead_sweep<suffix>
+  std::string binary = self;
+  size_t pos = binary.rfind ("overhead_sweep");
+  if (pos == std::string::npos)
+    {
+      return "";
+    }
+  return binary.replace (pos, std::string ("overhead_sweep").size (), "overhead_test");
+}
+
+static pid_t
+StartJob (const std::string &binary, const SweepPoint &p, const SweepJob &job,
+          const std::vector<std::string> &common)
+{
+  std::vector<std::string> args = {binary,
+                                   "--protocol=" + p.protocol,
+                                   "--nNodes=" + p.nNodes,
+                                   "--malicious=" + p.malicious,
+                                   "--rreqBound=" + p.rreqBound,
+                                   "--distanceThreshold=" + p.distanceThreshold,
+                                   "--RngRun=" + job.run,
+                                   "--output=csv"};
+  args.insert (args.end (), common.begin (), common.end ());
+  pid_t pid = fork ();
+  if (pid == 0)
+    {
+      std::vector<char *> argv;
+      for (auto &arg : args)
+        {
+          argv.push_back (&arg[0]);
+        }
+      argv.push_back (nullptr);
+      if (!freopen (job.outputFile.c_str (), "w", stdout))
+        {
+          _exit (127);
+        }
+      execv (binary.c_str (), argv.data ());
+      _exit (127);
+    }
+  return pid;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string protocols = "AODV,PAODV,TPAODV";
+  std::string nNodes = "50";
+  std::string malicious = "0,1";
+  std::string rreqBound = "2";
+  std::string distanceThreshold = "20";
+  std::string runs = "1,2,3";
+  uint32_t nMalicious = 5;
+  double simulationTime = 100.0;
+  double convergenceInterval = 0.0;
+  double convergenceTolerance = 0.05;
+  uint32_t jobs = std::thread::hardware_concurrency ();
+  std::string binary = DefaultBinary (argv[0]);
+  std::string output = "overhead-sweep.csv";
+
+  CommandLine cmd;
+  cmd.AddValue ("protocols", "Protocols to run", protocols);
+  cmd.AddValue ("nNodes", "Node counts to run", nNodes);
+  cmd.AddValue ("malicious", "Blackhole attack settings to run (0, 1)", malicious);
+  cmd.AddValue ("rreqBound", "PAODV/TPAODV RREQ bounds to run", rreqBound);
+  cmd.AddValue ("distanceThreshold", "PAODV/TPAODV distance thresholds to run", distanceThreshold);
+  cmd.AddValue ("runs", "RNG run numbers, one repetition of every point each", runs);
+  cmd.AddValue ("nMalicious", "Number of blackhole nodes of the attacked points", nMalicious);
+  cmd.AddValue ("simulationTime", "Simulated time of every run, in seconds", simulationTime);
+  cmd.AddValue ("convergenceInterval", "Let every run stop once its metrics are steady, sampling "
+                "them at this interval in seconds (0 disables it)", convergenceInterval);
+  cmd.AddValue ("convergenceTolerance", "Relative 95% confidence interval of a steady run",
+                convergenceTolerance);
+  cmd.AddValue ("jobs", "Number of simulations run in parallel", jobs);
+  cmd.AddValue ("binary", "Path of the overhead_test executable", binary);
+  cmd.AddValue ("output", "CSV file receiving the results", output);
+  cmd.Parse (argc, argv);
+
+  if (binary.empty () || access (binary.c_str (), X_OK) != 0)
+    {
+      std::cerr << "overhead_test executable not found, set it with --binary" << std::endl;
+      return 1;
+    }
+  jobs = std::max (jobs, 1u);
+
+  std::vector<SweepPoint> points;
+  for (const auto &protocol : SplitList (protocols))
+    for (const auto &n : SplitList (nNodes))
+      for (const auto &m : SplitList (malicious))
+        for (const auto &bound : SplitList (rreqBound))
+          for (const auto &distance : SplitList (distanceThreshold))
+            {
+              // AODV ignores the PAODV parameters, run it once
+              if (protocol == "AODV" && !points.empty () && points.back ().protocol == "AODV"
+                  && points.back ().nNodes == n && points.back ().malicious == m)
+                {
+                  continue;
+                }
+              points.push_back ({protocol, n, m, bound, distance});
+            }
+
+  std::vector<std::string> common = {
+    "--nMalicious=" + std::to_string (nMalicious),
+    "--simulationTime=" + std::to_string (simulationTime),
+    "--convergenceInterval=" + std::to_string (convergenceInterval),
+    "--convergenceTolerance=" + std::to_string (convergenceTolerance)};
+
+  std::vector<SweepJob> pending;
+  for (uint32_t i = 0; i < points.size (); ++i)
+    {
+      for (const auto &run : SplitList (runs))
+        {
+          char name[] = "/tmp/overhead-sweep-XXXXXX";
+          int fd = mkstemp (name);
+          if (fd < 0)
+            {
+              std::cerr << "Cannot create a temporary file" << std::endl;
+              return 1;
+            }
+          close (fd);
+          pending.push_back ({i, run, name});
+        }
+    }
+
+  std::cout << points.size () << " points, " << pending.size () << " runs on " << jobs
+            << " workers" << std::endl;
+
+  // Results by point, metric then run
+  std::vector<std::map<std::string, std::vector<double>>> results (points.size ());
+  std::map<pid_t, SweepJob> running;
+  uint32_t next = 0;
+  uint32_t done = 0;
+  uint32_t failed = 0;
+  while (done < pending.size ())
+    {
+      while (running.size () < jobs && next < pending.size ())
+        {
+          const SweepJob &job = pending[next++];
+          pid_t pid = StartJob (binary, points[job.point], job, common);
+          if (pid < 0)
+            {
+              std::cerr << "fork failed" << std::endl;
+              return 1;
+            }
+          running[pid] = job;
+        }
+      int status;
+      pid_t pid = wait (&status);
+      if (pid < 0)
+        {
+          break;
+        }
+      auto i = running.find (pid);
+      if (i == running.end ())
+        {
+          continue;
+        }
+      const SweepJob job = i->second;
+      running.erase (i);
+      ++done;
+      const SweepPoint &p = points[job.point];
+      if (WIFEXITED (status) && WEXITSTATUS (status) == 0)
+        {
+          std::map<std::string, double> metrics = ParseMetrics (job.outputFile);
+          NormalizeCounters (metrics);
+          for (const auto &metric : metrics)
+            {
+              results[job.point][metric.first].push_back (metric.second);
+            }
+        }
+      else
+        {
+          ++failed;
+          std::cerr << "Run " << job.run << " of " << p.protocol << " nNodes=" << p.nNodes
+                    << " malicious=" << p.malicious << " rreqBound=" << p.rreqBound
+                    << " distanceThreshold=" << p.distanceThreshold << " failed" << std::endl;
+        }
+      std::remove (job.outputFile.c_str ());
+      std::cout << "[" << done << "/" << pending.size () << "] " << p.protocol << " nNodes="
+                << p.nNodes << " malicious=" << p.malicious << " run=" << job.run << std::endl;
+    }
+
+  std::ofstream csv (output);
+  csv << "protocol,nNodes,malicious,rreqBound,distanceThreshold,metric,runs,mean,ci95" << std::endl;
+  csv << std::setprecision (10);
+  for (uint32_t i = 0; i < points.size (); ++i)
+    {
+      const SweepPoint &p = points[i];
+      for (const auto &metric : results[i])
+        {
+          const std::vector<double> &v = metric.second;
+          double sum = 0;
+          for (double x : v)
+            {
+              sum += x;
+            }
+          double mean = sum / v.size ();
+          double squares = 0;
+          for (double x : v)
+            {
+              squares += (x - mean) * (x - mean);
+            }
+          double ci = 0;
+          if (v.size () > 1)
+            {
+              ci = StudentT95 (v.size () - 1) * std::sqrt (squares / (v.size () - 1) / v.size ());
+            }
+          csv << p.protocol << "," << p.nNodes << "," << p.malicious << "," << p.rreqBound << ","
+              << p.distanceThreshold << ",\"" << metric.first << "\"," << v.size () << ","
+              << mean << "," << ci << std::endl;
+        }
+    }
+
+  std::cout << "Results written to " << output;
+  if (failed > 0)
+    {
+      std::cout << ", " << failed << " runs failed";
+    }
+  std::cout << std::endl;
+  return failed > 0 ? 1 : 0;
+}
@@ -9,12 +9,243 @@
 #include "ns3/applications-module.h"
 #include "ns3/flow-monitor-module.h"
 #include "ns3/system-wall-clock-ms.h"
+#include <sys/resource.h>
+#include <array>
 #include <chrono>
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <sstream>
 
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("OverheadTest");
 
+/*
+ * Machine-readable result of a run: the configuration and the metrics, in
+ * the order they were added, printed as one JSON object or as a CSV header
+ * line followed by one value line.
+ */
+class OverheadReport
+{
+public:
+  void AddConfig (const std::string &name, const std::string &value)
+  {
+    m_config.push_back ({name, value, true});
+  }
+  void AddConfig (const std::string &name, bool value)
+  {
+    m_config.push_back ({name, value ? "true" : "false", false});
+  }
+  template <typename T>
+  void AddConfig (const std::string &name, T value)
+  {
+    m_config.push_back ({name, Format (value), false});
+  }
+  template <typename T>
+  void AddMetric (const std::string &name, T value)
+  {
+    m_metrics.push_back ({name, Format (value), false});
+  }
+
+  void PrintJson (std::ostream &os) const
+  {
+    os << "{\n  \"config\": {";
+    PrintJsonFields (os, m_config);
+    os << "},\n  \"metrics\": {";
+    PrintJsonFields (os, m_metrics);
+    os << "}\n}" << std::endl;
+  }
+
+  void PrintCsv (std::ostream &os) const
+  {
+    std::string separator;
+    for (const auto &fields : {&m_config, &m_metrics})
+      {
+        for (const auto &f : *fields)
+          {
+            os << separator << f.name;
+            separator = ",";
+          }
+      }
+    os << std::endl;
+    separator = "";
+    for (const auto &fields : {&m_config, &m_metrics})
+      {
+        for (const auto &f : *fields)
+          {
+            os << separator << f.value;
+            separator = ",";
+          }
+      }
+    os << std::endl;
+  }
+
+private:
+  struct Field
+  {
+    std::string name;
+    std::string value;
+    bool quoted;
+  };
+
+  template <typename T>
+  static std::string Format (T value)
+  {
+    std::ostringstream oss;
+    oss << std::setprecision (10) << value;
+    return oss.str ();
+  }
+
+  static void PrintJsonFields (std::ostream &os, const std::vector<Field> &fields)
+  {
+    for (uint32_t i = 0; i < fields.size (); ++i)
+      {
+        os << (i == 0 ? "\n    \"" : ",\n    \"") << fields[i].name << "\": ";
+        if (fields[i].quoted)
+          {
+            os << "\"" << fields[i].value << "\"";
+          }
+        else
+          {
+            os << fields[i].value;
+          }
+      }
+    os << "\n  ";
+  }
+
+  std::vector<Field> m_config;
+  std::vector<Field> m_metrics;
+};
+
+/*
+ * Steady-state detector. Every interval it samples the PDR and the control
+ * packets sent per simulated second over that interval only: cumulative
+ * values are strongly autocorrelated and would look steady long before the
+ * network is. The samples are batch means of one interval each. Once the
+ * last 'window' samples of each have a 95% confidence interval narrower than
+ * 'tolerance' times their mean, the simulation is stopped early.
+ */
+class ConvergenceDetector
+{
+public:
+  ConvergenceDetector (Ptr<FlowMonitor> monitor, const AodvStatsHelper &stats, Time interval,
+                       uint32_t window, double tolerance, Time minTime)
+    : m_monitor (monitor),
+      m_stats (stats),
+      m_interval (interval),
+      m_window (window),
+      m_tolerance (tolerance),
+      m_minTime (minTime),
+      m_converged (false),
+      m_txPackets (0),
+      m_rxPackets (0),
+      m_controlPackets (0)
+  {
+  }
+
+  void Start ()
+  {
+    Simulator::Schedule (m_interval, &ConvergenceDetector::Sample, this);
+  }
+
+  bool HasConverged () const
+  {
+    return m_converged;
+  }
+
+private:
+  void Sample ()
+  {
+    uint64_t txPackets = 0;
+    uint64_t rxPackets = 0;
+    for (auto const &flow : m_monitor->GetFlowStats ())
+      {
+        txPackets += flow.second.txPackets;
+        rxPackets += flow.second.rxPackets;
+      }
+    AodvStats total = m_stats.GetTotal ();
+    uint64_t controlPackets = total.rreqSent + total.rrepSent + total.rerrSent;
+    // Packets still in flight at the end of an interval count in the next one
+    if (txPackets > m_txPackets)
+      {
+        AddSample (m_pdr, 100.0 * (rxPackets - m_rxPackets) / (txPackets - m_txPackets));
+      }
+    AddSample (m_controlRate,
+               (controlPackets - m_controlPackets) / m_interval.GetSeconds ());
+    m_txPackets = txPackets;
+    m_rxPackets = rxPackets;
+    m_controlPackets = controlPackets;
+
+    if (Simulator::Now () >= m_minTime && IsStable (m_pdr) && IsStable (m_controlRate))
+      {
+        NS_LOG_INFO ("Metrics converged at " << Simulator::Now ().As (Time::S));
+        m_converged = true;
+        Simulator::Stop ();
+        return;
+      }
+    Simulator::Schedule (m_interval, &ConvergenceDetector::Sample, this);
+  }
+
+  void AddSample (std::deque<double> &samples, double value) const
+  {
+    samples.push_back (value);
+    if (samples.size () > m_window)
+      {
+        samples.pop_front ();
+      }
+  }
+
+  bool IsStable (const std::deque<double> &samples) const
+  {
+    if (samples.size () < m_window || samples.size () < 2)
+      {
+        return false;
+      }
+    double sum = 0;
+    for (double x : samples)
+      {
+        sum += x;
+      }
+    double mean = sum / samples.size ();
+    double squares = 0;
+    for (double x : samples)
+      {
+        squares += (x - mean) * (x - mean);
+      }
+    double ci = StudentT95 (samples.size () - 1)
+                * std::sqrt (squares / (samples.size () - 1) / samples.size ());
+    return ci <= m_tolerance * std::fabs (mean);
+  }
+
+  /* Two-sided 95% quantile of Student's t distribution */
+  static double StudentT95 (uint32_t degreesOfFreedom)
+  {
+    static const double table[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                   2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                   2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                   2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    if (degreesOfFreedom <= sizeof (table) / sizeof (table[0]))
+      {
+        return table[degreesOfFreedom - 1];
+      }
+    return 1.960;
+  }
+
+  Ptr<FlowMonitor> m_monitor;
+  const AodvStatsHelper &m_stats;
+  Time m_interval;
+  uint32_t m_window;
+  double m_tolerance;
+  Time m_minTime;
+  bool m_converged;
+  uint64_t m_txPackets;
+  uint64_t m_rxPackets;
+  uint64_t m_controlPackets;
+  std::deque<double> m_pdr;
+  std::deque<double> m_controlRate;
+};
+
 int main (int argc, char *argv[])
 {
   std::string protocol = "AODV"; 
@@ -22,13 +253,62 @@ int main (int argc, char *argv[])
   bool malicious = false; 
   int nMalicious = 5; 
   double simulationTime = 100.0; 
+  bool compactHeaders = false;
+  uint32_t rreqBound = 2;
+  double distanceThreshold = 20.0;
+  std::string statsFile = "";
+  double statsInterval = 1.0;
+  bool statsBinary = false;
+  std::string eventSeries = "";
+  std::string footprintFile = "";
+  double footprintInterval = 0.0;
+  std::string eventLog = "";
+  double convergenceInterval = 0.0;
+  uint32_t convergenceWindow = 10;
+  double convergenceTolerance = 0.05;
+  double convergenceMinTime = 20.0;
+  std::string output = "text";
 
   CommandLine cmd;
   cmd.AddValue ("protocol", "Protocol to use (AODV, PAODV, TPAODV)", protocol);
   cmd.AddValue ("nNodes", "Number of nodes", nNodes);
   cmd.AddValue ("malicious", "Enable Blackhole Attack", malicious);
+  cmd.AddValue ("nMalicious", "Number of blackhole nodes when the attack is enabled", nMalicious);
+  cmd.AddValue ("simulationTime", "Simulated time in seconds", simulationTime);
+  cmd.AddValue ("compactHeaders", "Use the compact RREQ/RREP encoding", compactHeaders);
+  cmd.AddValue ("rreqBound", "PAODV/TPAODV: maximum number of neighbors a RREQ is sent to", rreqBound);
+  cmd.AddValue ("distanceThreshold", "PAODV/TPAODV: distance in meters below which neighbors are preferred",
+                distanceThreshold);
+  cmd.AddValue ("statsFile", "Stream per-node routing counter snapshots to this file", statsFile);
+  cmd.AddValue ("statsInterval", "Seconds between two counter snapshots", statsInterval);
+  cmd.AddValue ("statsBinary", "Write the counter snapshots in binary instead of CSV", statsBinary);
+  cmd.AddValue ("eventSeries", "Write the routing event counts per second to this CSV file "
+                "(needs a build with NS3_AODV_PROFILING)", eventSeries);
+  cmd.AddValue ("footprintFile", "Stream per-node routing state footprint samples to this file",
+                footprintFile);
+  cmd.AddValue ("footprintInterval", "Seconds between two footprint samples (0 disables them)",
+                footprintInterval);
+  cmd.AddValue ("eventLog", "Record the routing events of all nodes in this binary file, "
+                "see event_log_reader", eventLog);
+  cmd.AddValue ("convergenceInterval", "Length in seconds of the intervals over which the PDR and "
+                "control rate are sampled for the steady-state test (0 always runs the full "
+                "simulationTime)", convergenceInterval);
+  cmd.AddValue ("convergenceWindow", "Number of recent samples the steady-state test looks at",
+                convergenceWindow);
+  cmd.AddValue ("convergenceTolerance", "Stop once the 95% confidence interval of every sampled "
+                "metric is within this fraction of its mean", convergenceTolerance);
+  cmd.AddValue ("convergenceMinTime", "Seconds before which the run is never stopped early",
+                convergenceMinTime);
+  cmd.AddValue ("output", "Result format: text, json or csv", output);
   cmd.Parse (argc, argv);
 
+  NS_ABORT_MSG_IF (output != "text" && output != "json" && output != "csv",
+                   "Unknown output format " << output);
+  NS_ABORT_MSG_IF (malicious && (nMalicious < 0 || static_cast<uint32_t> (nMalicious) >= nNodes),
+                   "nMalicious must leave at least one benign node");
+  NS_ABORT_MSG_IF (convergenceInterval > 0 && convergenceWindow < 2,
+                   "convergenceWindow must be at least 2");
+
   NodeContainer nodes;
   nodes.Create (nNodes);
 
@@ -80,13 +360,17 @@ int main (int argc, char *argv[])
   if (protocol == "PAODV")
     {
       PAodvHelper paodvGood;
-      paodvGood.Set("RreqBound", UintegerValue(2)); 
+      paodvGood.Set("RreqBound", UintegerValue(rreqBound));
+      paodvGood.Set("DistanceThreshold", DoubleValue(distanceThreshold));
+      paodvGood.Set("CompactHeaders", BooleanValue(compactHeaders));
       stack.SetRoutingHelper (paodvGood);
       stack.Install (goodNodes);
 
       if (malicious) {
           PAodvHelper paodvBad;
-          paodvBad.Set("RreqBound", UintegerValue(2));
+          paodvBad.Set("RreqBound", UintegerValue(rreqBound));
+          paodvBad.Set("DistanceThreshold", DoubleValue(distanceThreshold));
+          paodvBad.Set("CompactHeaders", BooleanValue(compactHeaders));
           paodvBad.Set("IsMalicious", BooleanValue(true)); 
           stack.SetRoutingHelper (paodvBad);
           stack.Install (badNodes);
@@ -95,13 +379,17 @@ int main (int argc, char *argv[])
   else if (protocol == "TPAODV")
     {
       TpaodvHelper tpaodvGood;
-      tpaodvGood.Set("RreqBound", UintegerValue(2)); 
+      tpaodvGood.Set("RreqBound", UintegerValue(rreqBound));
+      tpaodvGood.Set("DistanceThreshold", DoubleValue(distanceThreshold));
+      tpaodvGood.Set("CompactHeaders", BooleanValue(compactHeaders));
       stack.SetRoutingHelper (tpaodvGood);
       stack.Install (goodNodes);
 
       if (malicious) {
           TpaodvHelper tpaodvBad;
-          tpaodvBad.Set("RreqBound", UintegerValue(2));
+          tpaodvBad.Set("RreqBound", UintegerValue(rreqBound));
+          tpaodvBad.Set("DistanceThreshold", DoubleValue(distanceThreshold));
+          tpaodvBad.Set("CompactHeaders", BooleanValue(compactHeaders));
           tpaodvBad.Set("IsMalicious", BooleanValue(true)); 
           stack.SetRoutingHelper (tpaodvBad);
           stack.Install (badNodes);
@@ -110,11 +398,13 @@ int main (int argc, char *argv[])
   else 
     {
       AodvHelper aodvGood;
+      aodvGood.Set("CompactHeaders", BooleanValue(compactHeaders));
       stack.SetRoutingHelper (aodvGood);
       stack.Install (goodNodes);
 
       if (malicious) {
           AodvHelper aodvBad;
+          aodvBad.Set("CompactHeaders", BooleanValue(compactHeaders));
           aodvBad.Set("IsMalicious", BooleanValue(true)); 
           stack.SetRoutingHelper (aodvBad);
           stack.Install (badNodes);
@@ -156,16 +446,46 @@ int main (int argc, char *argv[])
       clientApps.Stop (Seconds (simulationTime));
     }
 
+  AodvStatsHelper routingStats;
+  routingStats.Install (nodes);
+  if (!statsFile.empty ())
+    {
+      routingStats.EnableSnapshots (statsFile, Seconds (statsInterval),
+                                    statsBinary ? AodvStatsHelper::BINARY : AodvStatsHelper::CSV);
+    }
+  if (footprintInterval > 0)
+    {
+      routingStats.EnableFootprintSampling (footprintFile, Seconds (footprintInterval));
+    }
+  if (!eventLog.empty ())
+    {
+      routingStats.EnableEventLog (eventLog);
+    }
+  if (!eventSeries.empty ())
+    {
+      AodvProfiler::EnableEventSeries (eventSeries, Seconds (1));
+    }
+
   Simulator::Stop (Seconds (simulationTime));
   FlowMonitorHelper flowmon;
   Ptr<FlowMonitor> monitor = flowmon.InstallAll ();
 
+  ConvergenceDetector convergence (monitor, routingStats, Seconds (convergenceInterval),
+                                   convergenceWindow, convergenceTolerance,
+                                   Seconds (convergenceMinTime));
+  if (convergenceInterval > 0)
+    {
+      convergence.Start ();
+    }
+
   auto start = std::chrono::high_resolution_clock::now();
   Simulator::Run ();
 
   auto end = std::chrono::high_resolution_clock::now();
   std::chrono::duration<double> elapsed = end - start;
   double executionTime = elapsed.count();
+  uint64_t eventsProcessed = Simulator::GetEventCount ();
+  double stopTime = Simulator::Now ().GetSeconds ();
 
   uint32_t totalHops = 0;
   uint32_t totalFlows = 0;
@@ -190,54 +510,150 @@ int main (int argc, char *argv[])
   double avgHops = (totalFlows > 0) ? (double)totalHops / totalFlows : 0.0;
   double pdr = (totalTxPackets > 0) ? (double)totalRxPackets / totalTxPackets * 100.0 : 0.0;
 
-  uint32_t totalRreq = 0;
-  uint32_t totalRrep = 0;
-  uint32_t totalRerr = 0;
-  uint64_t totalBrokenLinks = 0;
-  uint32_t totalRreqRecv = 0;
-  uint32_t totalMaliciousDrops = 0; 
- 
-  for (uint32_t i = 0; i < nNodes; i++)
+  AodvStats total = routingStats.GetTotal ();
+  uint64_t totalRreq = total.rreqSent;
+  uint64_t totalRrep = total.rrepSent;
+  uint64_t totalRerr = total.rerrSent;
+  uint64_t totalBrokenLinks = total.brokenLinks;
+  uint64_t totalRreqRecv = total.rreqReceived;
+  uint64_t totalMaliciousDrops = total.maliciousDrops;
+  int64_t totalCompactSaved = total.compactBytesSaved;
+
+  uint64_t totalRreqActivity = totalRreq + totalRreqRecv;
+
+  uint64_t totalControlBytes = 0;
+  Time totalAirtime;
+  std::array<AodvStatsHelper::Airtime, AODV_CONTROL_TYPES> airtimes;
+  for (uint32_t t = 0; t < AODV_CONTROL_TYPES; ++t)
     {
-      Ptr<Ipv4> ipv4 = nodes.Get(i)->GetObject<Ipv4> ();
-      Ptr<Ipv4RoutingProtocol> proto = ipv4->GetRoutingProtocol ();
-      
-      if (protocol == "PAODV") {
-           Ptr<ns3::paodv::RoutingProtocol> p = DynamicCast<ns3::paodv::RoutingProtocol> (proto);
-           if (p) {
-               totalRreq += p->GetRreqSentCount ();
-               totalRrep += p->GetRrepSentCount ();
-               totalRerr += p->GetRerrSentCount ();
-               totalBrokenLinks += p->GetBrokenLinkCount (); 
-               totalRreqRecv += p->GetRreqReceivedCount();
-               totalMaliciousDrops += p->GetMaliciousDropCount(); 
-           }
-      }
-      else if (protocol == "TPAODV") {
-           Ptr<ns3::tpaodv::RoutingProtocol> p = DynamicCast<ns3::tpaodv::RoutingProtocol> (proto);
-           if (p) {
-               totalRreq += p->GetRreqSentCount ();
-               totalRrep += p->GetRrepSentCount ();
-               totalRerr += p->GetRerrSentCount ();
-               totalBrokenLinks += p->GetBrokenLinkCount (); 
-               totalRreqRecv += p->GetRreqReceivedCount();
-               totalMaliciousDrops += p->GetMaliciousDropCount();
-           }
-      }
-      else {
-           Ptr<ns3::aodv::RoutingProtocol> p = DynamicCast<ns3::aodv::RoutingProtocol> (proto);
-           if (p) {
-               totalRreq += p->GetRreqSentCount ();
-               totalRrep += p->GetRrepSentCount ();
-               totalRerr += p->GetRerrSentCount ();
-               totalBrokenLinks += p->GetBrokenLinkCount ();
-               totalRreqRecv += p->GetRreqReceivedCount();
-               totalMaliciousDrops += p->GetMaliciousDropCount();
-           }
-      }
+      airtimes[t] = routingStats.GetTotalAirtime (static_cast<AodvControlType> (t));
+      totalControlBytes += total.controlBytes[t];
+      totalAirtime += airtimes[t].duration;
+    }
+
+  AodvLatencyHistogram discovery = routingStats.GetTotalDiscoveryLatency ();
+  AodvLatencyHistogram trustDelay = routingStats.GetTotalTrustTestLatency ();
+  double totalLatency = discovery.GetMean ().GetSeconds () * discovery.GetCount ();
+  double trustShare = (totalLatency > 0)
+                        ? trustDelay.GetMean ().GetSeconds () * trustDelay.GetCount () / totalLatency * 100.0
+                        : 0.0;
+
+  uint64_t testsStarted = 0, testsPassed = 0, testsFailed = 0, testsUnanswered = 0;
+  uint64_t rrepsReleased = 0, rrepsDropped = 0;
+  for (uint32_t i = 0; i < nodes.GetN (); ++i)
+    {
+      Ptr<tpaodv::RoutingProtocol> tp = DynamicCast<tpaodv::RoutingProtocol> (
+        nodes.Get (i)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+      if (!tp)
+        {
+          continue;
+        }
+      testsStarted += tp->GetTrustTestStartedCount ();
+      testsPassed += tp->GetTrustTestPassedCount ();
+      testsFailed += tp->GetTrustTestFailedCount ();
+      testsUnanswered += tp->GetTrustTestUnansweredCount ();
+      rrepsReleased += tp->GetPendingRrepReleasedCount ();
+      rrepsDropped += tp->GetPendingRrepOverflowCount () + tp->GetPendingRrepTimeoutCount ()
+                      + tp->GetPendingRrepRejectedCount ();
+    }
+  AodvLatencyHistogram testDuration = routingStats.GetTotalTrustTestDuration ();
+  AodvTrustAccuracy accuracy = routingStats.GetTotalTrustAccuracy ();
+  AodvFootprint footprint = routingStats.GetTotalFootprint ();
+
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  uint64_t peakRssKb = usage.ru_maxrss;
+
+  if (output != "text")
+    {
+      OverheadReport report;
+      report.AddConfig ("protocol", protocol);
+      report.AddConfig ("nNodes", nNodes);
+      report.AddConfig ("malicious", malicious);
+      report.AddConfig ("nMalicious", malicious ? nMalicious : 0);
+      report.AddConfig ("simulationTime", simulationTime);
+      report.AddConfig ("compactHeaders", compactHeaders);
+      report.AddConfig ("rreqBound", rreqBound);
+      report.AddConfig ("distanceThreshold", distanceThreshold);
+      report.AddConfig ("convergenceInterval", convergenceInterval);
+      report.AddConfig ("convergenceWindow", convergenceWindow);
+      report.AddConfig ("convergenceTolerance", convergenceTolerance);
+      report.AddConfig ("seed", RngSeedManager::GetSeed ());
+      report.AddConfig ("run", RngSeedManager::GetRun ());
+
+      report.AddMetric ("rreqSent", totalRreq);
+      report.AddMetric ("rreqReceived", totalRreqRecv);
+      report.AddMetric ("rreqOverhead", totalRreqActivity);
+      report.AddMetric ("rrepSent", totalRrep);
+      report.AddMetric ("rerrSent", totalRerr);
+      report.AddMetric ("compactBytesSaved", totalCompactSaved);
+      for (uint32_t t = 0; t < AODV_CONTROL_TYPES; ++t)
+        {
+          std::string name = AodvControlTypeName (static_cast<AodvControlType> (t));
+          report.AddMetric (name + "Bytes", total.controlBytes[t]);
+          report.AddMetric (name + "Frames", airtimes[t].frames);
+          report.AddMetric (name + "Retries", airtimes[t].retries);
+          report.AddMetric (name + "AirtimeMs", airtimes[t].duration.GetSeconds () * 1000);
+        }
+      report.AddMetric ("controlBytes", totalControlBytes);
+      report.AddMetric ("controlAirtimeMs", totalAirtime.GetSeconds () * 1000);
+      report.AddMetric ("txPackets", totalTxPackets);
+      report.AddMetric ("rxPackets", totalRxPackets);
+      report.AddMetric ("pdr", pdr);
+      report.AddMetric ("brokenLinks", totalBrokenLinks);
+      report.AddMetric ("avgHopCount", avgHops);
+      report.AddMetric ("routeDiscoveries", discovery.GetCount ());
+      report.AddMetric ("discoveryMeanMs", discovery.GetMean ().GetSeconds () * 1000);
+      report.AddMetric ("discoveryP50Ms", discovery.GetQuantile (0.5).GetSeconds () * 1000);
+      report.AddMetric ("discoveryP90Ms", discovery.GetQuantile (0.9).GetSeconds () * 1000);
+      report.AddMetric ("discoveryMaxMs", discovery.GetMax ().GetSeconds () * 1000);
+      if (protocol == "TPAODV")
+        {
+          report.AddMetric ("heldForTrustTest", trustDelay.GetCount ());
+          report.AddMetric ("trustTestShare", trustShare);
+          report.AddMetric ("trustTestsStarted", testsStarted);
+          report.AddMetric ("trustTestsPassed", testsPassed);
+          report.AddMetric ("trustTestsFailed", testsFailed);
+          report.AddMetric ("trustTestsUnanswered", testsUnanswered);
+          report.AddMetric ("trustTestMeanMs", testDuration.GetMean ().GetSeconds () * 1000);
+          report.AddMetric ("trustTestP90Ms", testDuration.GetQuantile (0.9).GetSeconds () * 1000);
+          report.AddMetric ("heldRrepsReleased", rrepsReleased);
+          report.AddMetric ("heldRrepsDropped", rrepsDropped);
+          report.AddMetric ("truePositives", accuracy.truePositives);
+          report.AddMetric ("falsePositives", accuracy.falsePositives);
+          report.AddMetric ("trueNegatives", accuracy.trueNegatives);
+          report.AddMetric ("falseNegatives", accuracy.falseNegatives);
+          report.AddMetric ("truePositiveRate", accuracy.GetTruePositiveRate () * 100.0);
+          report.AddMetric ("falsePositiveRate", accuracy.GetFalsePositiveRate () * 100.0);
+        }
+      if (footprintInterval > 0)
+        {
+          for (uint32_t s = 0; s < AODV_STATE_STRUCTURES; ++s)
+            {
+              std::string name = AodvStateStructureName (static_cast<AodvStateStructure> (s));
+              report.AddMetric (name + "Entries", footprint.usage[s].entries);
+              report.AddMetric (name + "Bytes", footprint.usage[s].bytes);
+            }
+          report.AddMetric ("stateBytes", footprint.GetTotalBytes ());
+        }
+      report.AddMetric ("maliciousDrops", totalMaliciousDrops);
+      report.AddMetric ("stopTime", stopTime);
+      report.AddMetric ("converged", convergence.HasConverged ());
+      report.AddMetric ("executionTime", executionTime);
+      report.AddMetric ("eventsProcessed", eventsProcessed);
+      report.AddMetric ("peakRssKb", peakRssKb);
+
+      if (output == "json")
+        {
+          report.PrintJson (std::cout);
+        }
+      else
+        {
+          report.PrintCsv (std::cout);
+        }
+      Simulator::Destroy ();
+      return 0;
     }
-  
-  uint32_t totalRreqActivity = totalRreq + totalRreqRecv;
 
 std::cout << "========= RESULTS (" << protocol << ", Malicious=" << malicious << ") =========" << std::endl;
   std::cout << "Nodes: " << nNodes << std::endl;
@@ -249,18 +665,79 @@ std::cout << "========= RESULTS (" << protocol << ", Malicious=" << malicious <<
   
   std::cout << "Total RREP Sent:      " << totalRrep << " packets" << std::endl;
   std::cout << "Total RERR Sent:      " << totalRerr << " packets" << std::endl;
+  if (compactHeaders)
+    {
+      std::cout << "COMPACT BYTES SAVED:  " << totalCompactSaved << " bytes" << std::endl;
+    }
+
 
+  std::cout << "----------------------------------------" << std::endl;
+  std::cout << "CONTROL     BYTES    FRAMES  RETRIES  AIRTIME" << std::endl;
+  for (uint32_t t = 0; t < AODV_CONTROL_TYPES; ++t)
+    {
+      std::cout << std::left << std::setw (10) << AodvControlTypeName (static_cast<AodvControlType> (t))
+                << std::right
+                << std::setw (7) << total.controlBytes[t]
+                << std::setw (10) << airtimes[t].frames
+                << std::setw (9) << airtimes[t].retries
+                << std::setw (9) << airtimes[t].duration.GetSeconds () * 1000 << " ms" << std::endl;
+    }
+  std::cout << "TOTAL CONTROL BYTES:  " << totalControlBytes << " bytes" << std::endl;
+  std::cout << "TOTAL CONTROL AIRTIME: " << totalAirtime.GetSeconds () * 1000 << " ms" << std::endl;
+  std::cout << "----------------------------------------" << std::endl;
   std::cout << "PDR:                  " << pdr << " %" << std::endl;
   
   std::cout << "----------------------------------------" << std::endl;
   std::cout << "TOTAL BROKEN LINKS:   " << totalBrokenLinks << " links" << std::endl;
   std::cout << "AVERAGE HOP COUNT:    " << avgHops << " hops" << std::endl;
   std::cout << "----------------------------------------" << std::endl;
+
+  std::cout << "ROUTE DISCOVERIES:    " << discovery.GetCount () << std::endl;
+  std::cout << "DISCOVERY MEAN:       " << discovery.GetMean ().GetSeconds () * 1000 << " ms" << std::endl;
+  std::cout << "DISCOVERY P50:        " << discovery.GetQuantile (0.5).GetSeconds () * 1000 << " ms" << std::endl;
+  std::cout << "DISCOVERY P90:        " << discovery.GetQuantile (0.9).GetSeconds () * 1000 << " ms" << std::endl;
+  std::cout << "DISCOVERY MAX:        " << discovery.GetMax ().GetSeconds () * 1000 << " ms" << std::endl;
+  if (protocol == "TPAODV")
+    {
+      std::cout << "HELD FOR TRUST TEST:  " << trustDelay.GetCount () << " discoveries" << std::endl;
+      std::cout << "TRUST TEST SHARE:     " << trustShare << " %" << std::endl;
+      std::cout << "----------------------------------------" << std::endl;
+      std::cout << "TRUST TESTS STARTED:  " << testsStarted << std::endl;
+      std::cout << "TRUST TESTS PASSED:   " << testsPassed << std::endl;
+      std::cout << "TRUST TESTS FAILED:   " << testsFailed << std::endl;
+      std::cout << "TRUST TESTS NO REPLY: " << testsUnanswered << std::endl;
+      std::cout << "TRUST TEST MEAN:      " << testDuration.GetMean ().GetSeconds () * 1000 << " ms" << std::endl;
+      std::cout << "TRUST TEST P90:       " << testDuration.GetQuantile (0.9).GetSeconds () * 1000 << " ms" << std::endl;
+      std::cout << "HELD RREPS RELEASED:  " << rrepsReleased << " packets" << std::endl;
+      std::cout << "HELD RREPS DROPPED:   " << rrepsDropped << " packets" << std::endl;
+      std::cout << "VERDICTS TP/FP/TN/FN: " << accuracy.truePositives << "/" << accuracy.falsePositives
+                << "/" << accuracy.trueNegatives << "/" << accuracy.falseNegatives << std::endl;
+      std::cout << "TRUE POSITIVE RATE:   " << accuracy.GetTruePositiveRate () * 100.0 << " %" << std::endl;
+      std::cout << "FALSE POSITIVE RATE:  " << accuracy.GetFalsePositiveRate () * 100.0 << " %" << std::endl;
+    }
+  std::cout << "----------------------------------------" << std::endl;
+  if (footprintInterval > 0)
+    {
+      std::cout << "STATE                 ENTRIES      BYTES" << std::endl;
+      for (uint32_t s = 0; s < AODV_STATE_STRUCTURES; ++s)
+        {
+          std::cout << std::left << std::setw (20)
+                    << AodvStateStructureName (static_cast<AodvStateStructure> (s)) << std::right
+                    << std::setw (9) << footprint.usage[s].entries
+                    << std::setw (11) << footprint.usage[s].bytes << std::endl;
+        }
+      std::cout << "TOTAL STATE BYTES:    " << footprint.GetTotalBytes () << " bytes" << std::endl;
+      std::cout << "----------------------------------------" << std::endl;
+    }
   
   std::cout << "PACKET DROPPED        " << totalMaliciousDrops << " packets" << std::endl;
   std::cout << "BY ATTACK" << std::endl;
   std::cout << "----------------------------------------" << std::endl;
+  std::cout << "STOPPED AT:           " << stopTime << " s ("
+            << (convergence.HasConverged () ? "converged" : "time limit") << ")" << std::endl;
   std::cout << "TIME:                 " << executionTime << " s" << std::endl;
+  std::cout << "EVENTS PROCESSED:     " << eventsProcessed << std::endl;
+  std::cout << "PEAK RSS:             " << peakRssKb << " KiB" << std::endl;
   std::cout << "========================================" << std::endl;
 
   Simulator::Destroy ();
@@ -0,0 +1,90 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/aodv-module.h"
+#include "ns3/paodv-module.h"
+#include "ns3/tpaodv-module.h"
+#include <chrono>
+#include <iomanip>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("RerrBench");
+
+/*
+ * Micro-benchmark of RERR construction and (de)serialization.
+ *
+ * For every destination count the header is filled with addresses in
+ * decreasing order (worst case for the sorted destination list), added to
+ * a packet and parsed back. Times are reported in nanoseconds per message.
+ */
+
+template <typename RerrHeaderT>
+static void
+RunRerrBench (const std::string &protocol, uint32_t nDest, uint32_t iterations)
+{
+  uint64_t checksum = 0;
+
+  auto t0 = std::chrono::high_resolution_clock::now ();
+  for (uint32_t it = 0; it < iterations; ++it)
+    {
+      RerrHeaderT h;
+      for (uint32_t k = nDest; k > 0; --k)
+        {
+          h.AddUnDestination (Ipv4Address (0x0a000000 + k), k + it);
+        }
+      checksum += h.GetDestCount ();
+    }
+  auto t1 = std::chrono::high_resolution_clock::now ();
+
+  RerrHeaderT h;
+  for (uint32_t k = nDest; k > 0; --k)
+    {
+      h.AddUnDestination (Ipv4Address (0x0a000000 + k), k);
+    }
+  auto t2 = std::chrono::high_resolution_clock::now ();
+  for (uint32_t it = 0; it < iterations; ++it)
+    {
+      Ptr<Packet> p = Create<Packet> ();
+      p->AddHeader (h);
+      RerrHeaderT h2;
+      checksum += p->RemoveHeader (h2);
+    }
+  auto t3 = std::chrono::high_resolution_clock::now ();
+
+  double build = std::chrono::duration<double, std::nano> (t1 - t0).count () / iterations;
+  double serdes = std::chrono::duration<double, std::nano> (t3 - t2).count () / iterations;
+
+  std::cout << std::left << std::setw (8) << protocol
+            << std::right << std::setw (6) << nDest
+            << std::setw (14) << std::fixed << std::setprecision (1) << build
+            << std::setw (14) << serdes
+            << std::setw (12) << h.GetSerializedSize ()
+            << "   (" << checksum << ")" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t iterations = 20000;
+
+  CommandLine cmd;
+  cmd.AddValue ("iterations", "Number of messages built per destination count", iterations);
+  cmd.Parse (argc, argv);
+
+  std::vector<uint32_t> counts = {1, 2, 4, 8, 16, 32, 64, 128, 255};
+
+  std::cout << "PROTO     DEST   BUILD ns/op  SERDES ns/op       BYTES" << std::endl;
+  for (uint32_t n : counts)
+    {
+      RunRerrBench<aodv::RerrHeader> ("AODV", n, iterations);
+    }
+  for (uint32_t n : counts)
+    {
+      RunRerrBench<paodv::RerrHeader> ("PAODV", n, iterations);
+    }
+  for (uint32_t n : counts)
+    {
+      RunRerrBench<tpaodv::RerrHeader> ("TPAODV", n, iterations);
+    }
+
+  return 0;
+}
@@ -0,0 +1,303 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/aodv-module.h"
+#include "ns3/paodv-module.h"
+#include "ns3/tpaodv-module.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("RoutingBench");
+
+/*
+ * Micro-benchmark of the routing data structures of AODV, PAODV and TPAODV.
+ *
+ * Every structure is exercised directly, without a network: the routing
+ * table (AddRoute, LookupRoute, Update, Purge) at 10 to 10000 entries, the
+ * neighbor list (Update, Purge), the request queue (Enqueue, Dequeue), the
+ * RREQ ID cache (IsDuplicate) and the serialization and deserialization of
+ * every message header. Simulated time stands still, so Purge measures the
+ * scan of live entries, which is its cost on every lookup. Times are
+ * reported in nanoseconds per operation; N is the number of entries, or the
+ * serialized size in bytes for the headers.
+ */
+
+static uint64_t g_checksum = 0;
+
+template <typename F>
+static double
+NsPerOp (uint64_t ops, F body)
+{
+  auto t0 = std::chrono::steady_clock::now ();
+  body ();
+  auto t1 = std::chrono::steady_clock::now ();
+  return std::chrono::duration<double, std::nano> (t1 - t0).count () / ops;
+}
+
+static void
+Report (const std::string &protocol, const std::string &structure, const std::string &operation,
+        uint32_t n, double nsPerOp)
+{
+  std::cout << std::left << std::setw (8) << protocol
+            << std::setw (18) << structure
+            << std::setw (14) << operation
+            << std::right << std::setw (7) << n
+            << std::setw (14) << std::fixed << std::setprecision (1) << nsPerOp << std::endl;
+}
+
+static Ipv4Address
+Address (uint32_t i)
+{
+  return Ipv4Address (0x0a000001 + i);
+}
+
+template <typename RoutingTableT, typename RoutingTableEntryT>
+static void
+BenchRoutingTable (const std::string &protocol, uint32_t n, uint32_t iterations)
+{
+  uint32_t rounds = std::max (1u, iterations / n);
+  double add = NsPerOp (uint64_t (rounds) * n, [&] () {
+    for (uint32_t r = 0; r < rounds; ++r)
+      {
+        RoutingTableT table (Seconds (3));
+        for (uint32_t i = 0; i < n; ++i)
+          {
+            RoutingTableEntryT entry (nullptr, Address (i), true, i, Ipv4InterfaceAddress (), 1,
+                                      Address (i), Seconds (100));
+            g_checksum += table.AddRoute (entry);
+          }
+      }
+  });
+  Report (protocol, "RoutingTable", "AddRoute", n, add);
+
+  RoutingTableT table (Seconds (3));
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      RoutingTableEntryT entry (nullptr, Address (i), true, i, Ipv4InterfaceAddress (), 1,
+                                Address (i), Seconds (100));
+      table.AddRoute (entry);
+    }
+  double lookup = NsPerOp (iterations, [&] () {
+    RoutingTableEntryT entry;
+    for (uint32_t it = 0; it < iterations; ++it)
+      {
+        g_checksum += table.LookupRoute (Address ((it * 7919) % n), entry);
+      }
+  });
+  Report (protocol, "RoutingTable", "LookupRoute", n, lookup);
+
+  double update = NsPerOp (iterations, [&] () {
+    for (uint32_t it = 0; it < iterations; ++it)
+      {
+        uint32_t i = (it * 7919) % n;
+        RoutingTableEntryT entry (nullptr, Address (i), true, i + it, Ipv4InterfaceAddress (), 2,
+                                  Address (i), Seconds (100));
+        g_checksum += table.Update (entry);
+      }
+  });
+  Report (protocol, "RoutingTable", "Update", n, update);
+
+  double purge = NsPerOp (rounds, [&] () {
+    for (uint32_t r = 0; r < rounds; ++r)
+      {
+        table.Purge ();
+      }
+  });
+  Report (protocol, "RoutingTable", "Purge", n, purge);
+}
+
+template <typename NeighborsT>
+static void
+BenchNeighbors (const std::string &protocol, uint32_t n, uint32_t iterations)
+{
+  NeighborsT neighbors (Seconds (1));
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      neighbors.Update (Address (i), Seconds (100));
+    }
+  double update = NsPerOp (iterations, [&] () {
+    for (uint32_t it = 0; it < iterations; ++it)
+      {
+        neighbors.Update (Address ((it * 7919) % n), Seconds (100));
+      }
+  });
+  Report (protocol, "Neighbors", "Update", n, update);
+
+  uint32_t rounds = std::max (1u, iterations / n);
+  double purge = NsPerOp (rounds, [&] () {
+    for (uint32_t r = 0; r < rounds; ++r)
+      {
+        neighbors.Purge ();
+      }
+  });
+  Report (protocol, "Neighbors", "Purge", n, purge);
+}
+
+template <typename RequestQueueT, typename QueueEntryT>
+static void
+BenchRequestQueue (const std::string &protocol, uint32_t n, uint32_t iterations)
+{
+  std::vector<QueueEntryT> entries;
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Ipv4Header header;
+      header.SetDestination (Address (i));
+      entries.emplace_back (Create<Packet> (64), header);
+    }
+  uint32_t rounds = std::max (1u, iterations / n);
+  RequestQueueT queue (n, Seconds (30));
+  double enqueue = 0;
+  double dequeue = 0;
+  for (uint32_t r = 0; r < rounds; ++r)
+    {
+      enqueue += NsPerOp (uint64_t (rounds) * n, [&] () {
+        for (auto &entry : entries)
+          {
+            g_checksum += queue.Enqueue (entry);
+          }
+      });
+      // Oldest destinations first, the usual order of route discoveries
+      dequeue += NsPerOp (uint64_t (rounds) * n, [&] () {
+        QueueEntryT entry;
+        for (uint32_t i = 0; i < n; ++i)
+          {
+            g_checksum += queue.Dequeue (Address (i), entry);
+          }
+      });
+    }
+  Report (protocol, "RequestQueue", "Enqueue", n, enqueue);
+  Report (protocol, "RequestQueue", "Dequeue", n, dequeue);
+}
+
+template <typename IdCacheT>
+static void
+BenchIdCache (const std::string &protocol, uint32_t n, uint32_t iterations)
+{
+  IdCacheT cache (Seconds (100));
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      cache.IsDuplicate (Address (i % 16), i);
+    }
+  double hit = NsPerOp (iterations, [&] () {
+    for (uint32_t it = 0; it < iterations; ++it)
+      {
+        uint32_t i = (it * 7919) % n;
+        g_checksum += cache.IsDuplicate (Address (i % 16), i);
+      }
+  });
+  Report (protocol, "IdCache", "IsDuplicate", n, hit);
+}
+
+template <typename HeaderT>
+static void
+BenchHeader (const std::string &protocol, const std::string &name, const HeaderT &h,
+             uint32_t iterations)
+{
+  Ptr<Packet> p = Create<Packet> ();
+  double serialize = NsPerOp (iterations, [&] () {
+    for (uint32_t it = 0; it < iterations; ++it)
+      {
+        Ptr<Packet> q = Create<Packet> ();
+        q->AddHeader (h);
+        g_checksum += q->GetSize ();
+      }
+  });
+  p->AddHeader (h);
+  double deserialize = NsPerOp (iterations, [&] () {
+    for (uint32_t it = 0; it < iterations; ++it)
+      {
+        HeaderT h2;
+        g_checksum += p->PeekHeader (h2);
+      }
+  });
+  Report (protocol, name, "Serialize", h.GetSerializedSize (), serialize);
+  Report (protocol, name, "Deserialize", h.GetSerializedSize (), deserialize);
+}
+
+template <typename TypeHeaderT, typename RreqHeaderT, typename RrepHeaderT,
+          typename RrepAckHeaderT, typename RerrHeaderT>
+static void
+BenchHeaders (const std::string &protocol, uint32_t iterations)
+{
+  BenchHeader (protocol, "TypeHeader", TypeHeaderT (), iterations);
+  BenchHeader (protocol, "RreqHeader",
+               RreqHeaderT (0, 0, 3, 42, Address (1), 7, Address (2), 9), iterations);
+  BenchHeader (protocol, "RrepHeader",
+               RrepHeaderT (0, 3, Address (1), 7, Address (2), Seconds (3)), iterations);
+  BenchHeader (protocol, "RrepAckHeader", RrepAckHeaderT (), iterations);
+  RerrHeaderT rerr;
+  for (uint32_t k = 0; k < 8; ++k)
+    {
+      rerr.AddUnDestination (Address (k), k);
+    }
+  BenchHeader (protocol, "RerrHeader", rerr, iterations);
+}
+
+template <typename RoutingTableT, typename RoutingTableEntryT, typename NeighborsT,
+          typename RequestQueueT, typename QueueEntryT, typename IdCacheT>
+static void
+BenchStructures (const std::string &protocol, uint32_t iterations)
+{
+  for (uint32_t n : {10, 100, 1000, 10000})
+    {
+      BenchRoutingTable<RoutingTableT, RoutingTableEntryT> (protocol, n, iterations);
+    }
+  for (uint32_t n : {10, 100, 1000})
+    {
+      BenchNeighbors<NeighborsT> (protocol, n, iterations);
+    }
+  for (uint32_t n : {16, 64, 256})
+    {
+      BenchRequestQueue<RequestQueueT, QueueEntryT> (protocol, n, iterations);
+    }
+  for (uint32_t n : {10, 100, 1000})
+    {
+      BenchIdCache<IdCacheT> (protocol, n, iterations);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t iterations = 100000;
+  std::string protocol = "";
+
+  CommandLine cmd;
+  cmd.AddValue ("iterations", "Number of operations timed per measurement", iterations);
+  cmd.AddValue ("protocol", "Benchmark only this module (AODV, PAODV, TPAODV)", protocol);
+  cmd.Parse (argc, argv);
+
+  std::cout << "PROTO   STRUCTURE         OPERATION           N         ns/op" << std::endl;
+  if (protocol.empty () || protocol == "AODV")
+    {
+      BenchStructures<aodv::RoutingTable, aodv::RoutingTableEntry, aodv::Neighbors,
+                      aodv::RequestQueue, aodv::QueueEntry, aodv::IdCache> ("AODV", iterations);
+      BenchHeaders<aodv::TypeHeader, aodv::RreqHeader, aodv::RrepHeader, aodv::RrepAckHeader,
+                   aodv::RerrHeader> ("AODV", iterations);
+    }
+  if (protocol.empty () || protocol == "PAODV")
+    {
+      BenchStructures<paodv::RoutingTable, paodv::RoutingTableEntry, paodv::Neighbors,
+                      paodv::RequestQueue, paodv::QueueEntry, paodv::IdCache> ("PAODV", iterations);
+      BenchHeaders<paodv::TypeHeader, paodv::RreqHeader, paodv::RrepHeader, paodv::RrepAckHeader,
+                   paodv::RerrHeader> ("PAODV", iterations);
+    }
+  if (protocol.empty () || protocol == "TPAODV")
+    {
+      BenchStructures<tpaodv::RoutingTable, tpaodv::RoutingTableEntry, tpaodv::Neighbors,
+                      tpaodv::RequestQueue, tpaodv::QueueEntry, tpaodv::IdCache> ("TPAODV", iterations);
+      BenchHeaders<tpaodv::TypeHeader, tpaodv::RreqHeader, tpaodv::RrepHeader,
+                   tpaodv::RrepAckHeader, tpaodv::RerrHeader> ("TPAODV", iterations);
+      tpaodv::TrustDigestHeader digest;
+      for (uint32_t k = 0; k < 8; ++k)
+        {
+          digest.AddVerdict (Address (k), 2, k);
+        }
+      BenchHeader ("TPAODV", "TrustDigestHeader", digest, iterations);
+    }
+  std::cout << "(" << g_checksum << ")" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,285 @@
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/aodv-module.h"
+#include "ns3/paodv-module.h"
+#include "ns3/tpaodv-module.h"
+#include "ns3/applications-module.h"
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("ScalingBench");
+
+/*
+ * Scaling benchmark of AODV, PAODV and TPAODV.
+ *
+ * Every protocol runs at every node count with a constant node density: the
+ * side of the square area grows with the square root of the node count, and
+ * one UDP echo flow is started per five nodes. Nodes either stand on a grid,
+ * as in paodv-example, or move with the random waypoint model of
+ * overhead_test. Each point runs in its own process, one after the other, so
+ * that the peak RSS and the wall-clock time belong to that point alone.
+ *
+ * For every point the benchmark reports the wall-clock time per simulated
+ * second, the simulator events processed per wall-clock second, the peak
+ * RSS and the control messages and bytes sent per node and simulated second.
+ */
+
+struct ScalingResult
+{
+  double wallSeconds;
+  uint64_t events;
+  uint64_t peakRssKb;
+  uint64_t controlPackets;
+  uint64_t controlBytes;
+};
+
+static ScalingResult
+RunScenario (const std::string &protocol, uint32_t nNodes, double simulationTime,
+             double density, const std::string &layout)
+{
+  // density is in nodes per square kilometer
+  double side = 1000.0 * std::sqrt (nNodes / density);
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211b);
+  YansWifiPhyHelper wifiPhy;
+  YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default ();
+  wifiPhy.SetChannel (wifiChannel.Create ());
+  WifiMacHelper wifiMac;
+  wifiMac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (wifiPhy, wifiMac, nodes);
+
+  MobilityHelper mobility;
+  if (layout == "grid")
+    {
+      uint32_t width = std::ceil (std::sqrt (nNodes));
+      double step = side / width;
+      mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                     "MinX", DoubleValue (0.0),
+                                     "MinY", DoubleValue (0.0),
+                                     "DeltaX", DoubleValue (step),
+                                     "DeltaY", DoubleValue (step),
+                                     "GridWidth", UintegerValue (width),
+                                     "LayoutType", StringValue ("RowFirst"));
+      mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+    }
+  else
+    {
+      std::ostringstream range;
+      range << "ns3::UniformRandomVariable[Min=0.0|Max=" << side << "]";
+      ObjectFactory pos;
+      pos.SetTypeId ("ns3::RandomRectanglePositionAllocator");
+      pos.Set ("X", StringValue (range.str ()));
+      pos.Set ("Y", StringValue (range.str ()));
+      Ptr<PositionAllocator> positionAlloc = pos.Create ()->GetObject<PositionAllocator> ();
+      mobility.SetPositionAllocator (positionAlloc);
+      mobility.SetMobilityModel ("ns3::RandomWaypointMobilityModel",
+                                 "Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"),
+                                 "Pause", StringValue ("ns3::ConstantRandomVariable[Constant=2.0]"),
+                                 "PositionAllocator", PointerValue (positionAlloc));
+    }
+  mobility.Install (nodes);
+
+  InternetStackHelper stack;
+  AodvHelper aodv;
+  PAodvHelper paodv;
+  TpaodvHelper tpaodv;
+  if (protocol == "PAODV")
+    {
+      stack.SetRoutingHelper (paodv);
+    }
+  else if (protocol == "TPAODV")
+    {
+      stack.SetRoutingHelper (tpaodv);
+    }
+  else
+    {
+      stack.SetRoutingHelper (aodv);
+    }
+  stack.Install (nodes);
+
+  Ipv4AddressHelper address;
+  address.SetBase ("10.1.0.0", "255.255.0.0");
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+
+  uint16_t port = 9;
+  UdpEchoServerHelper echoServer (port);
+  ApplicationContainer serverApps = echoServer.Install (nodes);
+  serverApps.Start (Seconds (1.0));
+  serverApps.Stop (Seconds (simulationTime));
+
+  UdpEchoClientHelper echoClient (Ipv4Address ("0.0.0.0"), port);
+  echoClient.SetAttribute ("MaxPackets", UintegerValue (1000));
+  echoClient.SetAttribute ("Interval", TimeValue (Seconds (1.0)));
+  echoClient.SetAttribute ("PacketSize", UintegerValue (1024));
+
+  Ptr<UniformRandomVariable> urng = CreateObject<UniformRandomVariable> ();
+  uint32_t nFlows = std::max (1u, nNodes / 5);
+  for (uint32_t i = 0; i < nFlows; ++i)
+    {
+      uint32_t srcNode = urng->GetInteger (0, nNodes - 1);
+      uint32_t dstNode = urng->GetInteger (0, nNodes - 1);
+      while (srcNode == dstNode)
+        {
+          dstNode = urng->GetInteger (0, nNodes - 1);
+        }
+      echoClient.SetAttribute ("Remote",
+                               AddressValue (InetSocketAddress (interfaces.GetAddress (dstNode), port)));
+      ApplicationContainer clientApps = echoClient.Install (nodes.Get (srcNode));
+      // Spread the flow starts over the first ten seconds
+      clientApps.Start (Seconds (2.0 + 10.0 * i / nFlows));
+      clientApps.Stop (Seconds (simulationTime));
+    }
+
+  AodvStatsHelper routingStats;
+  routingStats.Install (nodes);
+
+  Simulator::Stop (Seconds (simulationTime));
+  auto start = std::chrono::steady_clock::now ();
+  Simulator::Run ();
+  auto end = std::chrono::steady_clock::now ();
+
+  ScalingResult result;
+  result.wallSeconds = std::chrono::duration<double> (end - start).count ();
+  result.events = Simulator::GetEventCount ();
+  AodvStats total = routingStats.GetTotal ();
+  result.controlPackets = total.rreqSent + total.rrepSent + total.rerrSent;
+  result.controlBytes = 0;
+  for (uint64_t bytes : total.controlBytes)
+    {
+      result.controlBytes += bytes;
+    }
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  result.peakRssKb = usage.ru_maxrss;
+
+  Simulator::Destroy ();
+  return result;
+}
+
+/* Run a scenario in a child process and collect its result */
+static bool
+RunIsolated (const std::string &protocol, uint32_t nNodes, double simulationTime,
+             double density, const std::string &layout, ScalingResult &result)
+{
+  int fds[2];
+  if (pipe (fds) != 0)
+    {
+      return false;
+    }
+  std::cout.flush ();
+  pid_t pid = fork ();
+  if (pid < 0)
+    {
+      close (fds[0]);
+      close (fds[1]);
+      return false;
+    }
+  if (pid == 0)
+    {
+      close (fds[0]);
+      ScalingResult r = RunScenario (protocol, nNodes, simulationTime, density, layout);
+      bool ok = write (fds[1], &r, sizeof (r)) == sizeof (r);
+      close (fds[1]);
+      _exit (ok ? 0 : 1);
+    }
+  close (fds[1]);
+  bool ok = read (fds[0], &result, sizeof (result)) == sizeof (result);
+  close (fds[0]);
+  int status;
+  waitpid (pid, &status, 0);
+  return ok && WIFEXITED (status) && WEXITSTATUS (status) == 0;
+}
+
+static std::vector<std::string>
+SplitList (const std::string &list)
+{
+  std::vector<std::string> values;
+  std::stringstream ss (list);
+  std::string value;
+  while (std::getline (ss, value, ','))
+    {
+      if (!value.empty ())
+        {
+          values.push_back (value);
+        }
+    }
+  return values;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string protocols = "AODV,PAODV,TPAODV";
+  std::string nodeCounts = "50,100,250,500,1000,2000,5000";
+  double simulationTime = 30.0;
+  double density = 200.0;
+  std::string layout = "waypoint";
+  std::string csvFile = "";
+
+  CommandLine cmd;
+  cmd.AddValue ("protocols", "Protocols to run", protocols);
+  cmd.AddValue ("nodes", "Node counts to run", nodeCounts);
+  cmd.AddValue ("simulationTime", "Simulated time of every run, in seconds", simulationTime);
+  cmd.AddValue ("density", "Nodes per square kilometer", density);
+  cmd.AddValue ("layout", "Node placement: waypoint (moving) or grid (static)", layout);
+  cmd.AddValue ("csv", "Also write the results to this CSV file", csvFile);
+  cmd.Parse (argc, argv);
+
+  std::ofstream csv;
+  if (!csvFile.empty ())
+    {
+      csv.open (csvFile);
+      csv << "protocol,nNodes,layout,simulationTime,wallPerSimSecond,eventsPerSecond,peakRssKb,"
+             "controlPacketsPerNodeSecond,controlBytesPerNodeSecond" << std::endl;
+    }
+
+  std::cout << "PROTO    NODES  WALL s/s    EVENTS/s   RSS MiB  CTRL pkt/n/s  CTRL B/n/s" << std::endl;
+  for (const auto &protocol : SplitList (protocols))
+    {
+      for (const auto &count : SplitList (nodeCounts))
+        {
+          uint32_t nNodes = std::stoul (count);
+          ScalingResult r;
+          if (!RunIsolated (protocol, nNodes, simulationTime, density, layout, r))
+            {
+              std::cout << std::left << std::setw (8) << protocol << std::right << std::setw (6)
+                        << nNodes << "  failed" << std::endl;
+              continue;
+            }
+          double wallPerSimSecond = r.wallSeconds / simulationTime;
+          double eventsPerSecond = (r.wallSeconds > 0) ? r.events / r.wallSeconds : 0;
+          double packetsPerNode = static_cast<double> (r.controlPackets) / nNodes / simulationTime;
+          double bytesPerNode = static_cast<double> (r.controlBytes) / nNodes / simulationTime;
+          std::cout << std::left << std::setw (8) << protocol << std::right
+                    << std::setw (6) << nNodes
+                    << std::fixed << std::setprecision (3)
+                    << std::setw (10) << wallPerSimSecond
+                    << std::setprecision (0) << std::setw (12) << eventsPerSecond
+                    << std::setprecision (1) << std::setw (10) << r.peakRssKb / 1024.0
+                    << std::setprecision (2) << std::setw (14) << packetsPerNode
+                    << std::setprecision (1) << std::setw (12) << bytesPerNode << std::endl;
+          if (csv.is_open ())
+            {
+              csv << protocol << "," << nNodes << "," << layout << "," << simulationTime << ","
+                  << wallPerSimSecond << "," << eventsPerSecond << "," << r.peakRssKb << ","
+                  << packetsPerNode << "," << bytesPerNode << std::endl;
+            }
+        }
+    }
+  return 0;
+}
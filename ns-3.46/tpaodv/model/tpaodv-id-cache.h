@@ -17,6 +17,7 @@
 #ifndef TPAODV_ID_CACHE_H
 #define TPAODV_ID_CACHE_H
 
+#include "ns3/aodv-stats.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/simulator.h"
 
@@ -56,6 +57,10 @@ class IdCache
      * @returns number of entries in cache
      */
     uint32_t GetSize();
+    /**
+     * @returns the entries and approximate bytes of the cache, expired entries included
+     */
+    AodvMemoryUsage GetMemoryUsage() const;
 
     /**
      * Set lifetime for future added entries.
@@ -22,7 +22,7 @@
 #include "ns3/nstime.h"
 
 #include <iostream>
-#include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -299,6 +299,35 @@ class RreqHeader : public Header
      */
     bool GetUnknownSeqno() const;
 
+    /**
+     * @brief Select the compact encoding
+     *
+     * The compact encoding packs the G, D and U flags and a hop count below 16 into one byte
+     * and writes the RREQ ID and both sequence numbers as variable-length integers. It is not
+     * part of RFC 3561, so every node of the network has to use it.
+     *
+     * @param f true to use the compact encoding
+     */
+    void SetCompact(bool f)
+    {
+        m_compact = f;
+    }
+
+    /**
+     * @brief Get the compact encoding flag
+     * @return true if the compact encoding is used
+     */
+    bool IsCompact() const
+    {
+        return m_compact;
+    }
+
+    /**
+     * @brief Get the number of bytes the compact encoding saves over the RFC 3561 encoding
+     * @return the size difference, 0 when the compact encoding is not used
+     */
+    int32_t GetCompactSavings() const;
+
     /**
      * @brief Comparison operator
      * @param o RREQ header to compare
@@ -315,6 +344,7 @@ class RreqHeader : public Header
     uint32_t m_dstSeqNo;    ///< Destination Sequence Number
     Ipv4Address m_origin;   ///< Originator IP Address
     uint32_t m_originSeqNo; ///< Source Sequence Number
+    bool m_compact;         ///< Use the compact encoding (not serialized)
 };
 
 /**
@@ -488,6 +518,36 @@ class RrepHeader : public Header
      */
     void SetHello(Ipv4Address src, uint32_t srcSeqNo, Time lifetime);
 
+    /**
+     * @brief Select the compact encoding
+     *
+     * The compact encoding packs the A flag and a hop count below 64 into one byte, writes the
+     * destination sequence number as a variable-length integer and the lifetime as a
+     * variable-length number of 100 ms units (rounded up). It is not part of RFC 3561, so every
+     * node of the network has to use it.
+     *
+     * @param f true to use the compact encoding
+     */
+    void SetCompact(bool f)
+    {
+        m_compact = f;
+    }
+
+    /**
+     * @brief Get the compact encoding flag
+     * @return true if the compact encoding is used
+     */
+    bool IsCompact() const
+    {
+        return m_compact;
+    }
+
+    /**
+     * @brief Get the number of bytes the compact encoding saves over the RFC 3561 encoding
+     * @return the size difference, 0 when the compact encoding is not used
+     */
+    int32_t GetCompactSavings() const;
+
     /**
      * @brief Comparison operator
      * @param o RREP header to compare
@@ -503,6 +563,7 @@ class RrepHeader : public Header
     uint32_t m_dstSeqNo;  ///< Destination Sequence Number
     Ipv4Address m_origin; ///< Source IP Address
     uint32_t m_lifeTime;  ///< Lifetime (in milliseconds)
+    bool m_compact;       ///< Use the compact encoding (not serialized)
 };
 
 /**
@@ -608,6 +669,10 @@ class RerrHeader : public Header
 
     /**
      * @brief Add unreachable node address and its sequence number in RERR header
+     *
+     * A destination which is already present is not added twice and keeps its first
+     * sequence number.
+     *
      * @param dst unreachable IPv4 address
      * @param seqNo unreachable sequence number
      * @return false if we already added maximum possible number of unreachable destinations
@@ -616,6 +681,10 @@ class RerrHeader : public Header
     /**
      * @brief Delete pair (address + sequence number) from REER header, if the number of unreachable
      * destinations > 0
+     *
+     * Pairs are removed starting from the highest address, so that draining the header costs
+     * constant time per destination.
+     *
      * @param un unreachable pair (address + sequence number)
      * @return true on success
      */
@@ -642,8 +711,11 @@ class RerrHeader : public Header
     uint8_t m_flag;     ///< No delete flag
     uint8_t m_reserved; ///< Not used (must be 0)
 
-    /// List of Unreachable destination: IP addresses and sequence numbers
-    std::map<Ipv4Address, uint32_t> m_unreachableDstSeqNo;
+    /**
+     * List of Unreachable destination: IP addresses and sequence numbers.
+     * Kept sorted by address so that the wire order is the same as with an ordered map.
+     */
+    std::vector<std::pair<Ipv4Address, uint32_t>> m_unreachableDstSeqNo;
 };
 
 /**
@@ -653,6 +725,82 @@ class RerrHeader : public Header
  */
 std::ostream& operator<<(std::ostream& os, const RerrHeader&);
 
+/**
+* @ingroup tpaodv
+* @brief Trust digest appended to HELLO messages
+  \verbatim
+  0                   1                   2                   3
+  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |     Count     |            Node IP Address (1) ...            |
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  |      ...      |  Trust Level  |    Age (s)    | Node IP (2) ...
+  +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  \endverbatim
+*/
+class TrustDigestHeader : public Header
+{
+  public:
+    /// First-hand trust verdict of the sender about one node
+    struct Verdict
+    {
+        Ipv4Address m_addr; ///< Node IP Address
+        int8_t m_level;     ///< Trust level
+        uint8_t m_age;      ///< Seconds since the verdict, saturated at 255
+    };
+
+    /// constructor
+    TrustDigestHeader();
+
+    /**
+     * @brief Get the type ID.
+     * @return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator i) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    void Print(std::ostream& os) const override;
+
+    /**
+     * @brief Add a verdict to the digest
+     * @param addr the node IP address
+     * @param level the trust level
+     * @param age the seconds since the verdict
+     * @return false if the digest already holds the maximum number of verdicts
+     */
+    bool AddVerdict(Ipv4Address addr, int8_t level, uint8_t age);
+
+    /**
+     * @returns the verdicts
+     */
+    const std::vector<Verdict>& GetVerdicts() const
+    {
+        return m_verdicts;
+    }
+
+    /// Clear header
+    void Clear();
+
+    /**
+     * @brief Comparison operator
+     * @param o trust digest header to compare
+     * @return true if the trust digest headers are equal
+     */
+    bool operator==(const TrustDigestHeader& o) const;
+
+  private:
+    std::vector<Verdict> m_verdicts; ///< Verdicts
+};
+
+/**
+ * @brief Stream output operator
+ * @param os output stream
+ * @return updated stream
+ */
+std::ostream& operator<<(std::ostream& os, const TrustDigestHeader&);
+
 } // namespace tpaodv
 } // namespace ns3
 
@@ -17,8 +17,10 @@
 #include "tpaodv-routing-protocol.h"
 
 #include "ns3/adhoc-wifi-mac.h"
+#include "ns3/aodv-profiler.h"
 #include "ns3/boolean.h"
 #include "ns3/inet-socket-address.h"
+#include "ns3/integer.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
 #include "ns3/random-variable-stream.h"
@@ -165,6 +167,26 @@ RoutingProtocol::RoutingProtocol()
       m_gratuitousReply(true),
       m_enableHello(false),
       m_enableBroadcast(true),            // default is true in TPAODV
+      m_rerrAggregationWindow(Seconds(0)),
+      m_compactHeaders(false),
+      m_trustDecayTime(Seconds(0)),
+      m_maxTrustEntries(0),
+      m_trustBlockThreshold(3),
+      m_maxPendingRreps(64),
+      m_maxPendingRrepsPerNeighbor(8),
+      m_trustTestTimeout(Seconds(1)),
+      m_trustTestTimeoutFlush(false),
+      m_trustTestRetries(2),
+      m_trustTestExhaustedLevel(TL_BLACKLIST),
+      m_optimisticTrust(false),
+      m_trustGossip(false),
+      m_trustGossipMaxEntries(8),
+      m_trustGossipWeight(0.5),
+      m_passiveSeqnoScoring(false),
+      m_seqnoMinSamples(3),
+      m_seqnoDeviationFactor(4),
+      m_seqnoSlack(10),
+      m_maxSeqnoEntries(256),
       m_ipv4(nullptr),
       m_socketAddresses(),
       m_socketSubnetBroadcastAddresses(),
@@ -180,22 +202,39 @@ RoutingProtocol::RoutingProtocol()
       m_rerrCount(0),
       m_rreqBound(4),                   // or your value
       m_distanceThreshold(20.0),        // or your value
-      m_rreqSentCount(0),
-      m_rrepSentCount(0),
-      m_rerrSentCount(0),
-      m_brokenLinkCount(0),
-      m_rreqReceivedCount(0),
-      m_maliciousDropCount(0), // <--- ADD THIS (Initialize to 0
+      m_preferTrustedRreqTargets(false),
+      m_pendingRrepOverflowCount(0),
+      m_pendingRrepTimeoutCount(0),
+      m_pendingRrepRejectedCount(0),
+      m_trustTestSentCount(0),
+      m_trustTestStartedCount(0),
+      m_trustTestPassedCount(0),
+      m_trustTestFailedCount(0),
+      m_trustTestUnansweredCount(0),
+      m_pendingRrepReleasedCount(0),
+      m_provisionalRevokedCount(0),
+      m_trustGossipAdoptedCount(0),
+      m_rreqUntrustedSkippedCount(0),
+      m_passiveAcceptedCount(0),
+      m_passiveRejectedCount(0),
       m_uv(CreateObject<UniformRandomVariable>()),
+      m_trustTable(m_trustDecayTime, m_maxTrustEntries),
+      m_pendingTrustPacketCount(0),
       m_htimer(Timer::CANCEL_ON_DESTROY),
       m_rreqRateLimitTimer(Timer::CANCEL_ON_DESTROY),
       m_rerrRateLimitTimer(Timer::CANCEL_ON_DESTROY),
+      m_rerrAggregationTimer(Timer::CANCEL_ON_DESTROY),
+      m_footprintTimer(Timer::CANCEL_ON_DESTROY),
+      m_statsTimer(Timer::CANCEL_ON_DESTROY),
       m_addressReqTimer(),
       m_uniformRandomVariable(CreateObject<UniformRandomVariable>()),
       m_lastBcastTime()
 {
     m_nb.SetCallback(MakeCallback(
         &RoutingProtocol::SendRerrWhenBreaksLinkToNextHop, this));
+    m_nb.SetNewNeighborCallback(MakeCallback(&RoutingProtocol::NotifyNewNeighbor, this));
+    m_routingTable.SetRouteChangeCallback(
+        MakeCallback(&RoutingProtocol::NotifyRouteChange, this));
 }
 
 
@@ -363,6 +402,180 @@ RoutingProtocol::GetTypeId()
                         DoubleValue(20.0),
                         MakeDoubleAccessor(&RoutingProtocol::m_distanceThreshold),
                         MakeDoubleChecker<double>())
+            .AddAttribute("PreferTrustedRreqTargets",
+                          "If true, trusted neighbors are picked first within each distance "
+                          "class when selecting the RREQ targets.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_preferTrustedRreqTargets),
+                          MakeBooleanChecker())
+            .AddAttribute("RerrAggregationWindow",
+                          "Period during which the destinations made unreachable by several link "
+                          "breaks are merged into as few RERR messages as possible. "
+                          "Zero disables aggregation.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::m_rerrAggregationWindow),
+                          MakeTimeChecker())
+            .AddAttribute("CompactHeaders",
+                          "Encode RREQ and RREP (including HELLO) messages in the compact, "
+                          "non-RFC format. All nodes of the network must use the same setting.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_compactHeaders),
+                          MakeBooleanChecker())
+            .AddAttribute("TrustDecayTime",
+                          "Time after which a trusted or blacklisted neighbor falls back to the "
+                          "initial trust level and is tested again. Zero disables the decay.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::SetTrustDecayTime,
+                                           &RoutingProtocol::GetTrustDecayTime),
+                          MakeTimeChecker())
+            .AddAttribute("MaxTrustEntries",
+                          "Maximum number of trust table entries, the least recently used entry "
+                          "is evicted first. Zero means unbounded.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&RoutingProtocol::SetMaxTrustEntries,
+                                               &RoutingProtocol::GetMaxTrustEntries),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TrustBlockThreshold",
+                          "Number of failed trust tests after which a neighbor is blocked "
+                          "permanently instead of blacklisted. Zero disables blocking.",
+                          UintegerValue(3),
+                          MakeUintegerAccessor(&RoutingProtocol::m_trustBlockThreshold),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxPendingRreps",
+                          "Maximum number of RREPs held back while their senders are tested.",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&RoutingProtocol::m_maxPendingRreps),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxPendingRrepsPerNeighbor",
+                          "Maximum number of RREPs held back per tested neighbor, the oldest "
+                          "one is dropped first.",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&RoutingProtocol::m_maxPendingRrepsPerNeighbor),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("TrustTestTimeout",
+                          "Time to wait for the reply to the first trust test of a neighbor. "
+                          "It doubles with every retry.",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&RoutingProtocol::m_trustTestTimeout),
+                          MakeTimeChecker())
+            .AddAttribute("TrustTestTimeoutFlush",
+                          "If true, RREPs held back for a neighbor that did not answer any "
+                          "trust test retry are processed, unless TrustTestExhaustedLevel "
+                          "rejects it. Otherwise they are dropped.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_trustTestTimeoutFlush),
+                          MakeBooleanChecker())
+            .AddAttribute("TrustTestRetries",
+                          "Number of times a trust test is repeated when the neighbor does not "
+                          "answer.",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&RoutingProtocol::m_trustTestRetries),
+                          MakeUintegerChecker<uint32_t>(0, 16))
+            .AddAttribute("TrustTestExhaustedLevel",
+                          "Trust level given to a neighbor that answered none of the trust test "
+                          "retries (2 trusted, 1 initial, 0 blacklisted, -1 blocked).",
+                          IntegerValue(TL_BLACKLIST),
+                          MakeIntegerAccessor(&RoutingProtocol::m_trustTestExhaustedLevel),
+                          MakeIntegerChecker<int>(TL_BLOCKED, TL_TRUSTED))
+            .AddAttribute("OptimisticTrust",
+                          "If true, a RREP from a neighbor under test installs its route right "
+                          "away. The route is revoked if the neighbor fails the test.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_optimisticTrust),
+                          MakeBooleanChecker())
+            .AddAttribute("TrustGossip",
+                          "If true, HELLO messages carry the first-hand trust verdicts of the "
+                          "node and the verdicts received from neighbors are merged.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_trustGossip),
+                          MakeBooleanChecker())
+            .AddAttribute("TrustGossipMaxEntries",
+                          "Maximum number of verdicts carried by one HELLO message.",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&RoutingProtocol::m_trustGossipMaxEntries),
+                          MakeUintegerChecker<uint32_t>(1, 255))
+            .AddAttribute("TrustGossipWeight",
+                          "Weight of a verdict reported by a trusted neighbor. A node takes the "
+                          "reported level once the weights of distinct neighbors add up to 1. "
+                          "Verdicts of untested neighbors are ignored.",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&RoutingProtocol::m_trustGossipWeight),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("PassiveSeqnoScoring",
+                          "If true, RREPs are scored against the observed sequence number growth "
+                          "of their destination: anomalous ones are dropped and their untested "
+                          "senders tested, plausible ones from untested neighbors are used "
+                          "without a trust test.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RoutingProtocol::m_passiveSeqnoScoring),
+                          MakeBooleanChecker())
+            .AddAttribute("SeqnoMinSamples",
+                          "Number of sequence numbers of a destination observed before RREPs "
+                          "towards it are scored.",
+                          UintegerValue(3),
+                          MakeUintegerAccessor(&RoutingProtocol::m_seqnoMinSamples),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("SeqnoDeviationFactor",
+                          "Number of mean deviations of the sequence number growth rate "
+                          "tolerated before a sequence number is anomalous.",
+                          DoubleValue(4),
+                          MakeDoubleAccessor(&RoutingProtocol::m_seqnoDeviationFactor),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("SeqnoSlack",
+                          "Sequence number increase over the expected value which is always "
+                          "tolerated, including in trust test replies.",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&RoutingProtocol::m_seqnoSlack),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxSeqnoEntries",
+                          "Maximum number of destinations whose sequence number growth is "
+                          "modeled, the least recently observed one is forgotten first. Zero "
+                          "means unbounded.",
+                          UintegerValue(256),
+                          MakeUintegerAccessor(&RoutingProtocol::SetMaxSeqnoEntries,
+                                               &RoutingProtocol::GetMaxSeqnoEntries),
+                          MakeUintegerChecker<uint32_t>())
+            .AddTraceSource("SeqnoScore",
+                            "Score of a destination sequence number reported by a neighbor.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_seqnoScoreTrace),
+                            "ns3::tpaodv::RoutingProtocol::SeqnoScoreTracedCallback")
+            .AddAttribute("FootprintInterval",
+                          "Time between two samples of the memory footprint of the protocol "
+                          "state, reported by the Footprint trace source. Zero disables the "
+                          "sampling.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::SetFootprintInterval,
+                                           &RoutingProtocol::GetFootprintInterval),
+                          MakeTimeChecker())
+            .AddAttribute("StatsInterval",
+                          "Time between two reports of the control overhead counters by the "
+                          "Stats trace source. Zero disables the reports.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&RoutingProtocol::SetStatsInterval,
+                                           &RoutingProtocol::GetStatsInterval),
+                          MakeTimeChecker())
+            .AddAttribute("EventLog",
+                          "Binary log receiving the routing events of the node, none if null.",
+                          PointerValue(),
+                          MakePointerAccessor(&RoutingProtocol::SetEventLog,
+                                              &RoutingProtocol::GetEventLog),
+                          MakePointerChecker<AodvEventLog>())
+            .AddTraceSource("Footprint",
+                            "Periodic sample of the memory footprint of the protocol state.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_footprintTrace),
+                            "ns3::AodvFootprint::TracedCallback")
+            .AddTraceSource("Stats",
+                            "Periodic report of the control overhead counters of the node.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_statsTrace),
+                            "ns3::AodvStats::TracedCallback")
+            .AddTraceSource("TrustVerdict",
+                            "A first-hand verdict about the trustworthiness of a neighbor.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_trustVerdictTrace),
+                            "ns3::tpaodv::RoutingProtocol::TrustVerdictTracedCallback")
+            .AddTraceSource("RouteDiscovery",
+                            "A route discovery completed.",
+                            MakeTraceSourceAccessor(&RoutingProtocol::m_discoveryTrace),
+                            "ns3::tpaodv::RoutingProtocol::DiscoveryTracedCallback")
             .AddAttribute ("IsMalicious",
                    "If true, the node becomes a Blackhole attacker.",
                    BooleanValue (false),
@@ -378,6 +591,27 @@ RoutingProtocol::SetMaxQueueLen(uint32_t len)
     m_queue.SetMaxQueueLen(len);
 }
 
+void
+RoutingProtocol::SetTrustDecayTime(Time t)
+{
+    m_trustDecayTime = t;
+    m_trustTable.SetDecayTime(t);
+}
+
+void
+RoutingProtocol::SetMaxTrustEntries(uint32_t n)
+{
+    m_maxTrustEntries = n;
+    m_trustTable.SetMaxEntries(n);
+}
+
+void
+RoutingProtocol::SetMaxSeqnoEntries(uint32_t n)
+{
+    m_maxSeqnoEntries = n;
+    m_seqnoMonitor.SetMaxEntries(n);
+}
+
 void
 RoutingProtocol::SetMaxQueueTime(Time t)
 {
@@ -405,6 +639,16 @@ RoutingProtocol::DoDispose()
         iter->first->Close();
     }
     m_socketSubnetBroadcastAddresses.clear();
+    m_discoveryStart.clear();
+    m_footprintTimer.Cancel();
+    m_statsTimer.Cancel();
+    m_eventLog.SetLog(nullptr);
+    m_discoveryHeld.clear();
+    m_trustTests.clear();
+    m_provisionalRoutes.clear();
+    m_pendingTrustPackets.clear();
+    m_pendingTrustPacketCount = 0;
+    m_seqnoMonitor.Clear();
     Ipv4RoutingProtocol::DoDispose();
 }
 
@@ -438,9 +682,13 @@ RoutingProtocol::Start()
     }
     m_rreqRateLimitTimer.SetFunction(&RoutingProtocol::RreqRateLimitTimerExpire, this);
     m_rreqRateLimitTimer.Schedule(Seconds(1));
+    AODV_PROFILE_TIMER("tpaodv::RateLimitTimer", m_rreqRateLimitTimer);
 
     m_rerrRateLimitTimer.SetFunction(&RoutingProtocol::RerrRateLimitTimerExpire, this);
     m_rerrRateLimitTimer.Schedule(Seconds(1));
+    AODV_PROFILE_TIMER("tpaodv::RateLimitTimer", m_rerrRateLimitTimer);
+
+    m_rerrAggregationTimer.SetFunction(&RoutingProtocol::RerrAggregationTimerExpire, this);
 }
 
 Ptr<Ipv4Route>
@@ -449,6 +697,7 @@ RoutingProtocol::RouteOutput(Ptr<Packet> p,
                              Ptr<NetDevice> oif,
                              Socket::SocketErrno& sockerr)
 {
+    AODV_PROFILE_SCOPE("tpaodv::RoutingProtocol::RouteOutput");
     NS_LOG_FUNCTION(this << header << (oif ? oif->GetIfIndex() : 0));
     if (!p)
     {
@@ -530,6 +779,7 @@ RoutingProtocol::RouteInput(Ptr<const Packet> p,
                             const LocalDeliverCallback& lcb,
                             const ErrorCallback& ecb)
 {
+    AODV_PROFILE_SCOPE("tpaodv::RoutingProtocol::RouteInput");
     NS_LOG_FUNCTION(this << p->GetUid() << header.GetDestination() << idev->GetAddress());
     if (m_socketAddresses.empty())
     {
@@ -675,6 +925,7 @@ RoutingProtocol::Forwarding(Ptr<const Packet> p,
                             UnicastForwardCallback ucb,
                             ErrorCallback ecb)
 {
+    AODV_PROFILE_SCOPE("tpaodv::RoutingProtocol::Forwarding");
     NS_LOG_FUNCTION(this);
 
     // --- FIXED MALICIOUS LOGIC ---
@@ -700,7 +951,7 @@ RoutingProtocol::Forwarding(Ptr<const Packet> p,
             NS_LOG_INFO ("MALICIOUS NODE " << GetObject<Node>()->GetId() 
                          << " DROPPING DATA PACKET " << p->GetUid());
             
-            m_maliciousDropCount++; 
+            IncrementStat(&AodvStats::maliciousDrops); 
             return true; // Drop the packet (Blackhole)
         }
         
@@ -769,6 +1020,11 @@ RoutingProtocol::SetIpv4(Ptr<Ipv4> ipv4)
     NS_ASSERT(!m_ipv4);
 
     m_ipv4 = ipv4;
+    Ptr<Node> node = ipv4->GetObject<Node>();
+    if (node)
+    {
+        m_eventLog.SetNode(node->GetId());
+    }
 
     // Create lo route. It is asserted that the only one interface up for now is loopback
     NS_ASSERT(m_ipv4->GetNInterfaces() == 1 &&
@@ -787,7 +1043,7 @@ RoutingProtocol::SetIpv4(Ptr<Ipv4> ipv4)
         /*lifetime=*/Simulator::GetMaximumSimulationTime());
     m_routingTable.AddRoute(rt);
 
-    Simulator::ScheduleNow(&RoutingProtocol::Start, this);
+    AODV_PROFILE_EVENT("tpaodv::Start", Simulator::ScheduleNow(&RoutingProtocol::Start, this));
 }
 
 void
@@ -861,7 +1117,7 @@ RoutingProtocol::NotifyInterfaceUp(uint32_t i)
 void
 RoutingProtocol::NotifyTxError(WifiMacDropReason reason, Ptr<const WifiMpdu> mpdu)
 {
-    // DO NOT increment m_brokenLinkCount here
+    // DO NOT count the broken link here
     // Not every MAC TX error means a broken route in TPAODV/AODV.
 
     // Keep original neighbor processing
@@ -1112,13 +1368,17 @@ void
 RoutingProtocol::SendRequest(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
+    // Retries keep the start of the first attempt
+    m_discoveryStart.emplace(dst, Simulator::Now());
     // Rate limit check (same as original)
     if (m_rreqCount == m_rreqRateLimit)
     {
-        Simulator::Schedule(m_rreqRateLimitTimer.GetDelayLeft() + MicroSeconds(100),
-                            &RoutingProtocol::SendRequest,
-                            this,
-                            dst);
+        AODV_PROFILE_EVENT(
+            "tpaodv::RreqRateLimitDefer",
+            Simulator::Schedule(m_rreqRateLimitTimer.GetDelayLeft() + MicroSeconds(100),
+                                &RoutingProtocol::SendRequest,
+                                this,
+                                dst));
         return;
     }
     else
@@ -1205,6 +1465,10 @@ RoutingProtocol::SendRequest(Ipv4Address dst)
     
     // This helper handles the copying, header addition, and unicast sending
     SendRreqToSelectedNeighbors(packet, rreqHeader, ttl);
+    m_eventLog.Record(AODV_EVENT_RREQ_SENT,
+                      dst,
+                      Ipv4Address::GetAny(),
+                      rreqHeader.GetDstSeqno());
 
     // --- TPAODV CHANGE ENDS HERE ---
 
@@ -1245,6 +1509,7 @@ RoutingProtocol::ScheduleRreqRetry(Ipv4Address dst)
         retry = m_netTraversalTime * (1 << backoffFactor);
     }
     m_addressReqTimer[dst].Schedule(retry);
+    AODV_PROFILE_TIMER("tpaodv::AddressReqTimer", m_addressReqTimer[dst]);
     NS_LOG_LOGIC("Scheduled RREQ retry in " << retry.As(Time::S));
 }
 
@@ -1369,11 +1634,13 @@ RoutingProtocol::UpdateRouteToNeighbor(Ipv4Address sender, Ipv4Address receiver)
 void
 RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address src)
 {
+    AODV_PROFILE_SCOPE("tpaodv::RoutingProtocol::RecvRequest");
     NS_LOG_FUNCTION(this);
     // --- MALICIOUS ATTACK LOGIC START ---
     if (m_isMalicious)
     {
         RreqHeader rreqHeader;
+        rreqHeader.SetCompact(m_compactHeaders);
         p->PeekHeader(rreqHeader); // Peek to see who they are looking for
 
         // We only attack if we are NOT the destination (don't attack ourselves)
@@ -1398,19 +1665,23 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
             // we just reply to the neighbor who sent it.)
             
             Ptr<Packet> packet = Create<Packet> ();
+            fakeRrep.SetCompact(m_compactHeaders);
             packet->AddHeader (fakeRrep);
+            AddCompactSavings(fakeRrep.GetCompactSavings());
             TypeHeader tHeader (TPAODVTYPE_RREP); // Or AODVTYPE_RREP
             packet->AddHeader (tHeader);
             
             // Send back to the node we got it from
             Ptr<Socket> socket = FindSocketWithInterfaceAddress (m_ipv4->GetAddress (m_ipv4->GetInterfaceForAddress (receiver), 0));
+            AccountControl (packet, AODV_CONTROL_RREP);
             socket->SendTo (packet, 0, InetSocketAddress (src, TPAODV_PORT)); // Or AODV_PORT
 
             return; // STOP PROCESSING. Do not forward the real RREQ.
         }
     }
-    m_rreqReceivedCount++; // <--- ADD THIS LINE HERE
+    IncrementStat(&AodvStats::rreqReceived); // <--- ADD THIS LINE HERE
     RreqHeader rreqHeader;
+    rreqHeader.SetCompact(m_compactHeaders);
     p->RemoveHeader(rreqHeader);
 
     // [KEEP] Blacklist check
@@ -1433,10 +1704,16 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
         NS_LOG_DEBUG("Ignoring RREQ due to duplicate");
         return;
     }
+    m_seqnoMonitor.Observe(origin, rreqHeader.GetOriginSeqno());
 
     // Increment RREQ hop count
     uint8_t hop = rreqHeader.GetHopCount() + 1;
     rreqHeader.SetHopCount(hop);
+    m_eventLog.Record(AODV_EVENT_RREQ_RECEIVED,
+                      rreqHeader.GetDst(),
+                      origin,
+                      rreqHeader.GetDstSeqno(),
+                      hop);
 
     // [KEEP] Reverse Route Creation / Update
     RoutingTableEntry toOrigin;
@@ -1562,6 +1839,7 @@ RoutingProtocol::RecvRequest(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sr
     // Call the helper to forward RREQ only to selected neighbors
     // Note: We use tag.GetTtl() - 1 because we are forwarding
     SendRreqToSelectedNeighbors(packet, rreqHeader, tag.GetTtl() - 1);
+    m_eventLog.Record(AODV_EVENT_RREQ_FORWARDED, dst, origin, rreqHeader.GetDstSeqno(), hop);
     
     // --- TPAODV CHANGE ENDS HERE ---
 }
@@ -1590,13 +1868,21 @@ RoutingProtocol::SendReply(const RreqHeader& rreqHeader, const RoutingTableEntry
     SocketIpTtlTag tag;
     tag.SetTtl(toOrigin.GetHop());
     packet->AddPacketTag(tag);
+    rrepHeader.SetCompact(m_compactHeaders);
     packet->AddHeader(rrepHeader);
+    AddCompactSavings(rrepHeader.GetCompactSavings());
     TypeHeader tHeader(TPAODVTYPE_RREP);
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
+    AccountControl(packet, AODV_CONTROL_RREP);
     socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), TPAODV_PORT));
-    ++m_rrepSentCount;
+    IncrementStat(&AodvStats::rrepSent);
+    m_eventLog.Record(AODV_EVENT_RREP_SENT,
+                      rrepHeader.GetDst(),
+                      rrepHeader.GetOrigin(),
+                      rrepHeader.GetDstSeqno(),
+                      rrepHeader.GetHopCount());
 }
 
 void
@@ -1632,13 +1918,21 @@ RoutingProtocol::SendReplyByIntermediateNode(RoutingTableEntry& toDst,
     SocketIpTtlTag tag;
     tag.SetTtl(toOrigin.GetHop());
     packet->AddPacketTag(tag);
+    rrepHeader.SetCompact(m_compactHeaders);
     packet->AddHeader(rrepHeader);
+    AddCompactSavings(rrepHeader.GetCompactSavings());
     TypeHeader tHeader(TPAODVTYPE_RREP);
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
+    AccountControl(packet, AODV_CONTROL_RREP);
     socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), TPAODV_PORT));
-    ++m_rrepSentCount;
+    IncrementStat(&AodvStats::rrepSent);
+    m_eventLog.Record(AODV_EVENT_RREP_SENT,
+                      rrepHeader.GetDst(),
+                      rrepHeader.GetOrigin(),
+                      rrepHeader.GetDstSeqno(),
+                      rrepHeader.GetHopCount());
     // Generating gratuitous RREPs
     if (gratRep)
     {
@@ -1652,14 +1946,22 @@ RoutingProtocol::SendReplyByIntermediateNode(RoutingTableEntry& toDst,
         SocketIpTtlTag gratTag;
         gratTag.SetTtl(toDst.GetHop());
         packetToDst->AddPacketTag(gratTag);
+        gratRepHeader.SetCompact(m_compactHeaders);
         packetToDst->AddHeader(gratRepHeader);
+        AddCompactSavings(gratRepHeader.GetCompactSavings());
         TypeHeader type(TPAODVTYPE_RREP);
         packetToDst->AddHeader(type);
         Ptr<Socket> socket = FindSocketWithInterfaceAddress(toDst.GetInterface());
         NS_ASSERT(socket);
         NS_LOG_LOGIC("Send gratuitous RREP " << packet->GetUid());
+        AccountControl(packetToDst, AODV_CONTROL_RREP);
         socket->SendTo(packetToDst, 0, InetSocketAddress(toDst.GetNextHop(), TPAODV_PORT));
-        ++m_rrepSentCount;
+        IncrementStat(&AodvStats::rrepSent);
+        m_eventLog.Record(AODV_EVENT_RREP_SENT,
+                          gratRepHeader.GetDst(),
+                          gratRepHeader.GetOrigin(),
+                          gratRepHeader.GetDstSeqno(),
+                          gratRepHeader.GetHopCount());
     }
 }
 
@@ -1679,12 +1981,14 @@ RoutingProtocol::SendReplyAck(Ipv4Address neighbor)
     m_routingTable.LookupRoute(neighbor, toNeighbor);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toNeighbor.GetInterface());
     NS_ASSERT(socket);
+    AccountControl(packet, AODV_CONTROL_RREP_ACK);
     socket->SendTo(packet, 0, InetSocketAddress(neighbor, TPAODV_PORT));
 }
 
 void
 RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sender)
 {
+    AODV_PROFILE_SCOPE("tpaodv::RoutingProtocol::RecvReply");
     NS_LOG_FUNCTION(this << " src " << sender);
         int trust = GetTrustLevel(sender);
 
@@ -1697,6 +2001,7 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
 
     // 2. Check for Trust Test Reply (Is this a reply to my self-request?)
     RrepHeader rrepHeader;
+    rrepHeader.SetCompact(m_compactHeaders);
     p->PeekHeader(rrepHeader); // Peek first to check destination
     
     if (IsMyOwnAddress(rrepHeader.GetDst())) 
@@ -1710,14 +2015,88 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
         return; 
     }
 
-    // 3. Check Unknown Trust
+    // 3. Score the sequence number against what we have seen of the destination
+    Ipv4Address dst = rrepHeader.GetDst();
+    if (dst == rrepHeader.GetOrigin())
+    {
+        // HELLO messages carry the own sequence number of the sender
+        if (dst == sender)
+        {
+            m_seqnoMonitor.Observe(dst, rrepHeader.GetDstSeqno());
+        }
+    }
+    else if (m_seqnoMonitor.GetSamples(dst) >= m_seqnoMinSamples)
+    {
+        double score = m_seqnoMonitor.Score(dst, rrepHeader.GetDstSeqno());
+        m_seqnoScoreTrace(sender, dst, rrepHeader.GetDstSeqno(), score);
+        if (m_passiveSeqnoScoring && score > 1)
+        {
+            NS_LOG_WARN("TPAODV: Anomalous SeqNo " << rrepHeader.GetDstSeqno() << " for " << dst
+                                                   << " from " << sender << " (score " << score
+                                                   << ")");
+            ++m_passiveRejectedCount;
+            // The sender may only relay a stale or forged sequence number: an untested one is
+            // tested, a score alone does not make it malicious
+            if (trust == TL_INITIAL)
+            {
+                StartTrustTest(sender, receiver);
+            }
+            return;
+        }
+        if (m_passiveSeqnoScoring && trust == TL_INITIAL)
+        {
+            NS_LOG_INFO("TPAODV: Plausible RREP from " << sender << ", no Trust Test needed.");
+            ++m_passiveAcceptedCount;
+            m_seqnoMonitor.Observe(dst, rrepHeader.GetDstSeqno());
+            ProcessReply(p, receiver, sender);
+            return;
+        }
+    }
+
+    // 4. Check Unknown Trust
+    if (trust == TL_INITIAL && m_optimisticTrust)
+    {
+        // Use the route right away, it is revoked if the sender fails the test
+        NS_LOG_INFO("TPAODV: Provisional RREP from " << sender << ". Using it while the Trust Test runs.");
+        if (rrepHeader.GetDst() != rrepHeader.GetOrigin())
+        {
+            // Keep what we knew before the first provisional RREP, to restore it on revocation
+            RoutingTableEntry known;
+            PriorSeqNo prior{0, false};
+            if (m_routingTable.LookupRoute(dst, known) && known.GetValidSeqNo())
+            {
+                prior = {known.GetSeqNo(), true};
+            }
+            m_provisionalRoutes[sender].emplace(dst, prior);
+        }
+        StartTrustTest(sender, receiver);
+        ProcessReply(p, receiver, sender);
+        return;
+    }
     if (trust == TL_INITIAL)
     {
         NS_LOG_INFO("TPAODV: Suspicious RREP from " << sender << ". Holding packet and starting Trust Test.");
-        m_pendingTrustPackets[sender].push_back(p->Copy());
-        StartTrustTest(sender);
+        if (BufferTrustRrep(p, receiver, sender, dst) && IsMyOwnAddress(rrepHeader.GetOrigin()) &&
+            m_discoveryStart.find(dst) != m_discoveryStart.end())
+        {
+            m_discoveryHeld.emplace(dst, Simulator::Now());
+        }
+        StartTrustTest(sender, receiver);
         return; // STOP processing
     }
+    if (dst != rrepHeader.GetOrigin())
+    {
+        m_seqnoMonitor.Observe(dst, rrepHeader.GetDstSeqno());
+    }
+    ProcessReply(p, receiver, sender);
+}
+
+void
+RoutingProtocol::ProcessReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sender)
+{
+    NS_LOG_FUNCTION(this << " src " << sender);
+    RrepHeader rrepHeader;
+    rrepHeader.SetCompact(m_compactHeaders);
     p->RemoveHeader(rrepHeader);
     Ipv4Address dst = rrepHeader.GetDst();
     NS_LOG_LOGIC("RREP destination " << dst << " RREP origin " << rrepHeader.GetOrigin());
@@ -1729,9 +2108,21 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
     if (dst == rrepHeader.GetOrigin())
     {
         ProcessHello(rrepHeader, receiver);
+        if (m_trustGossip && p->GetSize() > 0)
+        {
+            TrustDigestHeader digest;
+            p->RemoveHeader(digest);
+            MergeTrustDigest(digest, sender);
+        }
         return;
     }
 
+    m_eventLog.Record(AODV_EVENT_RREP_RECEIVED,
+                      dst,
+                      rrepHeader.GetOrigin(),
+                      rrepHeader.GetDstSeqno(),
+                      hop);
+
     /*
      * If the route table entry to the destination is created or updated, then the following actions
      * occur:
@@ -1798,6 +2189,7 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
             m_routingTable.Update(newEntry);
             m_addressReqTimer[dst].Cancel();
             m_addressReqTimer.erase(dst);
+            RecordDiscovery(dst);
         }
         m_routingTable.LookupRoute(dst, toDst);
         SendPacketFromQueue(dst, toDst.GetRoute());
@@ -1846,10 +2238,12 @@ RoutingProtocol::RecvReply(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address send
     ttl.SetTtl(tag.GetTtl() - 1);
     packet->AddPacketTag(ttl);
     packet->AddHeader(rrepHeader);
+    AddCompactSavings(rrepHeader.GetCompactSavings());
     TypeHeader tHeader(TPAODVTYPE_RREP);
     packet->AddHeader(tHeader);
     Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
     NS_ASSERT(socket);
+    AccountControl(packet, AODV_CONTROL_RREP);
     socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), TPAODV_PORT));
 }
 
@@ -1912,21 +2306,25 @@ RoutingProtocol::ProcessHello(const RrepHeader& rrepHeader, Ipv4Address receiver
 void
 RoutingProtocol::RecvError(Ptr<Packet> p, Ipv4Address src)
 {
+    AODV_PROFILE_SCOPE("tpaodv::RoutingProtocol::RecvError");
     NS_LOG_FUNCTION(this << " from " << src);
     RerrHeader rerrHeader;
     p->RemoveHeader(rerrHeader);
+    m_eventLog.Record(AODV_EVENT_RERR_RECEIVED,
+                      src,
+                      Ipv4Address::GetAny(),
+                      0,
+                      0,
+                      rerrHeader.GetDestCount());
     std::map<Ipv4Address, uint32_t> dstWithNextHopSrc;
     std::map<Ipv4Address, uint32_t> unreachable;
     m_routingTable.GetListOfDestinationWithNextHop(src, dstWithNextHopSrc);
     std::pair<Ipv4Address, uint32_t> un;
     while (rerrHeader.RemoveUnDestination(un))
     {
-        for (auto i = dstWithNextHopSrc.begin(); i != dstWithNextHopSrc.end(); ++i)
+        if (dstWithNextHopSrc.find(un.first) != dstWithNextHopSrc.end())
         {
-            if (i->first == un.first)
-            {
-                unreachable.insert(un);
-            }
+            unreachable.insert(un);
         }
     }
 
@@ -1976,6 +2374,7 @@ RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
     {
         SendPacketFromQueue(dst, toDst.GetRoute());
         NS_LOG_LOGIC("route to " << dst << " found");
+        AbandonDiscovery(dst);
         return;
     }
     /*
@@ -1991,6 +2390,7 @@ RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
                                            << m_netDiameter);
         m_addressReqTimer.erase(dst);
         m_routingTable.DeleteRoute(dst);
+        AbandonDiscovery(dst);
         NS_LOG_DEBUG("Route not found. Drop all packets with dst " << dst);
         m_queue.DropPacketWithDst(dst);
         return;
@@ -2006,6 +2406,7 @@ RoutingProtocol::RouteRequestTimerExpire(Ipv4Address dst)
         NS_LOG_DEBUG("Route down. Stop search. Drop packet with destination " << dst);
         m_addressReqTimer.erase(dst);
         m_routingTable.DeleteRoute(dst);
+        AbandonDiscovery(dst);
         m_queue.DropPacketWithDst(dst);
     }
 }
@@ -2027,6 +2428,7 @@ RoutingProtocol::HelloTimerExpire()
     m_htimer.Cancel();
     Time diff = m_helloInterval - offset;
     m_htimer.Schedule(std::max(Seconds(0), diff));
+    AODV_PROFILE_TIMER("tpaodv::HelloTimer", m_htimer);
     m_lastBcastTime = Seconds(0);
 }
 
@@ -2036,6 +2438,7 @@ RoutingProtocol::RreqRateLimitTimerExpire()
     NS_LOG_FUNCTION(this);
     m_rreqCount = 0;
     m_rreqRateLimitTimer.Schedule(Seconds(1));
+    AODV_PROFILE_TIMER("tpaodv::RateLimitTimer", m_rreqRateLimitTimer);
 }
 
 void
@@ -2044,6 +2447,7 @@ RoutingProtocol::RerrRateLimitTimerExpire()
     NS_LOG_FUNCTION(this);
     m_rerrCount = 0;
     m_rerrRateLimitTimer.Schedule(Seconds(1));
+    AODV_PROFILE_TIMER("tpaodv::RateLimitTimer", m_rerrRateLimitTimer);
 }
 
 void
@@ -2063,6 +2467,17 @@ RoutingProtocol::SendHello()
      *   Hop Count                      0
      *   Lifetime                       AllowedHelloLoss * HelloInterval
      */
+    TrustDigestHeader digest;
+    if (m_trustGossip)
+    {
+        std::vector<TrustTable::Verdict> verdicts;
+        m_trustTable.GetFirstHandVerdicts(verdicts, m_trustGossipMaxEntries);
+        for (const auto& v : verdicts)
+        {
+            int64_t age = (Simulator::Now() - v.m_updated).GetSeconds();
+            digest.AddVerdict(v.m_addr, v.m_level, std::min<int64_t>(age, 255));
+        }
+    }
     for (auto j = m_socketAddresses.begin(); j != m_socketAddresses.end(); ++j)
     {
         Ptr<Socket> socket = j->first;
@@ -2077,7 +2492,13 @@ RoutingProtocol::SendHello()
         SocketIpTtlTag tag;
         tag.SetTtl(1);
         packet->AddPacketTag(tag);
+        if (!digest.GetVerdicts().empty())
+        {
+            packet->AddHeader(digest);
+        }
+        helloHeader.SetCompact(m_compactHeaders);
         packet->AddHeader(helloHeader);
+        AddCompactSavings(helloHeader.GetCompactSavings());
         TypeHeader tHeader(TPAODVTYPE_RREP);
         packet->AddHeader(tHeader);
         // Send to all-hosts broadcast if on /32 addr, subnet-directed otherwise
@@ -2091,7 +2512,15 @@ RoutingProtocol::SendHello()
             destination = iface.GetBroadcast();
         }
         Time jitter = MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10));
-        Simulator::Schedule(jitter, &RoutingProtocol::SendTo, this, socket, packet, destination);
+        AccountControl(packet, AODV_CONTROL_HELLO);
+        AODV_PROFILE_EVENT(
+            "tpaodv::HelloJitter",
+            Simulator::Schedule(jitter,
+                                &RoutingProtocol::SendTo,
+                                this,
+                                socket,
+                                packet,
+                                destination));
     }
 }
 
@@ -2125,9 +2554,9 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
     NS_LOG_FUNCTION(this << nextHop);
 
     // A real routing link failure happened → increase broken link counter ONCE here
-    ++m_brokenLinkCount;
+    IncrementStat(&AodvStats::brokenLinks);
+    m_eventLog.Record(AODV_EVENT_NEIGHBOR_DOWN, nextHop);
 
-    RerrHeader rerrHeader;
     std::vector<Ipv4Address> precursors;
     std::map<Ipv4Address, uint32_t> unreachable;
 
@@ -2138,9 +2567,49 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
     }
 
     toNextHop.GetPrecursors(precursors);
-    rerrHeader.AddUnDestination(nextHop, toNextHop.GetSeqNo());
 
     m_routingTable.GetListOfDestinationWithNextHop(nextHop, unreachable);
+    for (auto i = unreachable.begin(); i != unreachable.end(); ++i)
+    {
+        RoutingTableEntry toDst;
+        m_routingTable.LookupRoute(i->first, toDst);
+        toDst.GetPrecursors(precursors);
+    }
+    unreachable.insert(std::make_pair(nextHop, toNextHop.GetSeqNo()));
+
+    if (m_rerrAggregationWindow.IsStrictlyPositive())
+    {
+        // Several neighbors often expire in the same Neighbors::Purge; collect their
+        // unreachable destinations and report them together when the window closes.
+        m_pendingRerrUnreachable.insert(unreachable.begin(), unreachable.end());
+        for (auto i = precursors.begin(); i != precursors.end(); ++i)
+        {
+            if (std::find(m_pendingRerrPrecursors.begin(), m_pendingRerrPrecursors.end(), *i) ==
+                m_pendingRerrPrecursors.end())
+            {
+                m_pendingRerrPrecursors.push_back(*i);
+            }
+        }
+        if (!m_rerrAggregationTimer.IsRunning())
+        {
+            m_rerrAggregationTimer.Schedule(m_rerrAggregationWindow);
+            AODV_PROFILE_TIMER("tpaodv::RerrAggregationTimer", m_rerrAggregationTimer);
+        }
+    }
+    else
+    {
+        SendRerrWithUnreachable(unreachable, precursors);
+    }
+
+    m_routingTable.InvalidateRoutesWithDst(unreachable);
+}
+
+void
+RoutingProtocol::SendRerrWithUnreachable(const std::map<Ipv4Address, uint32_t>& unreachable,
+                                         const std::vector<Ipv4Address>& precursors)
+{
+    NS_LOG_FUNCTION(this << unreachable.size() << precursors.size());
+    RerrHeader rerrHeader;
     for (auto i = unreachable.begin(); i != unreachable.end();)
     {
         if (!rerrHeader.AddUnDestination(i->first, i->second))
@@ -2148,7 +2617,7 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
             TypeHeader typeHeader(TPAODVTYPE_RERR);
             Ptr<Packet> packet = Create<Packet>();
 
-            ++m_rerrSentCount;   // count RERR
+            IncrementStat(&AodvStats::rerrSent);   // count RERR
 
             SocketIpTtlTag tag;
             tag.SetTtl(1);
@@ -2161,9 +2630,6 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
         }
         else
         {
-            RoutingTableEntry toDst;
-            m_routingTable.LookupRoute(i->first, toDst);
-            toDst.GetPrecursors(precursors);
             ++i;
         }
     }
@@ -2173,7 +2639,7 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
         TypeHeader typeHeader(TPAODVTYPE_RERR);
         Ptr<Packet> packet = Create<Packet>();
 
-        ++m_rerrSentCount;   // count RERR
+        IncrementStat(&AodvStats::rerrSent);   // count RERR
 
         SocketIpTtlTag tag;
         tag.SetTtl(1);
@@ -2182,9 +2648,34 @@ RoutingProtocol::SendRerrWhenBreaksLinkToNextHop(Ipv4Address nextHop)
         packet->AddHeader(typeHeader);
         SendRerrMessage(packet, precursors);
     }
+}
 
-    unreachable.insert(std::make_pair(nextHop, toNextHop.GetSeqNo()));
-    m_routingTable.InvalidateRoutesWithDst(unreachable);
+void
+RoutingProtocol::RerrAggregationTimerExpire()
+{
+    NS_LOG_FUNCTION(this);
+    std::map<Ipv4Address, uint32_t> unreachable;
+    std::vector<Ipv4Address> precursors;
+    unreachable.swap(m_pendingRerrUnreachable);
+    precursors.swap(m_pendingRerrPrecursors);
+
+    // Do not report destinations which were repaired while the window was open
+    RoutingTableEntry rt;
+    for (auto i = unreachable.begin(); i != unreachable.end();)
+    {
+        if (m_routingTable.LookupValidRoute(i->first, rt))
+        {
+            NS_LOG_LOGIC("Route to " << i->first << " repaired, not reported in RERR");
+            i = unreachable.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    NS_LOG_LOGIC("Send aggregated RERR for " << unreachable.size() << " destinations to "
+                                             << precursors.size() << " precursors");
+    SendRerrWithUnreachable(unreachable, precursors);
 }
 
 
@@ -2216,8 +2707,10 @@ RoutingProtocol::SendRerrWhenNoRouteToForward(Ipv4Address dst,
         Ptr<Socket> socket = FindSocketWithInterfaceAddress(toOrigin.GetInterface());
         NS_ASSERT(socket);
 
-        ++m_rerrSentCount;   // count unicast RERR
+        IncrementStat(&AodvStats::rerrSent);   // count unicast RERR
+        m_eventLog.Record(AODV_EVENT_RERR_SENT, toOrigin.GetNextHop());
 
+        AccountControl(packet, AODV_CONTROL_RERR);
         socket->SendTo(packet, 0, InetSocketAddress(toOrigin.GetNextHop(), TPAODV_PORT));
     }
     else
@@ -2232,8 +2725,10 @@ RoutingProtocol::SendRerrWhenNoRouteToForward(Ipv4Address dst,
                  Ipv4Address("255.255.255.255") :
                  iface.GetBroadcast());
 
-            ++m_rerrSentCount;   // count broadcast RERR
+            IncrementStat(&AodvStats::rerrSent);   // count broadcast RERR
+            m_eventLog.Record(AODV_EVENT_RERR_SENT, destination);
 
+            AccountControl(packet, AODV_CONTROL_RERR);
             socket->SendTo(packet->Copy(), 0, InetSocketAddress(destination, TPAODV_PORT));
         }
     }
@@ -2272,14 +2767,18 @@ RoutingProtocol::SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> pr
             NS_LOG_LOGIC("one precursor => unicast RERR to "
                          << toPrecursor.GetDestination() << " from "
                          << toPrecursor.GetInterface().GetLocal());
-            Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
-                                &RoutingProtocol::SendTo,
-                                this,
-                                socket,
-                                packet,
-                                precursors.front());
+            AccountControl(packet, AODV_CONTROL_RERR);
+            AODV_PROFILE_EVENT(
+                "tpaodv::RerrJitter",
+                Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
+                                    &RoutingProtocol::SendTo,
+                                    this,
+                                    socket,
+                                    packet,
+                                    precursors.front()));
             m_rerrCount++;
-            ++m_rerrSentCount;
+            IncrementStat(&AodvStats::rerrSent);
+            m_eventLog.Record(AODV_EVENT_RERR_SENT, precursors.front());
         }
         return;
     }
@@ -2314,13 +2813,17 @@ RoutingProtocol::SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> pr
         {
             destination = i->GetBroadcast();
         }
-        Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
-                            &RoutingProtocol::SendTo,
-                            this,
-                            socket,
-                            p,
-                            destination);
-        ++m_rerrSentCount;
+        AccountControl(p, AODV_CONTROL_RERR);
+        AODV_PROFILE_EVENT(
+            "tpaodv::RerrJitter",
+            Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
+                                &RoutingProtocol::SendTo,
+                                this,
+                                socket,
+                                p,
+                                destination));
+        IncrementStat(&AodvStats::rerrSent);
+        m_eventLog.Record(AODV_EVENT_RERR_SENT, destination);
     }
 }
 
@@ -2376,7 +2879,9 @@ RoutingProtocol::DoInitialize()
         uint32_t startTime = m_uniformRandomVariable->GetInteger(0, 100);
         NS_LOG_DEBUG("Starting at time " << startTime << "ms");
         m_htimer.Schedule(MilliSeconds(startTime));
+        AODV_PROFILE_TIMER("tpaodv::HelloTimer", m_htimer);
     }
+    m_seqnoMonitor.SetTolerance(m_seqnoDeviationFactor, m_seqnoSlack);
     Ipv4RoutingProtocol::DoInitialize();
 }
 
@@ -2384,7 +2889,8 @@ RoutingProtocol::DoInitialize()
 
 std::vector<Ipv4Address>
 RoutingProtocol::SelectNeighborsForRreq(std::vector<Ipv4Address> prior,
-                                        std::vector<Ipv4Address> over) const
+                                        std::vector<Ipv4Address> over,
+                                        const std::set<Ipv4Address>& trusted) const
 {
     // Note: We pass vectors by VALUE (not const ref) so we can shuffle them freely
     // without affecting the original lists in the calling function.
@@ -2404,6 +2910,9 @@ RoutingProtocol::SelectNeighborsForRreq(std::vector<Ipv4Address> prior,
             std::swap(prior[i], prior[j]);
         }
     }
+    // Trusted neighbors go first, the shuffle still orders each group
+    auto isTrusted = [&trusted](Ipv4Address ip) { return trusted.count(ip) > 0; };
+    std::stable_partition(prior.begin(), prior.end(), isTrusted);
 
     // 2. Fill quota with PRIOR neighbors
     for (const auto &ip : prior) {
@@ -2418,7 +2927,8 @@ RoutingProtocol::SelectNeighborsForRreq(std::vector<Ipv4Address> prior,
             uint32_t j = m_uv->GetInteger(0, i);
             std::swap(over[i], over[j]);
         }
-        
+        std::stable_partition(over.begin(), over.end(), isTrusted);
+
         for (const auto &ip : over) {
             if (result.size() >= quota) break;
             result.push_back(ip);
@@ -2432,14 +2942,29 @@ RoutingProtocol::SelectNeighborsForRreq(std::vector<Ipv4Address> prior,
 void
 RoutingProtocol::SendRreqToSelectedNeighbors(Ptr<Packet> packet, RreqHeader rreqHeader, uint8_t ttl)
 {
+    AODV_PROFILE_SCOPE("tpaodv::RoutingProtocol::SendRreqToSelectedNeighbors");
     // 1. Get Neighbors and classify them
     std::vector<Ipv4Address> priorNeighbors;
     std::vector<Ipv4Address> overheadNeighbors;
+    std::set<Ipv4Address> trustedNeighbors;
     Ptr<Node> thisNode = GetObject<Node>();
 
     for (const auto &nb : m_nb.GetNeighbors())
     {
         Ipv4Address neighAddr = nb.m_neighborAddress;
+
+        // Their replies are dropped anyway, do not spend the quota on them
+        int trust = GetTrustLevel(neighAddr);
+        if (trust == TL_BLACKLIST || trust == TL_BLOCKED)
+        {
+            ++m_rreqUntrustedSkippedCount;
+            continue;
+        }
+        if (m_preferTrustedRreqTargets && trust == TL_TRUSTED)
+        {
+            trustedNeighbors.insert(neighAddr);
+        }
+
         Ptr<Node> neighNode = GetNodeFromIpv4(neighAddr);
         if (!neighNode) continue;
 
@@ -2453,7 +2978,7 @@ RoutingProtocol::SendRreqToSelectedNeighbors(Ptr<Packet> packet, RreqHeader rreq
     }
 
     // 2. Select Targets using the helper you just fixed
-    std::vector<Ipv4Address> targets = SelectNeighborsForRreq(priorNeighbors, overheadNeighbors);
+    std::vector<Ipv4Address> targets = SelectNeighborsForRreq(priorNeighbors, overheadNeighbors, trustedNeighbors);
 
     // 3. Send Unicast RREQ to the selected targets
     for (const auto & target : targets)
@@ -2465,16 +2990,21 @@ RoutingProtocol::SendRreqToSelectedNeighbors(Ptr<Packet> packet, RreqHeader rreq
             SocketIpTtlTag tag;
             tag.SetTtl(ttl);
             p->AddPacketTag(tag);
+            rreqHeader.SetCompact(m_compactHeaders);
             p->AddHeader(rreqHeader);
+            AddCompactSavings(rreqHeader.GetCompactSavings());
             TypeHeader tHeader(TPAODVTYPE_RREQ);
             p->AddHeader(tHeader);
             
+            AccountControl(p, AODV_CONTROL_RREQ);
             // Artificial delay to prevent synchronization
-            Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
-                                &RoutingProtocol::SendTo, this, socket, p, target);
+            AODV_PROFILE_EVENT(
+                "tpaodv::RreqJitter",
+                Simulator::Schedule(MilliSeconds(m_uniformRandomVariable->GetInteger(0, 10)),
+                                    &RoutingProtocol::SendTo, this, socket, p, target));
             
             // Increment count for analysis
-            ++m_rreqSentCount; 
+            IncrementStat(&AodvStats::rreqSent); 
         }
     }
 }
@@ -2510,25 +3040,47 @@ RoutingProtocol::CalculateDistanceBetweenNodes(Ptr<Node> a, Ptr<Node> b) const
 int
 RoutingProtocol::GetTrustLevel(Ipv4Address node)
 {
-    if (m_trustTable.find(node) == m_trustTable.end()) {
-        return TL_INITIAL; 
-    }
-    return m_trustTable[node];
+    return m_trustTable.GetTrustLevel(node);
 }
 
 void
 RoutingProtocol::UpdateTrustLevel(Ipv4Address node, int newLevel)
 {
-    m_trustTable[node] = newLevel;
+    m_trustTable.SetTrustLevel(node, newLevel);
+    m_eventLog.Record(AODV_EVENT_TRUST_CHANGED, node, Ipv4Address::GetAny(), 0, 0, newLevel);
     NS_LOG_INFO("TPAODV: Node " << node << " Trust Level updated to " << newLevel);
 }
 
 void
-RoutingProtocol::StartTrustTest(Ipv4Address suspectNode)
+RoutingProtocol::StartTrustTest(Ipv4Address suspectNode, Ipv4Address receiver)
+{
+    // At most one outstanding test per neighbor, further RREPs just wait for its outcome
+    if (m_trustTests.find(suspectNode) != m_trustTests.end())
+    {
+        NS_LOG_LOGIC("Trust Test of " << suspectNode << " already in flight");
+        return;
+    }
+    // The suspect is reachable on the interface its RREP arrived on
+    Ipv4InterfaceAddress iface = m_ipv4->GetAddress(m_ipv4->GetInterfaceForAddress(receiver), 0);
+    TrustTest& test =
+        m_trustTests
+            .emplace(suspectNode,
+                     TrustTest{Timer(Timer::CANCEL_ON_DESTROY), 0, iface, Simulator::Now()})
+            .first->second;
+    ++m_trustTestStartedCount;
+    test.m_timer.SetFunction(&RoutingProtocol::TrustTestTimerExpire, this);
+    test.m_timer.SetArguments(suspectNode);
+    SendTrustTest(suspectNode, iface);
+    test.m_timer.Schedule(m_trustTestTimeout);
+    AODV_PROFILE_TIMER("tpaodv::TrustTestTimer", test.m_timer);
+}
+
+void
+RoutingProtocol::SendTrustTest(Ipv4Address suspectNode, Ipv4InterfaceAddress iface)
 {
     // If the suspect node replies with a high sequence number for ME, it's lying.
 
-    Ipv4Address myIp = m_socketAddresses.begin()->second.GetLocal(); 
+    Ipv4Address myIp = iface.GetLocal();
 
     // Create a specific RREQ for the test
     RreqHeader testRreq;
@@ -2541,39 +3093,319 @@ RoutingProtocol::StartTrustTest(Ipv4Address suspectNode)
     testRreq.SetUnknownSeqno(false);
     
     Ptr<Packet> packet = Create<Packet>();
+    testRreq.SetCompact(m_compactHeaders);
     packet->AddHeader(testRreq);
+    AddCompactSavings(testRreq.GetCompactSavings());
     TypeHeader tHeader(TPAODVTYPE_RREQ); 
     packet->AddHeader(tHeader);
 
-    Ptr<Socket> socket = FindSocketWithInterfaceAddress(m_socketAddresses.begin()->second);
+    Ptr<Socket> socket = FindSocketWithInterfaceAddress(iface);
     if (socket) {
+        AccountControl(packet, AODV_CONTROL_TRUST_TEST);
         socket->SendTo(packet, 0, InetSocketAddress(suspectNode, TPAODV_PORT));
+        ++m_trustTestSentCount;
         NS_LOG_INFO("TPAODV: Sent Trust Test RREQ to " << suspectNode << " looking for " << myIp);
     }
 }
 
+void
+RoutingProtocol::TrustTestTimerExpire(Ipv4Address suspectNode)
+{
+    auto i = m_trustTests.find(suspectNode);
+    if (i == m_trustTests.end())
+    {
+        return;
+    }
+    if (i->second.m_retries < m_trustTestRetries)
+    {
+        // Binary exponential backoff, as for RREQ retries
+        ++i->second.m_retries;
+        NS_LOG_LOGIC("Retrying Trust Test of " << suspectNode << ", attempt "
+                                               << i->second.m_retries + 1);
+        SendTrustTest(suspectNode, i->second.m_iface);
+        i->second.m_timer.Schedule(m_trustTestTimeout * (1 << i->second.m_retries));
+        AODV_PROFILE_TIMER("tpaodv::TrustTestTimer", i->second.m_timer);
+        return;
+    }
+    NS_LOG_INFO("TPAODV: No Trust Test reply from " << suspectNode << " after "
+                                                    << i->second.m_retries + 1 << " attempts");
+    bool rejected =
+        (m_trustTestExhaustedLevel == TL_BLACKLIST || m_trustTestExhaustedLevel == TL_BLOCKED);
+    RecordTrustVerdict(suspectNode, rejected, false);
+    UpdateTrustLevel(suspectNode, m_trustTestExhaustedLevel);
+    if (rejected)
+    {
+        RevokeProvisionalRoutes(suspectNode);
+    }
+    else
+    {
+        m_provisionalRoutes.erase(suspectNode);
+    }
+    // RREPs of a rejected neighbor are dropped whatever the flush setting, as RecvReply would
+    if (m_trustTestTimeoutFlush && !rejected)
+    {
+        ProcessBufferedRreps(suspectNode);
+        return;
+    }
+    auto j = m_pendingTrustPackets.find(suspectNode);
+    if (j != m_pendingTrustPackets.end())
+    {
+        m_pendingRrepTimeoutCount += j->second.size();
+        DiscardBufferedRreps(suspectNode);
+    }
+}
+
+bool
+RoutingProtocol::BufferTrustRrep(Ptr<Packet> p,
+                                 Ipv4Address receiver,
+                                 Ipv4Address sender,
+                                 Ipv4Address dst)
+{
+    auto i = m_pendingTrustPackets.find(sender);
+    bool neighborFull = (i != m_pendingTrustPackets.end() &&
+                         i->second.size() >= m_maxPendingRrepsPerNeighbor);
+    if (!neighborFull && m_pendingTrustPacketCount >= m_maxPendingRreps)
+    {
+        NS_LOG_LOGIC("Pending RREP buffer full, dropping RREP from " << sender);
+        ++m_pendingRrepOverflowCount;
+        return false;
+    }
+    std::deque<PendingRrep>& pending = m_pendingTrustPackets[sender];
+    if (neighborFull)
+    {
+        // Keep the freshest RREPs of this neighbor
+        NS_LOG_LOGIC("Pending RREP buffer of " << sender << " full, dropping the oldest RREP");
+        Ipv4Address dropped = pending.front().m_dst;
+        pending.pop_front();
+        --m_pendingTrustPacketCount;
+        ++m_pendingRrepOverflowCount;
+        ReleaseHeldDiscovery(dropped);
+    }
+    pending.push_back({p->Copy(), receiver, dst});
+    ++m_pendingTrustPacketCount;
+    return true;
+}
+
+void
+RoutingProtocol::DiscardBufferedRreps(Ipv4Address neighbor)
+{
+    auto i = m_pendingTrustPackets.find(neighbor);
+    if (i == m_pendingTrustPackets.end())
+    {
+        return;
+    }
+    NS_LOG_LOGIC("Discarding " << i->second.size() << " RREPs buffered for " << neighbor);
+    m_pendingTrustPacketCount -= i->second.size();
+    std::deque<PendingRrep> packets;
+    packets.swap(i->second);
+    m_pendingTrustPackets.erase(i);
+    for (const auto& pending : packets)
+    {
+        ReleaseHeldDiscovery(pending.m_dst);
+    }
+}
+
+void
+RoutingProtocol::ReleaseHeldDiscovery(Ipv4Address dst)
+{
+    auto i = m_discoveryHeld.find(dst);
+    if (i == m_discoveryHeld.end())
+    {
+        return;
+    }
+    for (const auto& neighbor : m_pendingTrustPackets)
+    {
+        for (const auto& pending : neighbor.second)
+        {
+            if (pending.m_dst == dst)
+            {
+                return;
+            }
+        }
+    }
+    m_discoveryHeld.erase(i);
+}
+
 void
 RoutingProtocol::ProcessBufferedRreps(Ipv4Address neighbor)
 {
-    // If we have packets waiting for this neighbor, process them now
-    if (m_pendingTrustPackets.find(neighbor) != m_pendingTrustPackets.end()) 
+    auto i = m_pendingTrustPackets.find(neighbor);
+    if (i == m_pendingTrustPackets.end())
     {
-        // We need our own IP to call RecvReply correctly
-        // (Assuming the first interface is the one receiving, or just use any valid local IP)
-        Ipv4Address myIp = m_socketAddresses.begin()->second.GetLocal();
+        return;
+    }
+    // Take the packets out first, processing them may buffer new ones
+    std::deque<PendingRrep> packets;
+    packets.swap(i->second);
+    DiscardBufferedRreps(neighbor);
+    m_pendingTrustPacketCount -= packets.size();
 
-        for (auto &p : m_pendingTrustPackets[neighbor]) 
+    for (auto& pending : packets)
+    {
+        // The interface may have gone down while the test ran
+        if (m_ipv4->GetInterfaceForAddress(pending.m_receiver) < 0)
         {
-            NS_LOG_INFO("TPAODV: Re-processing buffered RREP from " << neighbor);
-            
-            // FIX: Actually use 'p' by re-injecting it into RecvReply.
-            // Since we just updated the Trust Level to 2 (Trusted) before calling this function,
-            // RecvReply will now skip the trust check and process the packet normally.
-            RecvReply(p, myIp, neighbor); 
+            NS_LOG_LOGIC("Dropping RREP buffered on removed interface " << pending.m_receiver);
+            continue;
+        }
+        NS_LOG_INFO("TPAODV: Re-processing buffered RREP from " << neighbor);
+        ++m_pendingRrepReleasedCount;
+        ProcessReply(pending.m_packet, pending.m_receiver, neighbor);
+    }
+    // RREPs which did not complete their discovery, stale or on a removed interface, no longer
+    // hold it
+    for (const auto& pending : packets)
+    {
+        ReleaseHeldDiscovery(pending.m_dst);
+    }
+}
+
+void
+RoutingProtocol::RejectNeighbor(Ipv4Address sender)
+{
+    NS_LOG_FUNCTION(this << sender);
+    // No need to finish a test of a neighbor caught lying
+    RecordTrustVerdict(sender, true, true);
+
+    // Repeat offenders are blocked for good, others fall back to TL_INITIAL after
+    // TrustDecayTime, if set, and get tested again
+    uint32_t failures = m_trustTable.IncrementMaliciousCount(sender);
+    if (m_trustBlockThreshold > 0 && failures >= m_trustBlockThreshold)
+    {
+        UpdateTrustLevel(sender, TL_BLOCKED);
+    }
+    else
+    {
+        UpdateTrustLevel(sender, TL_BLACKLIST);
+    }
+
+    auto i = m_pendingTrustPackets.find(sender);
+    if (i != m_pendingTrustPackets.end())
+    {
+        m_pendingRrepRejectedCount += i->second.size();
+        DiscardBufferedRreps(sender);
+    }
+    RevokeProvisionalRoutes(sender);
+}
+
+void
+RoutingProtocol::RecordTrustVerdict(Ipv4Address node, bool rejected, bool answered)
+{
+    Time duration;
+    auto i = m_trustTests.find(node);
+    if (i != m_trustTests.end())
+    {
+        duration = Simulator::Now() - i->second.m_start;
+        m_trustTestDuration.Add(duration);
+        if (!answered)
+        {
+            ++m_trustTestUnansweredCount;
+        }
+        else if (rejected)
+        {
+            ++m_trustTestFailedCount;
+        }
+        else
+        {
+            ++m_trustTestPassedCount;
+        }
+        m_trustTests.erase(i);
+    }
+    m_trustVerdictTrace(node, rejected, duration);
+}
+
+void
+RoutingProtocol::MergeTrustDigest(const TrustDigestHeader& digest, Ipv4Address sender)
+{
+    NS_LOG_FUNCTION(this << sender << digest.GetVerdicts().size());
+    // A handful of untested colluders could otherwise blacklist or whitelist any node
+    if (GetTrustLevel(sender) != TL_TRUSTED)
+    {
+        return;
+    }
+    for (const auto& v : digest.GetVerdicts())
+    {
+        if (v.m_addr == sender || IsMyOwnAddress(v.m_addr))
+        {
+            continue;
+        }
+        // Verdicts we would have forgotten ourselves by now are stale
+        if (m_trustDecayTime.IsStrictlyPositive() && Seconds(v.m_age) >= m_trustDecayTime)
+        {
+            continue;
+        }
+        // Hearsay never blocks a node for good
+        int level = (v.m_level == TL_BLOCKED) ? TL_BLACKLIST : v.m_level;
+        if (m_trustTable.AddRecommendation(v.m_addr, sender, level, m_trustGossipWeight))
+        {
+            NS_LOG_INFO("TPAODV: Node " << v.m_addr << " Trust Level set to "
+                                        << m_trustTable.GetTrustLevel(v.m_addr)
+                                        << " on recommendation of " << sender);
+            ++m_trustGossipAdoptedCount;
+            m_eventLog.Record(AODV_EVENT_TRUST_CHANGED,
+                              v.m_addr,
+                              sender,
+                              0,
+                              0,
+                              m_trustTable.GetTrustLevel(v.m_addr));
+        }
+    }
+}
+
+void
+RoutingProtocol::RevokeProvisionalRoutes(Ipv4Address neighbor)
+{
+    auto i = m_provisionalRoutes.find(neighbor);
+    if (i == m_provisionalRoutes.end())
+    {
+        return;
+    }
+    std::map<Ipv4Address, PriorSeqNo> routes = std::move(i->second);
+    m_provisionalRoutes.erase(i);
+    std::map<Ipv4Address, uint32_t> unreachable;
+    std::vector<Ipv4Address> precursors;
+    for (const auto& [dst, prior] : routes)
+    {
+        RoutingTableEntry toDst;
+        // Routes which were replaced meanwhile no longer go through the neighbor
+        if (m_routingTable.LookupValidRoute(dst, toDst) && toDst.GetNextHop() == neighbor)
+        {
+            toDst.GetPrecursors(precursors);
+            // The RERR must not spread the sequence number the neighbor made up
+            unreachable.insert(std::make_pair(dst, prior.m_seqNo));
+        }
+    }
+    if (unreachable.empty())
+    {
+        return;
+    }
+    NS_LOG_INFO("TPAODV: Revoking " << unreachable.size() << " provisional routes through "
+                                    << neighbor);
+    m_provisionalRevokedCount += unreachable.size();
+    m_routingTable.InvalidateRoutesWithDst(unreachable);
+    // A made up sequence number left in the entry would reject every genuine RREP
+    for (const auto& [dst, seqNo] : unreachable)
+    {
+        RoutingTableEntry toDst;
+        if (m_routingTable.LookupRoute(dst, toDst))
+        {
+            toDst.SetSeqNo(seqNo);
+            toDst.SetValidSeqNo(routes[dst].m_valid);
+            m_routingTable.Update(toDst);
+        }
+    }
+    SendRerrWithUnreachable(unreachable, precursors);
+
+    // Look for another route for the traffic still waiting here; new local traffic triggers
+    // the discovery by itself through RouteOutput
+    for (auto j = unreachable.begin(); j != unreachable.end(); ++j)
+    {
+        auto timer = m_addressReqTimer.find(j->first);
+        bool inSearch = (timer != m_addressReqTimer.end() && timer->second.IsRunning());
+        if (m_queue.Find(j->first) && !inSearch)
+        {
+            SendRequest(j->first);
         }
-        
-        // Clear the buffer after processing
-        m_pendingTrustPackets.erase(neighbor);
     }
 }
 
@@ -2581,27 +3413,194 @@ void
 RoutingProtocol::RecvTrustTestReply(const RrepHeader& rrepHeader, Ipv4Address sender)
 {
     NS_LOG_FUNCTION(this << sender);
-    
-    bool isLying = (rrepHeader.GetDstSeqno() > m_seqNo + 10); 
+
+    auto test = m_trustTests.find(sender);
+    if (test == m_trustTests.end())
+    {
+        // Late answer to a retry of a test which already completed
+        NS_LOG_LOGIC("No Trust Test in flight for " << sender << ", ignoring reply");
+        return;
+    }
+    if (rrepHeader.GetDst() != test->second.m_iface.GetLocal())
+    {
+        // Answer about another of our addresses, not to the test in flight
+        NS_LOG_LOGIC("Reply of " << sender << " is not for the Trust Test from "
+                                 << test->second.m_iface.GetLocal() << ", ignoring it");
+        return;
+    }
+
+    // Our own sequence number is known exactly, only the slack is tolerated
+    Ipv4Address me = rrepHeader.GetDst();
+    m_seqnoMonitor.Observe(me, m_seqNo);
+    double score = m_seqnoMonitor.Score(me, rrepHeader.GetDstSeqno());
+    m_seqnoScoreTrace(sender, me, rrepHeader.GetDstSeqno(), score);
+    bool isLying = (score > 1);
 
     if (isLying)
     {
         NS_LOG_WARN("TPAODV: Node " << sender << " FAILED Trust Test! (Fake SeqNo: " 
                     << rrepHeader.GetDstSeqno() << " My SeqNo: " << m_seqNo << ")");
-        
-        UpdateTrustLevel(sender, TL_BLACKLIST);
-        // (Optional: Schedule timer to release blacklist after timeout)
+        RejectNeighbor(sender);
     }
     else
     {
         NS_LOG_INFO("TPAODV: Node " << sender << " PASSED Trust Test.");
         
+        RecordTrustVerdict(sender, false, true);
         UpdateTrustLevel(sender, TL_TRUSTED);
+        m_provisionalRoutes.erase(sender);
         
         // Process the packets we were holding for them
         ProcessBufferedRreps(sender);
     }
 }
 
+void
+RoutingProtocol::IncrementStat(uint64_t AodvStats::*counter)
+{
+    ++(m_stats.*counter);
+}
+
+void
+RoutingProtocol::AddCompactSavings(int64_t bytes)
+{
+    if (bytes != 0)
+    {
+        m_stats.compactBytesSaved += bytes;
+    }
+}
+
+AodvFootprint
+RoutingProtocol::GetFootprint() const
+{
+    AodvFootprint footprint;
+    footprint.usage[AODV_STATE_ROUTES] = m_routingTable.GetMemoryUsage();
+    footprint.usage[AODV_STATE_NEIGHBORS] = m_nb.GetMemoryUsage();
+    footprint.usage[AODV_STATE_REQUEST_QUEUE] = m_queue.GetMemoryUsage();
+    footprint.usage[AODV_STATE_RREQ_ID_CACHE] = m_rreqIdCache.GetMemoryUsage();
+    footprint.usage[AODV_STATE_DPD] = m_dpd.GetMemoryUsage();
+    AodvMemoryUsage& timers = footprint.usage[AODV_STATE_ADDRESS_REQ_TIMERS];
+    timers.entries = m_addressReqTimer.size();
+    timers.bytes =
+        timers.entries * (sizeof(*m_addressReqTimer.begin()) + AodvMemoryUsage::NODE_OVERHEAD);
+    footprint.usage[AODV_STATE_TRUST_TABLE] = m_trustTable.GetMemoryUsage();
+    footprint.usage[AODV_STATE_SEQNO_MODELS] = m_seqnoMonitor.GetMemoryUsage();
+    AodvMemoryUsage& pending = footprint.usage[AODV_STATE_PENDING_TRUST_PACKETS];
+    for (const auto& neighbor : m_pendingTrustPackets)
+    {
+        pending.bytes += sizeof(neighbor) + AodvMemoryUsage::NODE_OVERHEAD;
+        for (const auto& rrep : neighbor.second)
+        {
+            ++pending.entries;
+            pending.bytes += sizeof(rrep) + rrep.m_packet->GetSize();
+        }
+    }
+    return footprint;
+}
+
+void
+RoutingProtocol::SetFootprintInterval(Time interval)
+{
+    m_footprintInterval = interval;
+    m_footprintTimer.Cancel();
+    if (interval.IsStrictlyPositive())
+    {
+        m_footprintTimer.SetFunction(&RoutingProtocol::FootprintTimerExpire, this);
+        m_footprintTimer.Schedule(interval);
+        AODV_PROFILE_TIMER("tpaodv::FootprintTimer", m_footprintTimer);
+    }
+}
+
+void
+RoutingProtocol::FootprintTimerExpire()
+{
+    m_footprintTrace(GetFootprint());
+    m_footprintTimer.Schedule(m_footprintInterval);
+    AODV_PROFILE_TIMER("tpaodv::FootprintTimer", m_footprintTimer);
+}
+
+void
+RoutingProtocol::SetStatsInterval(Time interval)
+{
+    m_statsInterval = interval;
+    m_statsTimer.Cancel();
+    if (interval.IsStrictlyPositive())
+    {
+        m_statsTimer.SetFunction(&RoutingProtocol::StatsTimerExpire, this);
+        m_statsTimer.Schedule(interval);
+        AODV_PROFILE_TIMER("tpaodv::StatsTimer", m_statsTimer);
+    }
+}
+
+void
+RoutingProtocol::StatsTimerExpire()
+{
+    m_statsTrace(m_stats);
+    m_statsTimer.Schedule(m_statsInterval);
+    AODV_PROFILE_TIMER("tpaodv::StatsTimer", m_statsTimer);
+}
+
+void
+RoutingProtocol::SetEventLog(Ptr<AodvEventLog> log)
+{
+    m_eventLog.SetLog(log);
+}
+
+void
+RoutingProtocol::NotifyRouteChange(const RoutingTableEntry& rt)
+{
+    m_eventLog.Record(rt.GetFlag() == VALID ? AODV_EVENT_ROUTE_ADDED
+                                            : AODV_EVENT_ROUTE_INVALIDATED,
+                      rt.GetDestination(),
+                      rt.GetNextHop(),
+                      rt.GetSeqNo(),
+                      rt.GetHop());
+}
+
+void
+RoutingProtocol::NotifyNewNeighbor(Ipv4Address neighbor)
+{
+    m_eventLog.Record(AODV_EVENT_NEIGHBOR_UP, neighbor);
+}
+
+void
+RoutingProtocol::AccountControl(Ptr<Packet> packet, AodvControlType type)
+{
+    AodvControlTag tag(type);
+    packet->ReplacePacketTag(tag);
+    m_stats.controlBytes[type] += packet->GetSize();
+}
+
+void
+RoutingProtocol::RecordDiscovery(Ipv4Address dst)
+{
+    auto i = m_discoveryStart.find(dst);
+    if (i == m_discoveryStart.end())
+    {
+        return;
+    }
+    Time latency = Simulator::Now() - i->second;
+    m_discoveryStart.erase(i);
+    Time trustDelay;
+    auto j = m_discoveryHeld.find(dst);
+    if (j != m_discoveryHeld.end())
+    {
+        trustDelay = Simulator::Now() - j->second;
+        m_discoveryHeld.erase(j);
+        m_trustTestLatency.Add(trustDelay);
+    }
+    NS_LOG_LOGIC("Route discovery of " << dst << " took " << latency.As(Time::MS) << ", "
+                                       << trustDelay.As(Time::MS) << " in trust tests");
+    m_discoveryLatency.Add(latency);
+    m_discoveryTrace(dst, latency, trustDelay);
+}
+
+void
+RoutingProtocol::AbandonDiscovery(Ipv4Address dst)
+{
+    m_discoveryStart.erase(dst);
+    m_discoveryHeld.erase(dst);
+}
+
 } // namespace tpaodv
 } // namespace ns3
@@ -21,15 +21,22 @@
 #include "tpaodv-packet.h"
 #include "tpaodv-rqueue.h"
 #include "tpaodv-rtable.h"
+#include "tpaodv-seqno-monitor.h"
+#include "tpaodv-trust-table.h"
 
+#include "ns3/aodv-event-log.h"
+#include "ns3/aodv-stats.h"
 #include "ns3/ipv4-interface.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/node.h"
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/traced-callback.h"
 
+#include <deque>
 #include <map>
+#include <set>
 
 namespace ns3
 {
@@ -44,7 +51,7 @@ namespace tpaodv
  *
  * @brief TPAODV routing protocol
  */
-class RoutingProtocol : public Ipv4RoutingProtocol
+class RoutingProtocol : public Ipv4RoutingProtocol, public AodvStatsSource
 {
   public:
     /**
@@ -110,6 +117,51 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      */
     void SetMaxQueueLen(uint32_t len);
 
+    /**
+     * Get the trust decay time
+     * @returns the time after which trusted and blacklisted neighbors fall back to TL_INITIAL
+     */
+    Time GetTrustDecayTime() const
+    {
+        return m_trustDecayTime;
+    }
+
+    /**
+     * Set the trust decay time
+     * @param t the time after which trusted and blacklisted neighbors fall back to TL_INITIAL
+     */
+    void SetTrustDecayTime(Time t);
+
+    /**
+     * Get the maximum number of trust table entries
+     * @returns the maximum number of trust table entries
+     */
+    uint32_t GetMaxTrustEntries() const
+    {
+        return m_maxTrustEntries;
+    }
+
+    /**
+     * Set the maximum number of trust table entries
+     * @param n the maximum number of trust table entries
+     */
+    void SetMaxTrustEntries(uint32_t n);
+
+    /**
+     * Get the maximum number of destinations with a sequence number growth model
+     * @returns the maximum number of modeled destinations
+     */
+    uint32_t GetMaxSeqnoEntries() const
+    {
+        return m_maxSeqnoEntries;
+    }
+
+    /**
+     * Set the maximum number of destinations with a sequence number growth model
+     * @param n the maximum number of modeled destinations
+     */
+    void SetMaxSeqnoEntries(uint32_t n);
+
     /**
      * Get destination only flag
      * @returns the destination only flag
@@ -192,12 +244,103 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      */
     int64_t AssignStreams(int64_t stream);
 
-    uint64_t GetRreqSentCount () const { return m_rreqSentCount; }
-    uint64_t GetRerrSentCount () const { return m_rerrSentCount; }
-    uint64_t GetRrepSentCount () const { return m_rrepSentCount; }
-    uint64_t GetBrokenLinkCount () const { return m_brokenLinkCount; }
-    uint32_t GetRreqReceivedCount () const { return m_rreqReceivedCount; }
-    uint32_t GetMaliciousDropCount () const { return m_maliciousDropCount; }
+    AodvStats GetStats () const override { return m_stats; }
+    const AodvLatencyHistogram& GetDiscoveryLatency () const { return m_discoveryLatency; }
+    /**
+     * @returns the entries and approximate bytes of the protocol state
+     */
+    AodvFootprint GetFootprint () const;
+    /**
+     * Set the time between two samples of the "Footprint" trace source
+     * @param interval the sampling interval, zero disables the sampling
+     */
+    void SetFootprintInterval(Time interval);
+    /**
+     * @returns the footprint sampling interval
+     */
+    Time GetFootprintInterval() const
+    {
+        return m_footprintInterval;
+    }
+    /**
+     * Set the time between two reports of the "Stats" trace source
+     * @param interval the report interval, zero disables the reports
+     */
+    void SetStatsInterval(Time interval);
+    /**
+     * @returns the counter report interval
+     */
+    Time GetStatsInterval() const
+    {
+        return m_statsInterval;
+    }
+    /**
+     * Set the binary log receiving the routing events of the node
+     * @param log the event log, nullptr to stop logging
+     */
+    void SetEventLog(Ptr<AodvEventLog> log);
+    /**
+     * @returns the binary event log, nullptr when logging is off
+     */
+    Ptr<AodvEventLog> GetEventLog() const
+    {
+        return m_eventLog.GetLog();
+    }
+    const AodvLatencyHistogram& GetTrustTestLatency () const { return m_trustTestLatency; }
+    const AodvLatencyHistogram& GetTrustTestDuration () const { return m_trustTestDuration; }
+
+    /**
+     * TracedCallback signature for completed route discoveries.
+     *
+     * @param [in] dst The destination of the discovery.
+     * @param [in] latency The time from the first RREQ to the valid route, retries included.
+     * @param [in] trustDelay The part of the latency spent holding the RREP during a trust test.
+     */
+    typedef void (*DiscoveryTracedCallback)(Ipv4Address dst, Time latency, Time trustDelay);
+
+    /**
+     * TracedCallback signature for first-hand trust verdicts.
+     *
+     * @param [in] node The neighbor the verdict is about.
+     * @param [in] rejected Whether the neighbor was judged malicious.
+     * @param [in] testDuration The duration of the trust test which led to the verdict, zero
+     *             if no test was in flight.
+     */
+    typedef void (*TrustVerdictTracedCallback)(Ipv4Address node, bool rejected, Time testDuration);
+    uint64_t GetRreqSentCount () const { return m_stats.rreqSent; }
+    uint64_t GetRerrSentCount () const { return m_stats.rerrSent; }
+    uint64_t GetRrepSentCount () const { return m_stats.rrepSent; }
+    uint64_t GetBrokenLinkCount () const { return m_stats.brokenLinks; }
+    uint32_t GetRreqReceivedCount () const { return m_stats.rreqReceived; }
+    uint32_t GetMaliciousDropCount () const { return m_stats.maliciousDrops; }
+    int64_t GetCompactBytesSaved () const { return m_stats.compactBytesSaved; }
+    uint32_t GetPendingRrepOverflowCount () const { return m_pendingRrepOverflowCount; }
+    uint32_t GetPendingRrepTimeoutCount () const { return m_pendingRrepTimeoutCount; }
+    uint32_t GetPendingRrepRejectedCount () const { return m_pendingRrepRejectedCount; }
+    uint32_t GetTrustTestSentCount () const { return m_trustTestSentCount; }
+    uint32_t GetTrustTestStartedCount () const { return m_trustTestStartedCount; }
+    uint32_t GetTrustTestPassedCount () const { return m_trustTestPassedCount; }
+    uint32_t GetTrustTestFailedCount () const { return m_trustTestFailedCount; }
+    uint32_t GetTrustTestUnansweredCount () const { return m_trustTestUnansweredCount; }
+    uint32_t GetPendingRrepReleasedCount () const { return m_pendingRrepReleasedCount; }
+    uint32_t GetProvisionalRevokedCount () const { return m_provisionalRevokedCount; }
+    uint32_t GetTrustGossipAdoptedCount () const { return m_trustGossipAdoptedCount; }
+    uint32_t GetRreqUntrustedSkippedCount () const { return m_rreqUntrustedSkippedCount; }
+    uint32_t GetPassiveAcceptedCount () const { return m_passiveAcceptedCount; }
+    uint32_t GetPassiveRejectedCount () const { return m_passiveRejectedCount; }
+
+    /**
+     * TracedCallback signature for sequence number scores.
+     *
+     * @param [in] sender The neighbor which reported the sequence number.
+     * @param [in] dst The destination of the sequence number.
+     * @param [in] seqno The reported sequence number.
+     * @param [in] score The score, above 1 for anomalous sequence numbers.
+     */
+    typedef void (*SeqnoScoreTracedCallback)(Ipv4Address sender,
+                                             Ipv4Address dst,
+                                             uint32_t seqno,
+                                             double score);
 
   protected:
     void DoInitialize() override;
@@ -256,6 +399,26 @@ class RoutingProtocol : public Ipv4RoutingProtocol
                              ///< originated route discovery.
     bool m_enableHello;      ///< Indicates whether a hello messages enable
     bool m_enableBroadcast;  ///< Indicates whether a a broadcast data packets forwarding enable
+    Time m_rerrAggregationWindow; ///< Period during which link breaks are merged into one RERR
+    bool m_compactHeaders;        ///< Use the compact RREQ/RREP encoding
+    Time m_trustDecayTime;        ///< Time after which a trust level falls back to TL_INITIAL
+    uint32_t m_maxTrustEntries;   ///< Maximum number of trust table entries
+    uint32_t m_trustBlockThreshold; ///< Failed trust tests after which a node is blocked
+    uint32_t m_maxPendingRreps;     ///< Maximum number of RREPs held back for trust tests
+    uint32_t m_maxPendingRrepsPerNeighbor; ///< Maximum number of RREPs held back per neighbor
+    Time m_trustTestTimeout;        ///< Time to wait for a trust test reply
+    bool m_trustTestTimeoutFlush;   ///< Process (not drop) held back RREPs on test timeout
+    uint32_t m_trustTestRetries;    ///< Number of trust test retries
+    int m_trustTestExhaustedLevel;  ///< Trust level of a neighbor that never answered a test
+    bool m_optimisticTrust;         ///< Use RREPs of neighbors under test before the verdict
+    bool m_trustGossip;             ///< Exchange trust verdicts in HELLO messages
+    uint32_t m_trustGossipMaxEntries; ///< Maximum number of verdicts per HELLO message
+    double m_trustGossipWeight;     ///< Weight of a verdict reported by a trusted neighbor
+    bool m_passiveSeqnoScoring;     ///< Judge RREPs by their sequence number before testing
+    uint32_t m_seqnoMinSamples;     ///< Observations needed before a destination is scored
+    double m_seqnoDeviationFactor;  ///< Mean deviations of the growth rate tolerated
+    uint32_t m_seqnoSlack;          ///< Sequence number increase tolerated at any time
+    uint32_t m_maxSeqnoEntries;     ///< Maximum number of modeled destinations
 
     /// IP protocol
     Ptr<Ipv4> m_ipv4;
@@ -286,17 +449,106 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     uint16_t m_rreqCount;
     /// Number of RERRs used for RERR rate control
     uint16_t m_rerrCount;
+    /// Unreachable destinations collected during the RERR aggregation window
+    std::map<Ipv4Address, uint32_t> m_pendingRerrUnreachable;
+    /// Precursors of the unreachable destinations collected during the RERR aggregation window
+    std::vector<Ipv4Address> m_pendingRerrPrecursors;
       // P-TPAODV parameters
     uint32_t m_rreqBound;               // Route boundary: max RREQ forwards
     double   m_distanceThreshold;       // meters: boundary between overhead/prior
+    bool     m_preferTrustedRreqTargets; // pick trusted neighbors first within each class
 
     // Statistics
-    uint64_t m_rreqSentCount;
-    uint64_t m_rrepSentCount;
-    uint64_t m_rerrSentCount;
-    uint64_t m_brokenLinkCount;
-    uint32_t m_rreqReceivedCount;
-    uint32_t m_maliciousDropCount;
+    /// Control overhead counters
+    AodvStats m_stats;
+    /**
+     * Increment one of the control overhead counters
+     * @param counter the counter
+     */
+    void IncrementStat(uint64_t AodvStats::*counter);
+    /**
+     * Account for the bytes saved by the compact encoding of a message
+     * @param bytes the bytes saved
+     */
+    void AddCompactSavings(int64_t bytes);
+    /**
+     * Tag a control message with its category and count its bytes
+     * @param packet the control message, ready to be sent
+     * @param type the category
+     */
+    void AccountControl(Ptr<Packet> packet, AodvControlType type);
+    /// Start time of the route discoveries in progress by destination
+    std::map<Ipv4Address, Time> m_discoveryStart;
+    /// Time the first RREP of a discovery in progress was held for a trust test, by destination
+    std::map<Ipv4Address, Time> m_discoveryHeld;
+    /// Latencies of the completed route discoveries
+    AodvLatencyHistogram m_discoveryLatency;
+    /// Part of the route discovery latencies spent holding the RREP during a trust test
+    AodvLatencyHistogram m_trustTestLatency;
+    /// Trace of the completed route discoveries
+    TracedCallback<Ipv4Address, Time, Time> m_discoveryTrace;
+    /// Durations of the completed trust tests
+    AodvLatencyHistogram m_trustTestDuration;
+    /// Trace of the first-hand trust verdicts
+    TracedCallback<Ipv4Address, bool, Time> m_trustVerdictTrace;
+    /**
+     * Account for a completed route discovery
+     * @param dst the destination of the discovery
+     */
+    void RecordDiscovery(Ipv4Address dst);
+    /**
+     * Forget a route discovery which ended without a RREP
+     * @param dst the destination of the discovery
+     */
+    void AbandonDiscovery(Ipv4Address dst);
+    /// Footprint sampling interval
+    Time m_footprintInterval;
+    /// Trace of the footprint samples
+    TracedCallback<const AodvFootprint&> m_footprintTrace;
+    /// Control overhead counter report interval
+    Time m_statsInterval;
+    /// Trace of the control overhead counter reports
+    TracedCallback<const AodvStats&> m_statsTrace;
+    /// Binary event log buffer of the node
+    AodvEventBuffer m_eventLog;
+    /**
+     * Log a route which became valid or stopped being valid
+     * @param rt the routing table entry after the change
+     */
+    void NotifyRouteChange(const RoutingTableEntry& rt);
+    /**
+     * Log a link to a new neighbor
+     * @param neighbor the neighbor address
+     */
+    void NotifyNewNeighbor(Ipv4Address neighbor);
+    /// RREPs dropped because the pending RREP buffer was full
+    uint32_t m_pendingRrepOverflowCount;
+    /// RREPs dropped because their sender did not answer the trust test in time
+    uint32_t m_pendingRrepTimeoutCount;
+    /// RREPs dropped because their sender failed the trust test
+    uint32_t m_pendingRrepRejectedCount;
+    /// Trust test RREQs sent, including retries
+    uint32_t m_trustTestSentCount;
+    /// Trust tests started
+    uint32_t m_trustTestStartedCount;
+    /// Trust tests the neighbor passed
+    uint32_t m_trustTestPassedCount;
+    /// Trust tests ended by a lie of the neighbor
+    uint32_t m_trustTestFailedCount;
+    /// Trust tests the neighbor never answered, retries included
+    uint32_t m_trustTestUnansweredCount;
+    /// Buffered RREPs processed once their sender was trusted or its test gave up
+    uint32_t m_pendingRrepReleasedCount;
+    /// Provisional routes revoked because their next hop failed the trust test
+    uint32_t m_provisionalRevokedCount;
+    /// Trust levels changed on recommendation of neighbors
+    uint32_t m_trustGossipAdoptedCount;
+    /// Blacklisted or blocked neighbors left out of the RREQ targets
+    uint32_t m_rreqUntrustedSkippedCount;
+    /// RREPs of untested neighbors accepted on their sequence number alone
+    uint32_t m_passiveAcceptedCount;
+    /// RREPs dropped because of an anomalous sequence number
+    uint32_t m_passiveRejectedCount;
 
     bool m_isMalicious; 
 
@@ -307,25 +559,39 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     Ptr<Node> GetNodeFromIpv4 (Ipv4Address addr) const;
     double CalculateDistanceBetweenNodes (Ptr<Node> a, Ptr<Node> b) const;
     std::vector<Ipv4Address> SelectNeighborsForRreq (std::vector<Ipv4Address> prior, 
-                                                     std::vector<Ipv4Address> over) const;
+                                                     std::vector<Ipv4Address> over,
+                                                     const std::set<Ipv4Address>& trusted) const;
 
     // --- FIX 2: ADD THIS MISSING DECLARATION ---
     void SendRreqToSelectedNeighbors (Ptr<Packet> packet, RreqHeader rreqHeader, uint8_t ttl);
 
-    static const int TL_TRUSTED = 2;    // Reliable node
-    static const int TL_INITIAL = 1;    // New or released node
-    static const int TL_BLACKLIST = 0;  // Malicious node (Temporary block)
-    static const int TL_BLOCKED = -1;   // Permanently blocked (optional)
+    static const int TL_TRUSTED = TrustTable::TL_TRUSTED;     // Reliable node
+    static const int TL_INITIAL = TrustTable::TL_INITIAL;     // New or released node
+    static const int TL_BLACKLIST = TrustTable::TL_BLACKLIST; // Malicious node (Temporary block)
+    static const int TL_BLOCKED = TrustTable::TL_BLOCKED;     // Permanently blocked
 
-    // Maps Neighbor IP -> Trust Level (int)
-    std::map<Ipv4Address, int> m_trustTable;
-    
-    // Maps Suspect IP -> Number of times it failed (for permanent blocking logic)
-    std::map<Ipv4Address, int> m_maliciousCount;
+    // Neighbor IP -> Trust Level and number of failed trust tests
+    TrustTable m_trustTable;
+
+    // Destination IP -> growth model of its sequence number
+    SeqnoMonitor m_seqnoMonitor;
+
+    /// Trace of the sequence number scores
+    TracedCallback<Ipv4Address, Ipv4Address, uint32_t, double> m_seqnoScoreTrace;
 
 
-    // Maps Neighbor IP -> List of pending RREP packets from them
-    std::map<Ipv4Address, std::vector<Ptr<Packet>>> m_pendingTrustPackets;
+    /// RREP held back until its sender is tested
+    struct PendingRrep
+    {
+        Ptr<Packet> m_packet;   ///< RREP packet
+        Ipv4Address m_receiver; ///< Address of the interface it arrived on
+        Ipv4Address m_dst;      ///< Destination of the RREP
+    };
+
+    // Maps Neighbor IP -> List of pending RREPs from them, oldest first
+    std::map<Ipv4Address, std::deque<PendingRrep>> m_pendingTrustPackets;
+    // Number of packets in m_pendingTrustPackets
+    uint32_t m_pendingTrustPacketCount;
   private:
     /// Start protocol operation
     void Start();
@@ -434,6 +700,13 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * @param src sender address
      */
     void RecvReply(Ptr<Packet> p, Ipv4Address my, Ipv4Address src);
+    /**
+     * Update routes from a RREP whose sender passed the trust checks
+     * @param p packet
+     * @param my destination address
+     * @param src sender address
+     */
+    void ProcessReply(Ptr<Packet> p, Ipv4Address my, Ipv4Address src);
     /**
      * Receive RREP_ACK
      * @param neighbor neighbor address
@@ -489,6 +762,12 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * @param precursors list of addresses of the visited nodes
      */
     void SendRerrMessage(Ptr<Packet> packet, std::vector<Ipv4Address> precursors);
+    /** Build and send as few RERRs as possible for a set of unreachable destinations
+     * @param unreachable unreachable destinations and their sequence numbers
+     * @param precursors list of addresses of the visited nodes
+     */
+    void SendRerrWithUnreachable(const std::map<Ipv4Address, uint32_t>& unreachable,
+                                 const std::vector<Ipv4Address>& precursors);
     /**
      * Send RERR message when no route to forward input packet. Unicast if there is reverse route to
      * originating node, broadcast otherwise.
@@ -519,6 +798,18 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     Timer m_rerrRateLimitTimer;
     /// Reset RERR count and schedule RERR rate limit timer with delay 1 sec.
     void RerrRateLimitTimerExpire();
+    /// RERR aggregation timer
+    Timer m_rerrAggregationTimer;
+    /// Send the RERRs for all link breaks collected during the aggregation window.
+    void RerrAggregationTimerExpire();
+    /// Footprint sampling timer
+    Timer m_footprintTimer;
+    /// Report the footprint of the protocol state and schedule the next sample
+    void FootprintTimerExpire();
+    /// Control overhead counter report timer
+    Timer m_statsTimer;
+    /// Report the control overhead counters and schedule the next report
+    void StatsTimerExpire();
     /// Map IP address + RREQ timer.
     std::map<Ipv4Address, Timer> m_addressReqTimer;
     /**
@@ -543,10 +834,67 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     int GetTrustLevel(Ipv4Address node);
     void UpdateTrustLevel(Ipv4Address node, int newLevel);
     
-    void StartTrustTest(Ipv4Address suspectNode);
+    // Test a neighbor on the interface its RREP arrived on
+    void StartTrustTest(Ipv4Address suspectNode, Ipv4Address receiver);
     
     // Process buffered packets after a test passes
     void ProcessBufferedRreps(Ipv4Address neighbor);
+
+    // Hold back a RREP until its sender is tested, within the buffer bounds. Returns false if
+    // the RREP was dropped
+    bool BufferTrustRrep(Ptr<Packet> p, Ipv4Address receiver, Ipv4Address sender, Ipv4Address dst);
+
+    // Drop the RREPs held back for a neighbor
+    void DiscardBufferedRreps(Ipv4Address neighbor);
+
+    // Stop charging the discovery of dst to trust tests once none of its RREPs is held back
+    void ReleaseHeldDiscovery(Ipv4Address dst);
+
+    // Send one trust test RREQ to the suspect node from the given interface
+    void SendTrustTest(Ipv4Address suspectNode, Ipv4InterfaceAddress iface);
+
+    // Retry the trust test, or give up on the suspect node after the last retry
+    void TrustTestTimerExpire(Ipv4Address suspectNode);
+
+    /// Trust test in flight
+    struct TrustTest
+    {
+        Timer m_timer;                ///< Reply timeout
+        uint32_t m_retries;           ///< Number of retries sent so far
+        Ipv4InterfaceAddress m_iface; ///< Interface the test is sent from
+        Time m_start;                 ///< When the test started
+    };
+
+    // Maps Suspect IP -> its trust test in flight
+    std::map<Ipv4Address, TrustTest> m_trustTests;
+
+    /// Destination sequence number known before a provisional route replaced it
+    struct PriorSeqNo
+    {
+        uint32_t m_seqNo; ///< Sequence number
+        bool m_valid;     ///< Whether a valid sequence number was known
+    };
+
+    // Maps Suspect IP -> destinations installed through it while its test runs
+    std::map<Ipv4Address, std::map<Ipv4Address, PriorSeqNo>> m_provisionalRoutes;
+
+    // Invalidate the provisional routes through a neighbor that failed its test and forget
+    // the sequence numbers it made up
+    void RevokeProvisionalRoutes(Ipv4Address neighbor);
+
+    // Blacklist or block a neighbor caught lying and drop what it sent us
+    void RejectNeighbor(Ipv4Address sender);
+
+    /**
+     * End the trust test of a neighbor, if any, and report the verdict about it
+     * @param node the neighbor
+     * @param rejected whether the neighbor is judged malicious
+     * @param answered whether the neighbor answered the test
+     */
+    void RecordTrustVerdict(Ipv4Address node, bool rejected, bool answered);
+
+    // Merge the trust verdicts a neighbor sent with its HELLO message
+    void MergeTrustDigest(const TrustDigestHeader& digest, Ipv4Address sender);
     
     // New function to handle the Trust Test Reply specifically
     void RecvTrustTestReply(const RrepHeader& rrepHeader, Ipv4Address sender);
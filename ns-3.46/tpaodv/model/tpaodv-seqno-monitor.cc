@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "tpaodv-seqno-monitor.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TpaodvSeqnoMonitor");
+
+namespace tpaodv
+{
+
+/// Gain of the smoothed growth rate, as alpha in RFC 6298
+static const double RATE_GAIN = 0.125;
+/// Gain of the mean deviation, as beta in RFC 6298
+static const double DEVIATION_GAIN = 0.25;
+
+SeqnoMonitor::SeqnoMonitor()
+    : m_maxEntries(0),
+      m_deviationFactor(4),
+      m_slack(10)
+{
+}
+
+void
+SeqnoMonitor::Observe(Ipv4Address dst, uint32_t seqno)
+{
+    auto i = m_models.find(dst);
+    if (i == m_models.end())
+    {
+        m_lru.push_front(dst);
+        m_models[dst] = Model{seqno, Simulator::Now(), 0, 0, 1, m_lru.begin()};
+        Evict();
+        return;
+    }
+    Model& m = i->second;
+    m_lru.splice(m_lru.begin(), m_lru, m.m_lru);
+    int32_t diff = int32_t(seqno - m.m_seqno);
+    if (diff < 0)
+    {
+        // Stale information
+        return;
+    }
+    double elapsed = (Simulator::Now() - m.m_updated).GetSeconds();
+    if (elapsed > 0)
+    {
+        double rate = diff / elapsed;
+        if (m.m_samples == 1)
+        {
+            m.m_rate = rate;
+            m.m_deviation = rate / 2;
+        }
+        else
+        {
+            m.m_deviation =
+                (1 - DEVIATION_GAIN) * m.m_deviation + DEVIATION_GAIN * std::abs(rate - m.m_rate);
+            m.m_rate = (1 - RATE_GAIN) * m.m_rate + RATE_GAIN * rate;
+        }
+        m.m_updated = Simulator::Now();
+        ++m.m_samples;
+    }
+    m.m_seqno = seqno;
+    NS_LOG_LOGIC("Sequence number of " << dst << " is " << seqno << ", growth " << m.m_rate
+                                       << " +- " << m.m_deviation << " per second");
+}
+
+double
+SeqnoMonitor::Score(Ipv4Address dst, uint32_t seqno) const
+{
+    auto i = m_models.find(dst);
+    if (i == m_models.end())
+    {
+        return 0;
+    }
+    const Model& m = i->second;
+    double elapsed = (Simulator::Now() - m.m_updated).GetSeconds();
+    double excess = int32_t(seqno - m.m_seqno) - m.m_rate * elapsed;
+    double tolerance = m_deviationFactor * m.m_deviation * elapsed + m_slack;
+    if (tolerance <= 0)
+    {
+        return excess > 0 ? HUGE_VAL : 0;
+    }
+    return excess / tolerance;
+}
+
+uint32_t
+SeqnoMonitor::GetSamples(Ipv4Address dst) const
+{
+    auto i = m_models.find(dst);
+    return (i == m_models.end()) ? 0 : i->second.m_samples;
+}
+
+AodvMemoryUsage
+SeqnoMonitor::GetMemoryUsage() const
+{
+    AodvMemoryUsage usage;
+    usage.entries = m_models.size();
+    usage.bytes = m_models.bucket_count() * sizeof(void*);
+    // Hash node plus LRU list node
+    usage.bytes += usage.entries * (sizeof(*m_models.begin()) + AodvMemoryUsage::NODE_OVERHEAD +
+                                    sizeof(Ipv4Address) + 2 * sizeof(void*));
+    return usage;
+}
+
+void
+SeqnoMonitor::Clear()
+{
+    m_models.clear();
+    m_lru.clear();
+}
+
+void
+SeqnoMonitor::SetMaxEntries(uint32_t maxEntries)
+{
+    m_maxEntries = maxEntries;
+    Evict();
+}
+
+void
+SeqnoMonitor::Evict()
+{
+    while (m_maxEntries > 0 && m_models.size() > m_maxEntries)
+    {
+        NS_LOG_LOGIC("Forgetting sequence number model of " << m_lru.back());
+        m_models.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+}
+
+} // namespace tpaodv
+} // namespace ns3
@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef TPAODV_SEQNO_MONITOR_H
+#define TPAODV_SEQNO_MONITOR_H
+
+#include "ns3/aodv-stats.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+
+#include <list>
+#include <unordered_map>
+
+namespace ns3
+{
+namespace tpaodv
+{
+/**
+ * @ingroup tpaodv
+ *
+ * @brief Per-destination model of sequence number growth.
+ *
+ * Every destination sequence number observed from a reliable source (RREQ originators, HELLO
+ * messages, RREPs of trusted neighbors) updates a smoothed growth rate and its mean deviation,
+ * the same way TCP estimates the round trip time (RFC 6298). A reported sequence number is then
+ * scored against the value the model expects by now:
+ *
+ *   score = (reported - last - rate * elapsed) / (k * deviation * elapsed + slack)
+ *
+ * A score above 1 is anomalous, such as the inflated sequence number of a blackhole RREP.
+ *
+ * The number of modeled destinations can be bounded, the least recently observed destination
+ * is forgotten first.
+ */
+class SeqnoMonitor
+{
+  public:
+    /// constructor
+    SeqnoMonitor();
+
+    /**
+     * Record a sequence number of a destination
+     * @param dst the destination address
+     * @param seqno the sequence number
+     */
+    void Observe(Ipv4Address dst, uint32_t seqno);
+    /**
+     * Score a reported sequence number of a destination
+     * @param dst the destination address
+     * @param seqno the reported sequence number
+     * @returns the score, above 1 for anomalous sequence numbers, zero for unknown destinations
+     */
+    double Score(Ipv4Address dst, uint32_t seqno) const;
+    /**
+     * @param dst the destination address
+     * @returns the number of observations the model of the destination is built on
+     */
+    uint32_t GetSamples(Ipv4Address dst) const;
+    /**
+     * @returns number of modeled destinations
+     */
+    uint32_t GetSize() const
+    {
+        return m_models.size();
+    }
+    /**
+     * @returns the entries and approximate bytes of the models
+     */
+    AodvMemoryUsage GetMemoryUsage() const;
+
+    /// Forget all destinations
+    void Clear();
+
+    /**
+     * Set the maximum number of modeled destinations, forgetting the least recently observed
+     * ones if needed
+     * @param maxEntries the maximum number of destinations, zero means unbounded
+     */
+    void SetMaxEntries(uint32_t maxEntries);
+
+    /**
+     * @returns the maximum number of modeled destinations
+     */
+    uint32_t GetMaxEntries() const
+    {
+        return m_maxEntries;
+    }
+
+    /**
+     * Set the tolerance of the score
+     * @param deviationFactor the number of mean deviations of the growth rate tolerated
+     * @param slack the sequence number increase tolerated regardless of the elapsed time
+     */
+    void SetTolerance(double deviationFactor, uint32_t slack)
+    {
+        m_deviationFactor = deviationFactor;
+        m_slack = slack;
+    }
+
+  private:
+    /// Growth model of one destination
+    struct Model
+    {
+        /// Last observed sequence number
+        uint32_t m_seqno;
+        /// When the last sequence number was observed
+        Time m_updated;
+        /// Smoothed growth rate, in sequence numbers per second
+        double m_rate;
+        /// Mean deviation of the growth rate
+        double m_deviation;
+        /// Number of observations
+        uint32_t m_samples;
+        /// Position in the LRU list
+        std::list<Ipv4Address>::iterator m_lru;
+    };
+
+    /// Forget least recently observed destinations until the models fit their bound
+    void Evict();
+
+    /// Models by destination
+    std::unordered_map<Ipv4Address, Model, Ipv4AddressHash> m_models;
+    /// Modeled destinations, most recently observed first
+    std::list<Ipv4Address> m_lru;
+    /// Maximum number of modeled destinations
+    uint32_t m_maxEntries;
+    /// Number of mean deviations tolerated
+    double m_deviationFactor;
+    /// Sequence number increase tolerated regardless of the elapsed time
+    uint32_t m_slack;
+};
+
+} // namespace tpaodv
+} // namespace ns3
+
+#endif /* TPAODV_SEQNO_MONITOR_H */
@@ -0,0 +1,245 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+#include "tpaodv-trust-table.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TpaodvTrustTable");
+
+namespace tpaodv
+{
+
+TrustTable::TrustTable(Time decay, uint32_t maxEntries)
+    : m_decay(decay),
+      m_maxEntries(maxEntries)
+{
+}
+
+int
+TrustTable::GetTrustLevel(Ipv4Address addr)
+{
+    auto i = m_table.find(addr);
+    if (i == m_table.end())
+    {
+        return TL_INITIAL;
+    }
+    if (Decay(i->second))
+    {
+        m_lru.erase(i->second.m_lru);
+        m_table.erase(i);
+        return TL_INITIAL;
+    }
+    m_lru.splice(m_lru.begin(), m_lru, i->second.m_lru);
+    return i->second.m_level;
+}
+
+void
+TrustTable::SetTrustLevel(Ipv4Address addr, int level)
+{
+    TrustEntry& entry = Touch(addr);
+    entry.m_level = level;
+    entry.m_expire = Simulator::Now() + m_decay;
+    entry.m_firstHand = true;
+    entry.m_updated = Simulator::Now();
+    entry.m_recommendations.clear();
+}
+
+bool
+TrustTable::AddRecommendation(Ipv4Address addr, Ipv4Address recommender, int level, double weight)
+{
+    if ((level != TL_TRUSTED && level != TL_BLACKLIST) || weight <= 0)
+    {
+        return false;
+    }
+    // A rejected recommendation must neither create an entry nor evict another one
+    auto i = m_table.find(addr);
+    if (i != m_table.end() && (i->second.m_firstHand || i->second.m_level == TL_BLOCKED))
+    {
+        return false;
+    }
+    TrustEntry& entry = Touch(addr);
+    if (entry.m_recommendations.empty())
+    {
+        entry.m_expire = Simulator::Now() + m_decay;
+    }
+    double signedWeight = (level == TL_TRUSTED) ? weight : -weight;
+    double sum = 0;
+    bool found = false;
+    for (auto& rec : entry.m_recommendations)
+    {
+        if (rec.first == recommender)
+        {
+            rec.second = signedWeight;
+            found = true;
+        }
+        sum += rec.second;
+    }
+    if (!found && entry.m_recommendations.size() < MAX_RECOMMENDERS)
+    {
+        entry.m_recommendations.emplace_back(recommender, signedWeight);
+        sum += signedWeight;
+    }
+
+    int newLevel = TL_INITIAL;
+    if (sum >= 1)
+    {
+        newLevel = TL_TRUSTED;
+    }
+    else if (sum <= -1)
+    {
+        newLevel = TL_BLACKLIST;
+    }
+    if (newLevel == entry.m_level)
+    {
+        return false;
+    }
+    NS_LOG_LOGIC("Second-hand trust level of " << addr << " is now " << newLevel);
+    entry.m_level = newLevel;
+    entry.m_expire = Simulator::Now() + m_decay;
+    entry.m_updated = Simulator::Now();
+    return true;
+}
+
+void
+TrustTable::GetFirstHandVerdicts(std::vector<Verdict>& verdicts, uint32_t max)
+{
+    Purge();
+    verdicts.clear();
+    // Negative verdicts are the ones worth spreading first
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (auto i = m_lru.begin(); i != m_lru.end() && verdicts.size() < max; ++i)
+        {
+            const TrustEntry& entry = m_table.find(*i)->second;
+            bool negative = (entry.m_level == TL_BLACKLIST || entry.m_level == TL_BLOCKED);
+            if (entry.m_firstHand && entry.m_level != TL_INITIAL && negative == (pass == 0))
+            {
+                verdicts.push_back({*i, entry.m_level, entry.m_updated});
+            }
+        }
+    }
+}
+
+uint32_t
+TrustTable::IncrementMaliciousCount(Ipv4Address addr)
+{
+    return ++Touch(addr).m_maliciousCount;
+}
+
+uint32_t
+TrustTable::GetMaliciousCount(Ipv4Address addr) const
+{
+    auto i = m_table.find(addr);
+    return (i == m_table.end()) ? 0 : i->second.m_maliciousCount;
+}
+
+void
+TrustTable::Purge()
+{
+    for (auto i = m_table.begin(); i != m_table.end();)
+    {
+        if (Decay(i->second))
+        {
+            m_lru.erase(i->second.m_lru);
+            i = m_table.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+AodvMemoryUsage
+TrustTable::GetMemoryUsage() const
+{
+    AodvMemoryUsage usage;
+    usage.entries = m_table.size();
+    usage.bytes = m_table.bucket_count() * sizeof(void*);
+    for (const auto& entry : m_table)
+    {
+        // Hash node plus LRU list node
+        usage.bytes += sizeof(entry) + AodvMemoryUsage::NODE_OVERHEAD + sizeof(Ipv4Address) +
+                       2 * sizeof(void*) +
+                       entry.second.m_recommendations.capacity() *
+                           sizeof(std::pair<Ipv4Address, double>);
+    }
+    return usage;
+}
+
+void
+TrustTable::Clear()
+{
+    m_table.clear();
+    m_lru.clear();
+}
+
+void
+TrustTable::SetMaxEntries(uint32_t maxEntries)
+{
+    m_maxEntries = maxEntries;
+    Evict();
+}
+
+TrustTable::TrustEntry&
+TrustTable::Touch(Ipv4Address addr)
+{
+    auto i = m_table.find(addr);
+    if (i != m_table.end())
+    {
+        Decay(i->second);
+        m_lru.splice(m_lru.begin(), m_lru, i->second.m_lru);
+        return i->second;
+    }
+    m_lru.push_front(addr);
+    TrustEntry& entry = m_table[addr];
+    entry.m_level = TL_INITIAL;
+    entry.m_expire = Simulator::Now();
+    entry.m_maliciousCount = 0;
+    entry.m_firstHand = false;
+    entry.m_updated = Simulator::Now();
+    entry.m_lru = m_lru.begin();
+    Evict();
+    return entry;
+}
+
+bool
+TrustTable::Decay(TrustEntry& entry) const
+{
+    if (entry.m_level != TL_BLOCKED && m_decay.IsStrictlyPositive() &&
+        entry.m_expire <= Simulator::Now())
+    {
+        entry.m_level = TL_INITIAL;
+        entry.m_firstHand = false;
+        entry.m_recommendations.clear();
+    }
+    return entry.m_level == TL_INITIAL && entry.m_maliciousCount == 0 &&
+           entry.m_recommendations.empty();
+}
+
+void
+TrustTable::Evict()
+{
+    // The most recently used entry is the one the caller holds, it is never evicted
+    auto i = m_lru.end();
+    while (m_maxEntries > 0 && m_table.size() > m_maxEntries && --i != m_lru.begin())
+    {
+        auto entry = m_table.find(*i);
+        // Forgetting a blocked node or a repeat offender would release an attacker
+        if (entry->second.m_level == TL_BLOCKED || entry->second.m_maliciousCount > 0)
+        {
+            continue;
+        }
+        NS_LOG_LOGIC("Evicting trust entry of " << *i);
+        m_table.erase(entry);
+        i = m_lru.erase(i);
+    }
+}
+
+} // namespace tpaodv
+} // namespace ns3
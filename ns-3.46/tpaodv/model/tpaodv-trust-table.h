@@ -0,0 +1,202 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#ifndef TPAODV_TRUST_TABLE_H
+#define TPAODV_TRUST_TABLE_H
+
+#include "ns3/aodv-stats.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/nstime.h"
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+namespace tpaodv
+{
+/**
+ * @ingroup tpaodv
+ *
+ * @brief Bounded, aging table of neighbor trust levels.
+ *
+ * Entries are hashed by address. A trusted or blacklisted node falls back to TL_INITIAL when
+ * its level has not been set again for the decay time; a blocked node never does. Each entry
+ * also counts the trust tests the node failed, so that repeat offenders can be escalated to
+ * TL_BLOCKED. When the table is full, the least recently used entry is evicted, except that
+ * blocked nodes and nodes which failed a test are pinned: the table exceeds its bound rather
+ * than forget them.
+ *
+ * Levels set with SetTrustLevel are first-hand verdicts. Neighbors may also recommend a level
+ * for a node: the weights of distinct recommenders add up (trusted counts positive, blacklisted
+ * negative) and the node takes the recommended level as a second-hand verdict once the sum
+ * reaches 1 in magnitude. Second-hand verdicts never override first-hand ones and decay the
+ * same way.
+ */
+class TrustTable
+{
+  public:
+    static const int TL_TRUSTED = 2;   ///< Reliable node
+    static const int TL_INITIAL = 1;   ///< New or released node
+    static const int TL_BLACKLIST = 0; ///< Malicious node (temporary block)
+    static const int TL_BLOCKED = -1;  ///< Permanently blocked node
+
+    /// Maximum number of recommenders remembered per node
+    static const uint32_t MAX_RECOMMENDERS = 8;
+
+    /// First-hand verdict about a node
+    struct Verdict
+    {
+        Ipv4Address m_addr; ///< Node address
+        int m_level;        ///< Trust level
+        Time m_updated;     ///< When the level was set
+    };
+
+    /**
+     * constructor
+     * @param decay the time after which trusted and blacklisted nodes fall back to TL_INITIAL,
+     *        zero disables the decay
+     * @param maxEntries the maximum number of entries, zero means unbounded
+     */
+    TrustTable(Time decay, uint32_t maxEntries);
+
+    /**
+     * Get the trust level of a node and mark the entry as recently used
+     * @param addr the node address
+     * @returns the trust level, TL_INITIAL for unknown nodes
+     */
+    int GetTrustLevel(Ipv4Address addr);
+    /**
+     * Set the trust level of a node and restart its decay
+     * @param addr the node address
+     * @param level the trust level
+     */
+    void SetTrustLevel(Ipv4Address addr, int level);
+    /**
+     * Count one more failed trust test for a node
+     * @param addr the node address
+     * @returns the number of failed tests, including this one
+     */
+    uint32_t IncrementMaliciousCount(Ipv4Address addr);
+    /**
+     * @param addr the node address
+     * @returns the number of trust tests the node failed
+     */
+    uint32_t GetMaliciousCount(Ipv4Address addr) const;
+    /**
+     * Merge the verdict of a neighbor about a node
+     * @param addr the node address
+     * @param recommender the neighbor reporting the verdict
+     * @param level the reported trust level, TL_TRUSTED or TL_BLACKLIST
+     * @param weight the weight of the recommender, nothing is recorded unless positive
+     * @returns true if the trust level of the node changed
+     */
+    bool AddRecommendation(Ipv4Address addr, Ipv4Address recommender, int level, double weight);
+    /**
+     * Get the first-hand verdicts other than TL_INITIAL, blacklisted and blocked nodes first and
+     * the most recently used first within each group
+     * @param verdicts the verdicts
+     * @param max the maximum number of verdicts
+     */
+    void GetFirstHandVerdicts(std::vector<Verdict>& verdicts, uint32_t max);
+    /// Apply the decay to all entries and remove the ones which carry no information any more
+    void Purge();
+    /**
+     * @returns number of entries in the table
+     */
+    uint32_t GetSize() const
+    {
+        return m_table.size();
+    }
+
+    /**
+     * @returns the entries and approximate bytes of the table, recommendations included
+     */
+    AodvMemoryUsage GetMemoryUsage() const;
+
+    /// Remove all entries
+    void Clear();
+
+    /**
+     * Set the decay time
+     * @param decay the decay time, zero disables the decay
+     */
+    void SetDecayTime(Time decay)
+    {
+        m_decay = decay;
+    }
+
+    /**
+     * @returns the decay time
+     */
+    Time GetDecayTime() const
+    {
+        return m_decay;
+    }
+
+    /**
+     * Set the maximum number of entries, evicting the least recently used unpinned ones if
+     * needed
+     * @param maxEntries the maximum number of entries, zero means unbounded
+     */
+    void SetMaxEntries(uint32_t maxEntries);
+
+    /**
+     * @returns the maximum number of entries
+     */
+    uint32_t GetMaxEntries() const
+    {
+        return m_maxEntries;
+    }
+
+  private:
+    /// Trust table entry
+    struct TrustEntry
+    {
+        /// Trust level
+        int m_level;
+        /// When a trusted or blacklisted level falls back to TL_INITIAL
+        Time m_expire;
+        /// Number of failed trust tests
+        uint32_t m_maliciousCount;
+        /// Whether the level is a first-hand verdict
+        bool m_firstHand;
+        /// When the level was set
+        Time m_updated;
+        /// Signed weights of the recommenders
+        std::vector<std::pair<Ipv4Address, double>> m_recommendations;
+        /// Position in the LRU list
+        std::list<Ipv4Address>::iterator m_lru;
+    };
+
+    /**
+     * Find the entry of a node, creating it if needed, and mark it as recently used
+     * @param addr the node address
+     * @returns the entry
+     */
+    TrustEntry& Touch(Ipv4Address addr);
+    /**
+     * Apply the decay to an entry
+     * @param entry the entry
+     * @returns true if the entry carries no information any more
+     */
+    bool Decay(TrustEntry& entry) const;
+    /// Evict least recently used entries, pinned ones excepted, until the table fits its bound
+    void Evict();
+
+    /// Trust entries
+    std::unordered_map<Ipv4Address, TrustEntry, Ipv4AddressHash> m_table;
+    /// Addresses of the entries, most recently used first
+    std::list<Ipv4Address> m_lru;
+    /// Decay time
+    Time m_decay;
+    /// Maximum number of entries
+    uint32_t m_maxEntries;
+};
+
+} // namespace tpaodv
+} // namespace ns3
+
+#endif /* TPAODV_TRUST_TABLE_H */
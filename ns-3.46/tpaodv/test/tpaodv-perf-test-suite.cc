@@ -0,0 +1,30 @@
+/*
+ * SPDX-License-Identifier: GPL-2.0-only
+ */
+
+#include "../../aodv/test/aodv-perf-test.h"
+
+#include "ns3/tpaodv-helper.h"
+
+using namespace ns3;
+
+AODV_PERF_COUNT_ALLOCATIONS()
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief TPAODV performance regression test suite
+ */
+class TpaodvPerfTestSuite : public TestSuite
+{
+  public:
+    TpaodvPerfTestSuite()
+        : TestSuite("routing-tpaodv-performance", Type::PERFORMANCE)
+    {
+        SetDataDir(NS_TEST_SOURCEDIR);
+        AddTestCase(new AodvPerfTest<TpaodvHelper>("TPAODV", "grid-5x5", 5, 5, Seconds(30)),
+                    TestCase::Duration::QUICK);
+        AddTestCase(new AodvPerfTest<TpaodvHelper>("TPAODV", "grid-10x10", 10, 20, Seconds(30)),
+                    TestCase::Duration::EXTENSIVE);
+    }
+} g_tpaodvPerfTestSuite; ///< the test suite
@@ -0,0 +1,631 @@
+/*
+ * Copyright (c) 2009 IITP RAS
+ *
+ * SPDX-License-Identifier: GPL-2.0-only
+ *
+ * Authors: Pavel Boyko <boyko@iitp.ru>
+ */
+
+#include "tpaodv-regression.h"
+
+#include "bug-772.h"
+
+#include "ns3/abort.h"
+#include "ns3/tpaodv-helper.h"
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/double.h"
+#include "ns3/icmpv4.h"
+#include "ns3/integer.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/mobility-model.h"
+#include "ns3/pcap-file.h"
+#include "ns3/pcap-test.h"
+#include "ns3/position-allocator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/tpaodv-routing-protocol.h"
+#include "ns3/udp-echo-helper.h"
+#include "ns3/uinteger.h"
+#include "ns3/yans-wifi-helper.h"
+
+#include <sstream>
+
+using namespace ns3;
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief TPAODV regression test suite
+ */
+class AodvRegressionTestSuite : public TestSuite
+{
+  public:
+    AodvRegressionTestSuite()
+        : TestSuite("routing-tpaodv-regression", Type::SYSTEM)
+    {
+        SetDataDir(NS_TEST_SOURCEDIR);
+        // General RREQ-RREP-RRER test case
+        AddTestCase(new ChainRegressionTest("tpaodv-chain-regression-test"),
+                    TestCase::Duration::QUICK);
+        // \bugid{606} test case, should crash if bug is not fixed
+        AddTestCase(new ChainRegressionTest("bug-606-test", Seconds(10), 3, Seconds(1)),
+                    TestCase::Duration::QUICK);
+        // \bugid{772} UDP test case
+        AddTestCase(new Bug772ChainTest("udp-chain-test", "ns3::UdpSocketFactory", Seconds(3), 10),
+                    TestCase::Duration::QUICK);
+        // Revoked provisional routes must not keep the forged sequence number
+        AddTestCase(new BlackholeRevokeTest(), TestCase::Duration::QUICK);
+        AddTestCase(new TrustTestTimeoutTest(), TestCase::Duration::QUICK);
+        AddTestCase(new BenignRelayTest(), TestCase::Duration::QUICK);
+    }
+} g_tpaodvRegressionTestSuite; ///< the test suite
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief Chain Regression Test
+ */
+ChainRegressionTest::ChainRegressionTest(const char* const prefix,
+                                         Time t,
+                                         uint32_t size,
+                                         Time arpAliveTimeout)
+    : TestCase("TPAODV chain regression test"),
+      m_nodes(nullptr),
+      m_prefix(prefix),
+      m_time(t),
+      m_size(size),
+      m_step(120),
+      m_arpAliveTimeout(arpAliveTimeout),
+      m_seq(0)
+{
+}
+
+ChainRegressionTest::~ChainRegressionTest()
+{
+    delete m_nodes;
+}
+
+void
+ChainRegressionTest::SendPing()
+{
+    if (Simulator::Now() >= m_time)
+    {
+        return;
+    }
+
+    Ptr<Packet> p = Create<Packet>();
+    Icmpv4Echo echo;
+    echo.SetSequenceNumber(m_seq);
+    m_seq++;
+    echo.SetIdentifier(0);
+
+    Ptr<Packet> dataPacket = Create<Packet>(56);
+    echo.SetData(dataPacket);
+    p->AddHeader(echo);
+    Icmpv4Header header;
+    header.SetType(Icmpv4Header::ICMPV4_ECHO);
+    header.SetCode(0);
+    if (Node::ChecksumEnabled())
+    {
+        header.EnableChecksum();
+    }
+    p->AddHeader(header);
+    m_socket->Send(p, 0);
+    Simulator::Schedule(Seconds(1), &ChainRegressionTest::SendPing, this);
+}
+
+void
+ChainRegressionTest::DoRun()
+{
+    RngSeedManager::SetSeed(12345);
+    RngSeedManager::SetRun(7);
+    Config::SetDefault("ns3::ArpCache::AliveTimeout", TimeValue(m_arpAliveTimeout));
+
+    CreateNodes();
+    CreateDevices();
+
+    // At m_time / 3 move central node away and see what will happen
+    Ptr<Node> node = m_nodes->Get(m_size / 2);
+    Ptr<MobilityModel> mob = node->GetObject<MobilityModel>();
+    Simulator::Schedule(Time(m_time / 3), &MobilityModel::SetPosition, mob, Vector(1e5, 1e5, 1e5));
+
+    Simulator::Stop(m_time);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    CheckResults();
+
+    delete m_nodes, m_nodes = nullptr;
+}
+
+void
+ChainRegressionTest::CreateNodes()
+{
+    m_nodes = new NodeContainer;
+    m_nodes->Create(m_size);
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator("ns3::GridPositionAllocator",
+                                  "MinX",
+                                  DoubleValue(0.0),
+                                  "MinY",
+                                  DoubleValue(0.0),
+                                  "DeltaX",
+                                  DoubleValue(m_step),
+                                  "DeltaY",
+                                  DoubleValue(0),
+                                  "GridWidth",
+                                  UintegerValue(m_size),
+                                  "LayoutType",
+                                  StringValue("RowFirst"));
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(*m_nodes);
+}
+
+void
+ChainRegressionTest::CreateDevices()
+{
+    // 1. Setup WiFi
+    int64_t streamsUsed = 0;
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.DisablePreambleDetectionModel();
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+
+    // This test suite output was originally based on YansErrorRateModel
+    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"),
+                                 "RtsCtsThreshold",
+                                 StringValue("2200"));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, *m_nodes);
+
+    // Assign fixed stream numbers to wifi and channel random variables
+    streamsUsed += WifiHelper::AssignStreams(devices, streamsUsed);
+    // Assign 6 streams per device
+    NS_TEST_ASSERT_MSG_EQ(streamsUsed, (devices.GetN() * 2), "Stream assignment mismatch");
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+    // Assign 0 streams per channel for this configuration
+    NS_TEST_ASSERT_MSG_EQ(streamsUsed, (devices.GetN() * 2), "Stream assignment mismatch");
+
+    // 2. Setup TCP/IP & TPAODV
+    AodvHelper tpaodv; // Use default parameters here
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(tpaodv);
+    internetStack.Install(*m_nodes);
+    streamsUsed += internetStack.AssignStreams(*m_nodes, streamsUsed);
+    // InternetStack uses m_size more streams
+    NS_TEST_ASSERT_MSG_EQ(streamsUsed, (devices.GetN() * 5) + m_size, "Stream assignment mismatch");
+    streamsUsed += tpaodv.AssignStreams(*m_nodes, streamsUsed);
+    // TPAODV uses m_size more streams
+    NS_TEST_ASSERT_MSG_EQ(streamsUsed,
+                          ((devices.GetN() * 5) + (2 * m_size)),
+                          "Stream assignment mismatch");
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // 3. Setup ping
+    m_socket =
+        Socket::CreateSocket(m_nodes->Get(0), TypeId::LookupByName("ns3::Ipv4RawSocketFactory"));
+    m_socket->SetAttribute("Protocol", UintegerValue(1)); // icmp
+    InetSocketAddress src = InetSocketAddress(Ipv4Address::GetAny(), 0);
+    m_socket->Bind(src);
+    InetSocketAddress dst = InetSocketAddress(interfaces.GetAddress(m_size - 1), 0);
+    m_socket->Connect(dst);
+
+    SendPing();
+
+    // 4. write PCAP
+    wifiPhy.EnablePcapAll(CreateTempDirFilename(m_prefix));
+}
+
+void
+ChainRegressionTest::CheckResults()
+{
+    for (uint32_t i = 0; i < m_size; ++i)
+    {
+        NS_PCAP_TEST_EXPECT_EQ(m_prefix << "-" << i << "-0.pcap");
+    }
+}
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief Blackhole Revoke Test
+ */
+BlackholeRevokeTest::BlackholeRevokeTest()
+    : TestCase("TPAODV provisional route of a blackhole is revoked"),
+      m_nodes(nullptr),
+      m_time(Seconds(20)),
+      m_replies(0)
+{
+}
+
+BlackholeRevokeTest::~BlackholeRevokeTest()
+{
+    delete m_nodes;
+}
+
+void
+BlackholeRevokeTest::ReceiveReply(Ptr<const Packet> p)
+{
+    ++m_replies;
+}
+
+void
+BlackholeRevokeTest::DoRun()
+{
+    RngSeedManager::SetSeed(12345);
+    RngSeedManager::SetRun(7);
+
+    CreateNodes();
+    CreateDevices();
+
+    Simulator::Stop(m_time);
+    Simulator::Run();
+    CheckResults();
+    Simulator::Destroy();
+
+    delete m_nodes, m_nodes = nullptr;
+}
+
+void
+BlackholeRevokeTest::CreateNodes()
+{
+    // S, R, D and the blackhole B
+    m_nodes = new NodeContainer;
+    m_nodes->Create(4);
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator>();
+    positions->Add(Vector(0, 0, 0));
+    positions->Add(Vector(120, 0, 0));
+    positions->Add(Vector(240, 0, 0));
+    positions->Add(Vector(-120, 0, 0));
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator(positions);
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(*m_nodes);
+}
+
+void
+BlackholeRevokeTest::CreateDevices()
+{
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.DisablePreambleDetectionModel();
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"),
+                                 "RtsCtsThreshold",
+                                 StringValue("2200"));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, *m_nodes);
+
+    TpaodvHelper tpaodv;
+    tpaodv.Set("OptimisticTrust", BooleanValue(true));
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(tpaodv);
+    internetStack.Install(*m_nodes);
+    m_nodes->Get(3)->GetObject<tpaodv::RoutingProtocol>()->SetAttribute("IsMalicious",
+                                                                         BooleanValue(true));
+    int64_t streamsUsed = WifiHelper::AssignStreams(devices, 0);
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+    streamsUsed += internetStack.AssignStreams(*m_nodes, streamsUsed);
+    tpaodv.AssignStreams(*m_nodes, streamsUsed);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    UdpEchoServerHelper server(9);
+    ApplicationContainer apps = server.Install(m_nodes->Get(2));
+    UdpEchoClientHelper client(interfaces.GetAddress(2), 9);
+    client.SetAttribute("MaxPackets", UintegerValue(1000));
+    client.SetAttribute("Interval", TimeValue(Seconds(0.5)));
+    client.SetAttribute("PacketSize", UintegerValue(64));
+    ApplicationContainer c = client.Install(m_nodes->Get(0));
+    c.Get(0)->TraceConnectWithoutContext("Rx",
+                                         MakeCallback(&BlackholeRevokeTest::ReceiveReply, this));
+    c.Start(Seconds(3));
+    apps.Add(c);
+    apps.Stop(m_time);
+}
+
+void
+BlackholeRevokeTest::CheckResults()
+{
+    Ptr<tpaodv::RoutingProtocol> source = m_nodes->Get(0)->GetObject<tpaodv::RoutingProtocol>();
+    NS_TEST_EXPECT_MSG_GT(source->GetTrustTestFailedCount(), 0, "Blackhole must fail its test");
+    NS_TEST_EXPECT_MSG_GT(source->GetProvisionalRevokedCount(),
+                          0,
+                          "Provisional route of the blackhole must be revoked");
+    NS_TEST_EXPECT_MSG_GT(m_replies, 0, "Genuine route must be accepted after the revocation");
+}
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief Trust Test Timeout Test
+ */
+TrustTestTimeoutTest::TrustTestTimeoutTest()
+    : TestCase("TPAODV RREPs of a neighbor rejected on trust test timeout are dropped"),
+      m_nodes(nullptr),
+      m_time(Seconds(15)),
+      m_moved(false)
+{
+}
+
+TrustTestTimeoutTest::~TrustTestTimeoutTest()
+{
+    delete m_nodes;
+}
+
+void
+TrustTestTimeoutTest::SourceTx(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    Ipv4Header header;
+    p->PeekHeader(header);
+    if (m_moved || header.GetDestination() != m_blackhole)
+    {
+        return;
+    }
+    // Before the test leaves the source, so that no try ever reaches the blackhole
+    m_moved = true;
+    m_nodes->Get(1)->GetObject<MobilityModel>()->SetPosition(Vector(-1e5, 0, 0));
+}
+
+void
+TrustTestTimeoutTest::DoRun()
+{
+    RngSeedManager::SetSeed(12345);
+    RngSeedManager::SetRun(7);
+
+    CreateNodes();
+    CreateDevices();
+
+    Simulator::Stop(m_time);
+    Simulator::Run();
+    CheckResults();
+    Simulator::Destroy();
+
+    delete m_nodes, m_nodes = nullptr;
+}
+
+void
+TrustTestTimeoutTest::CreateNodes()
+{
+    // S, the blackhole B and D, out of the range of both
+    m_nodes = new NodeContainer;
+    m_nodes->Create(3);
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator>();
+    positions->Add(Vector(0, 0, 0));
+    positions->Add(Vector(-120, 0, 0));
+    positions->Add(Vector(1000, 0, 0));
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator(positions);
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(*m_nodes);
+}
+
+void
+TrustTestTimeoutTest::CreateDevices()
+{
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.DisablePreambleDetectionModel();
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"),
+                                 "RtsCtsThreshold",
+                                 StringValue("2200"));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, *m_nodes);
+
+    TpaodvHelper tpaodv;
+    tpaodv.Set("TrustTestTimeoutFlush", BooleanValue(true));
+    tpaodv.Set("TrustTestExhaustedLevel", IntegerValue(tpaodv::TrustTable::TL_BLACKLIST));
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(tpaodv);
+    internetStack.Install(*m_nodes);
+    m_nodes->Get(1)->GetObject<tpaodv::RoutingProtocol>()->SetAttribute("IsMalicious",
+                                                                         BooleanValue(true));
+    int64_t streamsUsed = WifiHelper::AssignStreams(devices, 0);
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+    streamsUsed += internetStack.AssignStreams(*m_nodes, streamsUsed);
+    tpaodv.AssignStreams(*m_nodes, streamsUsed);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+    m_blackhole = interfaces.GetAddress(1);
+    m_nodes->Get(0)->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "Tx",
+        MakeCallback(&TrustTestTimeoutTest::SourceTx, this));
+
+    UdpEchoServerHelper server(9);
+    ApplicationContainer apps = server.Install(m_nodes->Get(2));
+    UdpEchoClientHelper client(interfaces.GetAddress(2), 9);
+    client.SetAttribute("MaxPackets", UintegerValue(1000));
+    client.SetAttribute("Interval", TimeValue(Seconds(0.5)));
+    client.SetAttribute("PacketSize", UintegerValue(64));
+    ApplicationContainer c = client.Install(m_nodes->Get(0));
+    c.Start(Seconds(3));
+    apps.Add(c);
+    apps.Stop(m_time);
+}
+
+void
+TrustTestTimeoutTest::CheckResults()
+{
+    Ptr<tpaodv::RoutingProtocol> source = m_nodes->Get(0)->GetObject<tpaodv::RoutingProtocol>();
+    NS_TEST_EXPECT_MSG_EQ(m_moved, true, "Blackhole must be tested");
+    NS_TEST_EXPECT_MSG_GT(source->GetTrustTestUnansweredCount(),
+                          0,
+                          "Trust test of the blackhole must run out of retries");
+    NS_TEST_EXPECT_MSG_GT(source->GetPendingRrepTimeoutCount(),
+                          0,
+                          "RREPs of the blackhole must be dropped on timeout");
+    NS_TEST_EXPECT_MSG_EQ(source->GetPendingRrepReleasedCount(),
+                          0,
+                          "RREPs of a blacklisted neighbor must not be processed");
+}
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief Benign Relay Test
+ */
+BenignRelayTest::BenignRelayTest()
+    : TestCase("TPAODV benign relay of a forged sequence number is not blocked"),
+      m_nodes(nullptr),
+      m_time(Seconds(25)),
+      m_relayVerdicts(0),
+      m_relayRejected(0)
+{
+}
+
+BenignRelayTest::~BenignRelayTest()
+{
+    delete m_nodes;
+}
+
+void
+BenignRelayTest::TrustVerdict(Ipv4Address node, bool rejected, Time testDuration)
+{
+    if (node == m_relay)
+    {
+        ++m_relayVerdicts;
+        m_relayRejected += rejected;
+    }
+}
+
+void
+BenignRelayTest::DoRun()
+{
+    RngSeedManager::SetSeed(12345);
+    RngSeedManager::SetRun(7);
+
+    CreateNodes();
+    CreateDevices();
+
+    // D leaves S for the other side of R
+    Ptr<MobilityModel> mob = m_nodes->Get(2)->GetObject<MobilityModel>();
+    Simulator::Schedule(Seconds(10), &MobilityModel::SetPosition, mob, Vector(120, 100, 0));
+
+    Simulator::Stop(m_time);
+    Simulator::Run();
+    CheckResults();
+    Simulator::Destroy();
+
+    delete m_nodes, m_nodes = nullptr;
+}
+
+void
+BenignRelayTest::CreateNodes()
+{
+    // S, R, D and the blackhole B
+    m_nodes = new NodeContainer;
+    m_nodes->Create(4);
+    Ptr<ListPositionAllocator> positions = CreateObject<ListPositionAllocator>();
+    positions->Add(Vector(0, 0, 0));
+    positions->Add(Vector(120, 0, 0));
+    positions->Add(Vector(0, 100, 0));
+    positions->Add(Vector(240, 0, 0));
+    MobilityHelper mobility;
+    mobility.SetPositionAllocator(positions);
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(*m_nodes);
+}
+
+void
+BenignRelayTest::CreateDevices()
+{
+    WifiMacHelper wifiMac;
+    wifiMac.SetType("ns3::AdhocWifiMac");
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.DisablePreambleDetectionModel();
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> chan = wifiChannel.Create();
+    wifiPhy.SetChannel(chan);
+    wifiPhy.SetErrorRateModel("ns3::YansErrorRateModel");
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211a);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("OfdmRate6Mbps"),
+                                 "RtsCtsThreshold",
+                                 StringValue("2200"));
+    NetDeviceContainer devices = wifi.Install(wifiPhy, wifiMac, *m_nodes);
+
+    // Only D may answer for D, so that the RREQ of S reaches the blackhole
+    TpaodvHelper tpaodv;
+    tpaodv.Set("DestinationOnly", BooleanValue(true));
+    tpaodv.Set("PassiveSeqnoScoring", BooleanValue(true));
+    InternetStackHelper internetStack;
+    internetStack.SetRoutingHelper(tpaodv);
+    internetStack.Install(*m_nodes);
+    // R relays the forged RREP while it tests the blackhole itself
+    m_nodes->Get(1)->GetObject<tpaodv::RoutingProtocol>()->SetAttribute("OptimisticTrust",
+                                                                         BooleanValue(true));
+    m_nodes->Get(3)->GetObject<tpaodv::RoutingProtocol>()->SetAttribute("IsMalicious",
+                                                                         BooleanValue(true));
+    m_nodes->Get(0)->GetObject<tpaodv::RoutingProtocol>()->TraceConnectWithoutContext(
+        "TrustVerdict",
+        MakeCallback(&BenignRelayTest::TrustVerdict, this));
+    int64_t streamsUsed = WifiHelper::AssignStreams(devices, 0);
+    streamsUsed += wifiChannel.AssignStreams(chan, streamsUsed);
+    streamsUsed += internetStack.AssignStreams(*m_nodes, streamsUsed);
+    tpaodv.AssignStreams(*m_nodes, streamsUsed);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+    m_relay = interfaces.GetAddress(1);
+
+    // Traffic starts once D has moved, S only heard its HELLO messages before
+    UdpEchoServerHelper server(9);
+    ApplicationContainer apps = server.Install(m_nodes->Get(2));
+    UdpEchoClientHelper client(interfaces.GetAddress(2), 9);
+    client.SetAttribute("MaxPackets", UintegerValue(1000));
+    client.SetAttribute("Interval", TimeValue(Seconds(0.5)));
+    client.SetAttribute("PacketSize", UintegerValue(64));
+    ApplicationContainer c = client.Install(m_nodes->Get(0));
+    c.Start(Seconds(12));
+    apps.Add(c);
+    apps.Stop(m_time);
+}
+
+void
+BenignRelayTest::CheckResults()
+{
+    Ptr<tpaodv::RoutingProtocol> source = m_nodes->Get(0)->GetObject<tpaodv::RoutingProtocol>();
+    NS_TEST_EXPECT_MSG_GT(source->GetPassiveRejectedCount(),
+                          0,
+                          "Forged RREP relayed by R must be dropped");
+    NS_TEST_EXPECT_MSG_GT(m_relayVerdicts, 0, "Relay must be tested");
+    NS_TEST_EXPECT_MSG_EQ(m_relayRejected, 0, "Benign relay must not be rejected");
+}
@@ -198,4 +198,144 @@ class ChainRegressionTest : public TestCase
     void SendPing();
 };
 
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief Recovery from a blackhole with optimistic trust
+ *
+ * A blackhole B next to the source S answers every RREQ with a forged, much fresher, RREP.
+ * S installs the forged route while B is tested; once B fails the test the route is revoked and
+ * the genuine route through R must be accepted despite the forged sequence number.
+ *
+ * \verbatim
+   B <-120m-> S <-120m-> R <-120m-> D
+   \endverbatim
+ */
+class BlackholeRevokeTest : public TestCase
+{
+  public:
+    BlackholeRevokeTest();
+    ~BlackholeRevokeTest() override;
+
+  private:
+    /// \internal It is important to have pointers here
+    NodeContainer* m_nodes;
+    /// Total simulation time
+    const Time m_time;
+    /// Echo replies received by the source
+    uint32_t m_replies;
+
+    /// Create test topology
+    void CreateNodes();
+    /// Create devices, install TCP/IP stack and applications
+    void CreateDevices();
+    /// Check that the source got rid of the blackhole
+    void CheckResults();
+    /// Go
+    void DoRun() override;
+    /**
+     * Count one echo reply
+     * \param p the echo reply
+     */
+    void ReceiveReply(Ptr<const Packet> p);
+};
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief RREPs held for a neighbor rejected on trust test timeout are dropped
+ *
+ * The blackhole B answers the RREQs of S for the unreachable D with forged RREPs, then moves out
+ * of range as soon as S tests it. With TrustTestTimeoutFlush on and a rejecting
+ * TrustTestExhaustedLevel, S must blacklist B and drop its held RREPs instead of processing them.
+ *
+ * \verbatim
+   B <-120m-> S                       D
+   \endverbatim
+ */
+class TrustTestTimeoutTest : public TestCase
+{
+  public:
+    TrustTestTimeoutTest();
+    ~TrustTestTimeoutTest() override;
+
+  private:
+    /// \internal It is important to have pointers here
+    NodeContainer* m_nodes;
+    /// Total simulation time
+    const Time m_time;
+    /// Address of the blackhole
+    Ipv4Address m_blackhole;
+    /// Whether the blackhole moved away already
+    bool m_moved;
+
+    /// Create test topology
+    void CreateNodes();
+    /// Create devices, install TCP/IP stack and applications
+    void CreateDevices();
+    /// Check that the held RREPs were dropped
+    void CheckResults();
+    /// Go
+    void DoRun() override;
+    /**
+     * Move the blackhole away once the source sends it a packet, its first trust test
+     * \param p the packet sent, with its IPv4 header
+     * \param ipv4 the IPv4 stack of the source
+     * \param interface the outgoing interface
+     */
+    void SourceTx(Ptr<const Packet> p, Ptr<Ipv4> ipv4, uint32_t interface);
+};
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief A benign relay of a forged sequence number is tested, not blocked
+ *
+ * S learns the sequence number of D from its HELLO messages, then D moves behind R. When S looks
+ * for D again, R optimistically relays the forged RREP of the blackhole B. With passive scoring,
+ * S must drop the anomalous RREP and test R, which passes, instead of rejecting R on its score.
+ *
+ * \verbatim
+   S <-120m-> R <-120m-> B      before 10 s, D stands 100m from S
+              |
+            100m
+              |
+              D                 after 10 s
+   \endverbatim
+ */
+class BenignRelayTest : public TestCase
+{
+  public:
+    BenignRelayTest();
+    ~BenignRelayTest() override;
+
+  private:
+    /// \internal It is important to have pointers here
+    NodeContainer* m_nodes;
+    /// Total simulation time
+    const Time m_time;
+    /// Address of the relay
+    Ipv4Address m_relay;
+    /// Verdicts of the source about the relay
+    uint32_t m_relayVerdicts;
+    /// Rejecting verdicts of the source about the relay
+    uint32_t m_relayRejected;
+
+    /// Create test topology
+    void CreateNodes();
+    /// Create devices, install TCP/IP stack and applications
+    void CreateDevices();
+    /// Check that the relay was tested and not rejected
+    void CheckResults();
+    /// Go
+    void DoRun() override;
+    /**
+     * Count a verdict of the source
+     * \param node the neighbor the verdict is about
+     * \param rejected whether the neighbor was judged malicious
+     * \param testDuration the duration of its trust test
+     */
+    void TrustVerdict(Ipv4Address node, bool rejected, Time testDuration);
+};
+
 #endif /* TPAODV_REGRESSION_H */
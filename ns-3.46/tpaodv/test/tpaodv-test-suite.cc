@@ -9,6 +9,8 @@
 #include "ns3/tpaodv-packet.h"
 #include "ns3/tpaodv-rqueue.h"
 #include "ns3/tpaodv-rtable.h"
+#include "ns3/tpaodv-seqno-monitor.h"
+#include "ns3/tpaodv-trust-table.h"
 #include "ns3/ipv4-route.h"
 #include "ns3/test.h"
 
@@ -205,6 +207,27 @@ struct RreqHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, 23, "RREP is 23 bytes long");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 0, "Nothing saved by the RFC encoding");
+
+        h.SetCompact(true);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RreqHeader h3;
+        h3.SetCompact(true);
+        bytes = p->RemoveHeader(h3);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 12, "Compact RREQ with small fields is 12 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 11, "Compact RREQ saves 11 bytes");
+        NS_TEST_EXPECT_MSG_EQ(h, h3, "Compact round trip serialization works");
+
+        h.SetHopCount(20);
+        h.SetId(0xffffffff);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RreqHeader h4;
+        h4.SetCompact(true);
+        bytes = p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 19, "Long hop count and ID need the extension");
+        NS_TEST_EXPECT_MSG_EQ(h, h4, "Compact round trip serialization works");
     }
 };
 
@@ -262,6 +285,49 @@ struct RrepHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, 19, "RREP is 19 bytes long");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+
+        h.SetCompact(true);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h3;
+        h3.SetCompact(true);
+        bytes = p->RemoveHeader(h3);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 12, "Compact HELLO is 12 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h.GetCompactSavings(), 7, "Compact HELLO saves 7 bytes");
+        NS_TEST_EXPECT_MSG_EQ(h, h3, "Compact round trip serialization works");
+
+        h.SetAckRequired(true);
+        h.SetLifeTime(MilliSeconds(1250));
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h4;
+        h4.SetCompact(true);
+        p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(h4.GetAckRequired(), true, "A flag survives the compact encoding");
+        NS_TEST_EXPECT_MSG_EQ(h4.GetLifeTime(),
+                              MilliSeconds(1300),
+                              "Compact lifetime is rounded up to 100 ms");
+
+        h.SetLifeTime(MilliSeconds(UINT32_MAX - 50));
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h6;
+        h6.SetCompact(true);
+        bytes = p->RemoveHeader(h6);
+        NS_TEST_EXPECT_MSG_EQ(bytes, h.GetSerializedSize(), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h6.GetLifeTime(),
+                              MilliSeconds(UINT32_MAX / 100 * 100),
+                              "Compact lifetime near 2^32 ms is rounded down");
+
+        h.SetPrefixSize(8);
+        h.SetHopCount(100);
+        p = Create<Packet>();
+        p->AddHeader(h);
+        RrepHeader h5;
+        h5.SetCompact(true);
+        p->RemoveHeader(h5);
+        NS_TEST_EXPECT_MSG_EQ(h5.GetPrefixSize(), 8, "Prefix size needs the extension");
+        NS_TEST_EXPECT_MSG_EQ(h5.GetHopCount(), 100, "Long hop count needs the extension");
     }
 };
 
@@ -289,6 +355,38 @@ struct RrepAckHeaderTest : public TestCase
     }
 };
 
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief Unit test for the trust digest carried by HELLO messages
+ */
+struct TrustDigestHeaderTest : public TestCase
+{
+    TrustDigestHeaderTest()
+        : TestCase("TPAODV trust digest")
+    {
+    }
+
+    void DoRun() override
+    {
+        TrustDigestHeader h;
+        NS_TEST_EXPECT_MSG_EQ(h.GetSerializedSize(), 1, "Empty digest is 1 byte long");
+        NS_TEST_EXPECT_MSG_EQ(h.AddVerdict(Ipv4Address("1.2.3.4"), 0, 10), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h.AddVerdict(Ipv4Address("4.3.2.1"), 2, 255), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h.GetSerializedSize(), 13, "6 bytes per verdict");
+
+        Ptr<Packet> p = Create<Packet>();
+        p->AddHeader(h);
+        TrustDigestHeader h2;
+        uint32_t bytes = p->RemoveHeader(h2);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 13, "Digest is 13 bytes long");
+        NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+        NS_TEST_EXPECT_MSG_EQ(h2.GetVerdicts()[0].m_addr, Ipv4Address("1.2.3.4"), "trivial");
+        NS_TEST_EXPECT_MSG_EQ(int(h2.GetVerdicts()[1].m_level), 2, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(int(h2.GetVerdicts()[1].m_age), 255, "trivial");
+    }
+};
+
 /**
  * @ingroup tpaodv-test
  *
@@ -320,6 +418,35 @@ struct RerrHeaderTest : public TestCase
         uint32_t bytes = p->RemoveHeader(h2);
         NS_TEST_EXPECT_MSG_EQ(bytes, h.GetSerializedSize(), "(De)Serialized size match");
         NS_TEST_EXPECT_MSG_EQ(h, h2, "Round trip serialization works");
+
+        std::pair<Ipv4Address, uint32_t> un;
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(un.first, dst2, "Destinations are kept in address order");
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(un.first, dst, "Destinations are kept in address order");
+        NS_TEST_EXPECT_MSG_EQ(un.second, 12, "Duplicate destination keeps first seqno");
+        NS_TEST_EXPECT_MSG_EQ(h2.RemoveUnDestination(un), false, "Header is empty");
+
+        RerrHeader h3;
+        for (uint32_t k = 255; k > 0; --k)
+        {
+            NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address(0x0a000000 + k), k),
+                                  true,
+                                  "trivial");
+        }
+        NS_TEST_EXPECT_MSG_EQ(h3.GetDestCount(), 255, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address("10.0.1.0"), 1),
+                              false,
+                              "No more than 255 destinations");
+        NS_TEST_EXPECT_MSG_EQ(h3.AddUnDestination(Ipv4Address("10.0.0.1"), 1),
+                              true,
+                              "Duplicate of a present destination is accepted");
+        p = Create<Packet>();
+        p->AddHeader(h3);
+        RerrHeader h4;
+        bytes = p->RemoveHeader(h4);
+        NS_TEST_EXPECT_MSG_EQ(bytes, 3 + 8 * 255, "(De)Serialized size match");
+        NS_TEST_EXPECT_MSG_EQ(h3, h4, "Round trip serialization works");
     }
 };
 
@@ -719,6 +846,233 @@ struct AodvRtableTest : public TestCase
     }
 };
 
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief Unit test for the trust table
+ */
+struct TrustTableTest : public TestCase
+{
+    TrustTableTest()
+        : TestCase("Trust table"),
+          table(nullptr)
+    {
+    }
+
+    void DoRun() override;
+    /// Check the levels before the decay time
+    void CheckDecay1();
+    /// Check the levels after the decay time
+    void CheckDecay2();
+    /// The trust table
+    TrustTable* table;
+};
+
+void
+TrustTableTest::CheckDecay1()
+{
+    NS_TEST_EXPECT_MSG_EQ(table->GetTrustLevel(Ipv4Address("1.1.1.1")),
+                          TrustTable::TL_TRUSTED,
+                          "Not decayed yet");
+    NS_TEST_EXPECT_MSG_EQ(table->GetTrustLevel(Ipv4Address("2.2.2.2")),
+                          TrustTable::TL_BLACKLIST,
+                          "Not decayed yet");
+}
+
+void
+TrustTableTest::CheckDecay2()
+{
+    NS_TEST_EXPECT_MSG_EQ(table->GetTrustLevel(Ipv4Address("1.1.1.1")),
+                          TrustTable::TL_INITIAL,
+                          "Trusted node decayed");
+    NS_TEST_EXPECT_MSG_EQ(table->GetTrustLevel(Ipv4Address("2.2.2.2")),
+                          TrustTable::TL_INITIAL,
+                          "Blacklisted node decayed");
+    NS_TEST_EXPECT_MSG_EQ(table->GetTrustLevel(Ipv4Address("3.3.3.3")),
+                          TrustTable::TL_BLOCKED,
+                          "Blocked node never decays");
+    NS_TEST_EXPECT_MSG_EQ(table->GetMaliciousCount(Ipv4Address("2.2.2.2")),
+                          1,
+                          "Failures survive the decay");
+    table->Purge();
+    NS_TEST_EXPECT_MSG_EQ(table->GetSize(), 2, "Decayed entry without failures is removed");
+}
+
+void
+TrustTableTest::DoRun()
+{
+    TrustTable tt(Seconds(10), 3);
+    table = &tt;
+    NS_TEST_EXPECT_MSG_EQ(tt.GetTrustLevel(Ipv4Address("1.1.1.1")),
+                          TrustTable::TL_INITIAL,
+                          "Unknown node");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetSize(), 0, "Lookups do not add entries");
+
+    tt.SetTrustLevel(Ipv4Address("1.1.1.1"), TrustTable::TL_TRUSTED);
+    tt.SetTrustLevel(Ipv4Address("2.2.2.2"), TrustTable::TL_BLACKLIST);
+    NS_TEST_EXPECT_MSG_EQ(tt.IncrementMaliciousCount(Ipv4Address("2.2.2.2")), 1, "trivial");
+    tt.SetTrustLevel(Ipv4Address("3.3.3.3"), TrustTable::TL_BLOCKED);
+    NS_TEST_EXPECT_MSG_EQ(tt.GetSize(), 3, "trivial");
+
+    // 2.2.2.2 failed a test and 3.3.3.3 is blocked, so 1.1.1.1 is the only candidate
+    tt.GetTrustLevel(Ipv4Address("1.1.1.1"));
+    tt.SetTrustLevel(Ipv4Address("4.4.4.4"), TrustTable::TL_TRUSTED);
+    NS_TEST_EXPECT_MSG_EQ(tt.GetSize(), 3, "Table is bounded");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetTrustLevel(Ipv4Address("1.1.1.1")),
+                          TrustTable::TL_INITIAL,
+                          "Unpinned entry evicted");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetMaliciousCount(Ipv4Address("2.2.2.2")),
+                          1,
+                          "Repeat offender pinned");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetTrustLevel(Ipv4Address("3.3.3.3")),
+                          TrustTable::TL_BLOCKED,
+                          "Blocked node pinned");
+
+    // A burst of new nodes only evicts unpinned entries, least recently used first
+    tt.SetMaxEntries(4);
+    tt.SetTrustLevel(Ipv4Address("5.5.5.5"), TrustTable::TL_TRUSTED);
+    tt.GetTrustLevel(Ipv4Address("4.4.4.4"));
+    tt.SetTrustLevel(Ipv4Address("6.6.6.6"), TrustTable::TL_TRUSTED);
+    NS_TEST_EXPECT_MSG_EQ(tt.GetSize(), 4, "Table is bounded");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetTrustLevel(Ipv4Address("5.5.5.5")),
+                          TrustTable::TL_INITIAL,
+                          "LRU entry evicted");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetTrustLevel(Ipv4Address("4.4.4.4")),
+                          TrustTable::TL_TRUSTED,
+                          "Recently used entry kept");
+
+    tt.GetTrustLevel(Ipv4Address("3.3.3.3"));
+    tt.SetMaxEntries(2);
+    NS_TEST_EXPECT_MSG_EQ(tt.GetSize(), 2, "Shrinking the bound evicts unpinned entries");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetTrustLevel(Ipv4Address("3.3.3.3")),
+                          TrustTable::TL_BLOCKED,
+                          "Blocked node pinned");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetMaliciousCount(Ipv4Address("2.2.2.2")),
+                          1,
+                          "Repeat offender pinned");
+    tt.SetMaxEntries(1);
+    NS_TEST_EXPECT_MSG_EQ(tt.GetSize(), 2, "Pinned entries may exceed the bound");
+
+    tt.Clear();
+    tt.SetMaxEntries(0);
+    tt.SetTrustLevel(Ipv4Address("1.1.1.1"), TrustTable::TL_TRUSTED);
+    tt.SetTrustLevel(Ipv4Address("2.2.2.2"), TrustTable::TL_BLACKLIST);
+    tt.IncrementMaliciousCount(Ipv4Address("2.2.2.2"));
+    tt.SetTrustLevel(Ipv4Address("3.3.3.3"), TrustTable::TL_BLOCKED);
+    tt.SetTrustLevel(Ipv4Address("4.4.4.4"), TrustTable::TL_TRUSTED);
+
+    // Recommendations add up per distinct recommender
+    Ipv4Address n5("5.5.5.5");
+    NS_TEST_EXPECT_MSG_EQ(tt.AddRecommendation(n5, Ipv4Address("9.9.9.1"), TrustTable::TL_BLACKLIST, 0.5),
+                          false,
+                          "One recommender is not enough");
+    NS_TEST_EXPECT_MSG_EQ(tt.AddRecommendation(n5, Ipv4Address("9.9.9.1"), TrustTable::TL_BLACKLIST, 0.5),
+                          false,
+                          "The same recommender counts once");
+    NS_TEST_EXPECT_MSG_EQ(tt.AddRecommendation(n5, Ipv4Address("9.9.9.2"), TrustTable::TL_BLACKLIST, 0.5),
+                          true,
+                          "Two recommenders are enough");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetTrustLevel(n5), TrustTable::TL_BLACKLIST, "Second-hand verdict");
+    NS_TEST_EXPECT_MSG_EQ(tt.AddRecommendation(Ipv4Address("1.1.1.1"),
+                                               Ipv4Address("9.9.9.1"),
+                                               TrustTable::TL_BLACKLIST,
+                                               1),
+                          false,
+                          "First-hand verdicts win");
+    uint32_t size = tt.GetSize();
+    NS_TEST_EXPECT_MSG_EQ(tt.AddRecommendation(Ipv4Address("6.6.6.6"),
+                                               Ipv4Address("9.9.9.1"),
+                                               TrustTable::TL_BLACKLIST,
+                                               0),
+                          false,
+                          "Recommenders without weight are ignored");
+    NS_TEST_EXPECT_MSG_EQ(tt.GetSize(), size, "Ignored recommendations create no entry");
+
+    std::vector<TrustTable::Verdict> verdicts;
+    tt.GetFirstHandVerdicts(verdicts, 8);
+    NS_TEST_EXPECT_MSG_EQ(verdicts.size(), 4, "Second-hand verdicts are not reported");
+    NS_TEST_EXPECT_MSG_EQ(verdicts[0].m_addr, Ipv4Address("3.3.3.3"), "Negative verdicts first");
+    NS_TEST_EXPECT_MSG_EQ(verdicts[1].m_addr, Ipv4Address("2.2.2.2"), "Negative verdicts first");
+    tt.GetFirstHandVerdicts(verdicts, 1);
+    NS_TEST_EXPECT_MSG_EQ(verdicts.size(), 1, "Verdicts are bounded");
+
+    Simulator::Schedule(Seconds(5), &TrustTableTest::CheckDecay1, this);
+    Simulator::Schedule(Seconds(15), &TrustTableTest::CheckDecay2, this);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+/**
+ * @ingroup tpaodv-test
+ *
+ * @brief Unit test for the sequence number monitor
+ */
+struct SeqnoMonitorTest : public TestCase
+{
+    SeqnoMonitorTest()
+        : TestCase("Sequence number monitor")
+    {
+    }
+
+    void DoRun() override;
+    /**
+     * Observe a sequence number of the test destination
+     * @param seqno the sequence number
+     */
+    void Observe(uint32_t seqno);
+    /// Check the scores
+    void CheckScores();
+    /// The sequence number monitor
+    SeqnoMonitor monitor;
+};
+
+void
+SeqnoMonitorTest::Observe(uint32_t seqno)
+{
+    monitor.Observe(Ipv4Address("1.1.1.1"), seqno);
+}
+
+void
+SeqnoMonitorTest::CheckScores()
+{
+    Ipv4Address dst("1.1.1.1");
+    NS_TEST_EXPECT_MSG_EQ(monitor.GetSamples(dst), 4, "trivial");
+    NS_TEST_EXPECT_MSG_EQ_TOL(monitor.Score(dst, 5), 0, 1e-9, "Expected growth");
+    NS_TEST_EXPECT_MSG_LT(monitor.Score(dst, 15), 1, "Within the slack");
+    NS_TEST_EXPECT_MSG_LT(monitor.Score(dst, 3), 0, "Stale sequence number is plausible");
+    NS_TEST_EXPECT_MSG_GT(monitor.Score(dst, 104), 1, "Inflated sequence number");
+    NS_TEST_EXPECT_MSG_EQ(monitor.Score(Ipv4Address("2.2.2.2"), 1000), 0, "Unknown destination");
+    NS_TEST_EXPECT_MSG_EQ(monitor.GetSamples(Ipv4Address("2.2.2.2")), 0, "Unknown destination");
+}
+
+void
+SeqnoMonitorTest::DoRun()
+{
+    // One sequence number per second
+    for (uint32_t k = 0; k < 4; ++k)
+    {
+        Simulator::Schedule(Seconds(k), &SeqnoMonitorTest::Observe, this, k + 1);
+    }
+    Simulator::Schedule(Seconds(4), &SeqnoMonitorTest::CheckScores, this);
+    Simulator::Run();
+    Simulator::Destroy();
+
+    // The least recently observed destination is forgotten first
+    monitor.Clear();
+    monitor.SetMaxEntries(2);
+    monitor.Observe(Ipv4Address("1.1.1.1"), 1);
+    monitor.Observe(Ipv4Address("2.2.2.2"), 1);
+    monitor.Observe(Ipv4Address("1.1.1.1"), 2);
+    monitor.Observe(Ipv4Address("3.3.3.3"), 1);
+    NS_TEST_EXPECT_MSG_EQ(monitor.GetSize(), 2, "Models are bounded");
+    NS_TEST_EXPECT_MSG_EQ(monitor.GetSamples(Ipv4Address("2.2.2.2")), 0, "Evicted");
+    NS_TEST_EXPECT_MSG_EQ(monitor.GetSamples(Ipv4Address("1.1.1.1")), 1, "Kept");
+    NS_TEST_EXPECT_MSG_EQ(monitor.GetMemoryUsage().entries, 2, "trivial");
+    monitor.SetMaxEntries(1);
+    NS_TEST_EXPECT_MSG_EQ(monitor.GetSamples(Ipv4Address("1.1.1.1")), 0, "Evicted");
+    NS_TEST_EXPECT_MSG_EQ(monitor.GetSamples(Ipv4Address("3.3.3.3")), 1, "Kept");
+}
+
 /**
  * @ingroup tpaodv-test
  *
@@ -735,11 +1089,14 @@ class AodvTestSuite : public TestSuite
         AddTestCase(new RreqHeaderTest, TestCase::Duration::QUICK);
         AddTestCase(new RrepHeaderTest, TestCase::Duration::QUICK);
         AddTestCase(new RrepAckHeaderTest, TestCase::Duration::QUICK);
+        AddTestCase(new TrustDigestHeaderTest, TestCase::Duration::QUICK);
         AddTestCase(new RerrHeaderTest, TestCase::Duration::QUICK);
         AddTestCase(new QueueEntryTest, TestCase::Duration::QUICK);
         AddTestCase(new AodvRqueueTest, TestCase::Duration::QUICK);
         AddTestCase(new AodvRtableEntryTest, TestCase::Duration::QUICK);
         AddTestCase(new AodvRtableTest, TestCase::Duration::QUICK);
+        AddTestCase(new TrustTableTest, TestCase::Duration::QUICK);
+        AddTestCase(new SeqnoMonitorTest, TestCase::Duration::QUICK);
     }
 } g_tpaodvTestSuite; ///< the test suite
 